@@ -1,8 +1,10 @@
 TEMPLATE = subdirs
 SUBDIRS = decore \
-          tests
+          tests \
+          benchmark
 
 CONFIG -= qt
 CONFIG += ordered
 
 tests.depends = decore
+benchmark.depends = decore
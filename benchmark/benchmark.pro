@@ -0,0 +1,21 @@
+CONFIG -= qt
+CONFIG += release
+
+TARGET = benchmark
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -Wall -Wextra
+
+TEMPLATE = app
+
+LIBS += -lpthread
+
+SOURCES += \
+    tableHostBenchmark.cpp
+
+INCLUDEPATH += $$PWD/../decore/include
+DEPENDPATH += $$PWD/../decore/include
+
+LIBS += -L$$PWD/../decore -ldecore
+PRE_TARGETDEPS += $$PWD/../decore/libdecore.a
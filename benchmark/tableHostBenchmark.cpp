@@ -0,0 +1,273 @@
+/**
+ * TableHost load benchmark
+ *
+ * Hosts many tables of bots with one external seat each. A simulated client answers the external decisions
+ * as soon as they are reported and the benchmark measures the latency from TableHost::submit()
+ * to the next decision of the external player (or the end of the game) of the same table.
+ *
+ * Usage: benchmark [tables] [threads] [quantum]
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "tableHost.h"
+#include "player.h"
+#include "deck.h"
+#include "random.h"
+
+using namespace decore;
+
+namespace
+{
+
+uint64_t now()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ull + time.tv_nsec;
+}
+
+/**
+ * Player which makes random moves, skips sometimes so the games end
+ */
+class RandomBot : public Player
+{
+    Random mRandom;
+public:
+    explicit RandomBot(uint64_t seed)
+        : mRandom(seed)
+    {}
+    void idCreated(const PlayerId*)
+    {}
+    const Card& attack(const PlayerId*, const CardSet& cardSet)
+    {
+        return *pick(cardSet, false);
+    }
+    const Card* pitch(const PlayerId*, const CardSet& cardSet)
+    {
+        return pick(cardSet, true);
+    }
+    const Card* defend(const PlayerId*, const Card&, const CardSet& cardSet)
+    {
+        return pick(cardSet, true);
+    }
+    void cardsUpdated(const CardSet&)
+    {}
+    void cardsRestored(const CardSet&)
+    {}
+    void gameStarted(const Suit&, const CardSet&, const std::vector<const PlayerId*>&)
+    {}
+    void gameRestored(const std::vector<const PlayerId*>&, const std::map<const PlayerId*, unsigned int>&,
+        unsigned int, const Suit&, const std::vector<Card>&, const std::vector<Card>&)
+    {}
+    void roundStarted(unsigned int, const std::vector<const PlayerId*>&, const PlayerId*)
+    {}
+    void roundEnded(unsigned int)
+    {}
+    void cardsPickedUp(const PlayerId*, const CardSet&)
+    {}
+    void cardsDealed(const PlayerId*, unsigned int)
+    {}
+    void cardsGone(const CardSet&)
+    {}
+    void cardsDropped(const PlayerId*, const CardSet&)
+    {}
+    void save(DataWriter&)
+    {}
+    void init(DataReader&)
+    {}
+    void quit()
+    {}
+
+private:
+    const Card* pick(const CardSet& cardSet, bool canSkip)
+    {
+        if (cardSet.empty()) {
+            return NULL;
+        }
+        unsigned int index = mRandom(cardSet.size() + (canSkip ? 1 : 0));
+        if (index == cardSet.size()) {
+            return NULL;
+        }
+        CardSet::const_iterator it = cardSet.begin();
+        std::advance(it, index);
+        return &*it;
+    }
+};
+
+/**
+ * The client: queues the external decisions, measures the latencies
+ */
+class Client : public TableListener
+{
+    pthread_mutex_t mLock;
+    pthread_cond_t mSignal;
+    /**
+     * Tables waiting for the answer
+     */
+    std::deque<unsigned int> mPending;
+    /**
+     * Submit time by table, 0 if not submitted
+     */
+    std::vector<uint64_t> mSubmitted;
+    unsigned int mActiveTables;
+
+public:
+    std::vector<uint64_t> mLatencies;
+
+    explicit Client(unsigned int tables)
+        : mSubmitted(tables)
+        , mActiveTables(tables)
+    {
+        pthread_mutex_init(&mLock, NULL);
+        pthread_cond_init(&mSignal, NULL);
+    }
+    ~Client()
+    {
+        pthread_cond_destroy(&mSignal);
+        pthread_mutex_destroy(&mLock);
+    }
+    void decisionPending(unsigned int table, const Decision&)
+    {
+        uint64_t time = now();
+        pthread_mutex_lock(&mLock);
+        measure(table, time);
+        mPending.push_back(table);
+        pthread_cond_signal(&mSignal);
+        pthread_mutex_unlock(&mLock);
+    }
+    void tableEnded(unsigned int table, const PlayerId*)
+    {
+        uint64_t time = now();
+        pthread_mutex_lock(&mLock);
+        measure(table, time);
+        if (!--mActiveTables) {
+            pthread_cond_signal(&mSignal);
+        }
+        pthread_mutex_unlock(&mLock);
+    }
+    /**
+     * Answers the decisions till all the games end
+     */
+    void run(TableHost& host, std::vector<Player*>& externalPlayers)
+    {
+        pthread_mutex_lock(&mLock);
+        for (;;) {
+            while (mPending.empty() && mActiveTables) {
+                pthread_cond_wait(&mSignal, &mLock);
+            }
+            if (mPending.empty()) {
+                break;
+            }
+            unsigned int table = mPending.front();
+            mPending.pop_front();
+            pthread_mutex_unlock(&mLock);
+
+            Decision decision;
+            host.pending(table, decision);
+            const Card* card = decision.ask(*externalPlayers[table]);
+
+            pthread_mutex_lock(&mLock);
+            mSubmitted[table] = now();
+            pthread_mutex_unlock(&mLock);
+            host.submit(table, card);
+            pthread_mutex_lock(&mLock);
+        }
+        pthread_mutex_unlock(&mLock);
+    }
+
+private:
+    void measure(unsigned int table, uint64_t time)
+    {
+        if (mSubmitted[table]) {
+            mLatencies.push_back(time - mSubmitted[table]);
+            mSubmitted[table] = 0;
+        }
+    }
+};
+
+double percentile(const std::vector<uint64_t>& sorted, double percent)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(percent / 100 * (sorted.size() - 1));
+    return sorted[index] / 1000.0;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int tables = argc > 1 ? atoi(argv[1]) : 10000;
+    unsigned int threads = argc > 2 ? atoi(argv[2]) : 4;
+    unsigned int quantum = argc > 3 ? atoi(argv[3]) : 1;
+    const unsigned int PLAYERS = 3;
+
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    std::vector<RandomBot*> bots;
+    std::vector<Player*> externalPlayers;
+    Client client(tables);
+    TableHost host(client, threads);
+    host.setQuantum(quantum);
+
+    uint64_t start = now();
+    for (unsigned int table = 0; table < tables; ++table) {
+        std::vector<Player*> players;
+        for (unsigned int i = 0; i < PLAYERS; ++i) {
+            bots.push_back(new RandomBot(table * PLAYERS + i));
+            players.push_back(bots.back());
+        }
+        externalPlayers.push_back(players[0]);
+
+        Deck deck;
+        deck.generate(ranks, sizeof(ranks) / sizeof(ranks[0]), suits, sizeof(suits) / sizeof(suits[0]), 1, table);
+
+        host.addTable(players, 1, deck);
+    }
+    size_t memory = host.memory();
+
+    client.run(host, externalPlayers);
+    host.wait();
+    double seconds = (now() - start) / 1e9;
+
+    std::vector<uint64_t>& latencies = client.mLatencies;
+    std::sort(latencies.begin(), latencies.end());
+    printf("tables: %u, threads: %u, quantum: %u\n", tables, threads, quantum);
+    printf("external decisions: %lu in %.2f s, %.0f per second\n",
+        static_cast<unsigned long>(latencies.size()), seconds, latencies.size() / seconds);
+    printf("submit to next prompt latency: p50 %.1f us, p99 %.1f us\n",
+        percentile(latencies, 50), percentile(latencies, 99));
+    printf("memory: %lu bytes per table at start, %lu bytes per table at end\n",
+        static_cast<unsigned long>(memory / tables), static_cast<unsigned long>(host.memory() / tables));
+
+    for (std::vector<RandomBot*>::iterator it = bots.begin(); it != bots.end(); ++it) {
+        delete *it;
+    }
+    return 0;
+}
@@ -0,0 +1,512 @@
+#include <cassert>
+#include <sched.h>
+
+#include "asyncObserver.h"
+#include "rules.h"
+
+namespace decore {
+
+/**
+ * @brief Returns minimal ring size: the largest notification group should fit
+ *
+ * The largest groups are gameStarted()/gameRestored() and the coalesced state: an event for the game,
+ * an event per player and an event per table card.
+ */
+static unsigned int minCapacity()
+{
+    const unsigned int largestGroup = 1 + Rules::MAX_SEATS + 2 * Rules::MAX_PLAYER_CARDS;
+    unsigned int size = 1;
+    while (size < largestGroup) {
+        size <<= 1;
+    }
+    return size;
+}
+
+const uint64_t AsyncObserver::NOT_READING;
+
+AsyncObserver::State::State()
+    : mDeckCards(0)
+    , mTrumpSuit(SUIT_LAST)
+    , mDefender(NULL)
+{
+}
+
+void AsyncObserver::State::update(const GameEvent* events, unsigned int amount)
+{
+    const GameEvent& event = events[0];
+    switch (event.type) {
+    case EVENT_GAME_STARTED:
+    case EVENT_GAME_RESTORED:
+        mPlayers.clear();
+        mPlayersCards.clear();
+        mAttackCards.clear();
+        mDefendCards.clear();
+        mDefender = NULL;
+        mTrumpSuit = static_cast<Suit>(event.suit);
+        mDeckCards = EVENT_GAME_STARTED == event.type ? CardSet(event.cards).size() : event.value;
+        for (unsigned int i = 1; i < amount; ++i) {
+            if (EVENT_PLAYER == events[i].type) {
+                mPlayers.push_back(events[i].player);
+                mPlayersCards[events[i].player] = events[i].value;
+            } else {
+                (EVENT_TABLE_ATTACK_CARD == events[i].type ? mAttackCards : mDefendCards).push_back(*CardSet(events[i].cards).begin());
+            }
+        }
+        break;
+    case EVENT_ROUND_STARTED:
+        mDefender = event.player;
+        break;
+    case EVENT_CARDS_DEALT:
+        mPlayersCards[event.player] += event.value;
+        mDeckCards -= event.value;
+        break;
+    case EVENT_CARDS_DROPPED: {
+        CardSet cards(event.cards);
+        mPlayersCards[event.player] -= cards.size();
+        // the defender is not known in restored game: not beaten card is beaten next
+        bool defend = mDefender ? event.player == mDefender : mAttackCards.size() > mDefendCards.size();
+        (defend ? mDefendCards : mAttackCards).insert(defend ? mDefendCards.end() : mAttackCards.end(), cards.begin(), cards.end());
+        break;
+    }
+    case EVENT_CARDS_PICKED_UP:
+        mPlayersCards[event.player] += CardSet(event.cards).size();
+        mAttackCards.clear();
+        mDefendCards.clear();
+        break;
+    case EVENT_CARDS_GONE:
+    case EVENT_ROUND_ENDED:
+        mAttackCards.clear();
+        mDefendCards.clear();
+        break;
+    default:
+        break;
+    }
+}
+
+AsyncObserver::AsyncObserver(GameObserver& observer, unsigned int capacity, Backpressure backpressure)
+    : mObserver(observer)
+    , mBackpressure(backpressure)
+    , mHead(0)
+    , mTail(0)
+    , mReading(NOT_READING)
+    , mDropped(0)
+    , mWaiters(0)
+    , mPause(false)
+    , mPauseTarget(0)
+    , mPaused(false)
+    , mStop(false)
+    , mSnapshotTail(0)
+    , mSnapshotTaken(false)
+{
+    unsigned int size = minCapacity();
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mRing.resize(size);
+
+    pthread_mutex_init(&mLock, NULL);
+    pthread_cond_init(&mSignal, NULL);
+    mThreadStarted = !pthread_create(&mThread, NULL, thread, this);
+}
+
+AsyncObserver::~AsyncObserver()
+{
+    pthread_mutex_lock(&mLock);
+    mStop = true;
+    pthread_cond_broadcast(&mSignal);
+    pthread_mutex_unlock(&mLock);
+
+    if (mThreadStarted) {
+        pthread_join(mThread, NULL);
+    }
+
+    pthread_cond_destroy(&mSignal);
+    pthread_mutex_destroy(&mLock);
+}
+
+void AsyncObserver::flush()
+{
+    pause(mTail.get());
+    resume();
+}
+
+uint64_t AsyncObserver::dropped() const
+{
+    return mDropped.get();
+}
+
+void AsyncObserver::gameStarted(const Suit& trumpSuit, const CardSet& cardSet, const std::vector<const PlayerId*>& players)
+{
+    add(EVENT_GAME_STARTED, NULL, 0, cardSet.mask());
+    mGroup.back().suit = trumpSuit;
+    for (std::vector<const PlayerId*>::const_iterator it = players.begin(); it != players.end(); ++it) {
+        add(EVENT_PLAYER, *it, 0, 0);
+    }
+    push();
+}
+
+void AsyncObserver::gameRestored(const std::vector<const PlayerId*>& playerIds,
+    const std::map<const PlayerId*, unsigned int>& playersCards,
+    unsigned int deckCards,
+    const Suit& trumpSuit,
+    const std::vector<Card>& attackCards,
+    const std::vector<Card>& defendCards)
+{
+    add(EVENT_GAME_RESTORED, NULL, deckCards, 0);
+    mGroup.back().suit = trumpSuit;
+    for (std::vector<const PlayerId*>::const_iterator it = playerIds.begin(); it != playerIds.end(); ++it) {
+        add(EVENT_PLAYER, *it, playersCards.at(*it), 0);
+    }
+    for (std::vector<Card>::const_iterator it = attackCards.begin(); it != attackCards.end(); ++it) {
+        add(EVENT_TABLE_ATTACK_CARD, NULL, 0, CardSet::cardMask(*it));
+    }
+    for (std::vector<Card>::const_iterator it = defendCards.begin(); it != defendCards.end(); ++it) {
+        add(EVENT_TABLE_DEFEND_CARD, NULL, 0, CardSet::cardMask(*it));
+    }
+    push();
+}
+
+void AsyncObserver::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender)
+{
+    add(EVENT_ROUND_STARTED, defender, roundIndex, 0);
+    for (std::vector<const PlayerId*>::const_iterator it = attackers.begin(); it != attackers.end(); ++it) {
+        add(EVENT_ATTACKER, *it, 0, 0);
+    }
+    push();
+}
+
+void AsyncObserver::roundEnded(unsigned int roundIndex)
+{
+    add(EVENT_ROUND_ENDED, NULL, roundIndex, 0);
+    push();
+}
+
+void AsyncObserver::cardsPickedUp(const PlayerId* playerId, const CardSet& cardSet)
+{
+    add(EVENT_CARDS_PICKED_UP, playerId, 0, cardSet.mask());
+    push();
+}
+
+void AsyncObserver::cardsDealed(const PlayerId* playerId, unsigned int cardsAmount)
+{
+    add(EVENT_CARDS_DEALT, playerId, cardsAmount, 0);
+    push();
+}
+
+void AsyncObserver::cardsGone(const CardSet& cardSet)
+{
+    add(EVENT_CARDS_GONE, NULL, 0, cardSet.mask());
+    push();
+}
+
+void AsyncObserver::cardsDropped(const PlayerId* playerId, const CardSet& cardSet)
+{
+    add(EVENT_CARDS_DROPPED, playerId, 0, cardSet.mask());
+    push();
+}
+
+bool AsyncObserver::snapshot()
+{
+    // the events queued so far match the engine's snapshot
+    mSnapshotTail = mTail.get();
+    mSnapshotTaken = true;
+    return true;
+}
+
+void AsyncObserver::save(DataWriter& writer)
+{
+    pause(mSnapshotTaken ? mSnapshotTail : mTail.get());
+    mSnapshotTaken = false;
+    // the observer does not change while paused
+    mObserver.snapshot();
+    mObserver.save(writer);
+    resume();
+}
+
+void AsyncObserver::init(DataReader& reader)
+{
+    // gameRestored() is queued before
+    pause(mTail.get());
+    mObserver.init(reader);
+    resume();
+}
+
+void AsyncObserver::quit()
+{
+    mObserver.quit();
+}
+
+void AsyncObserver::add(GameEventType type, const PlayerId* player, unsigned int value, CardSet::Mask cards)
+{
+    GameEvent event;
+    event.cards = cards;
+    event.player = player;
+    event.value = value;
+    event.type = type;
+    event.suit = 0;
+    mGroup.push_back(event);
+}
+
+void AsyncObserver::push()
+{
+    if (!mThreadStarted) {
+        dispatch(&mGroup[0], mGroup.size());
+        mGroup.clear();
+        return;
+    }
+    if (BACKPRESSURE_COALESCE == mBackpressure) {
+        mState.update(&mGroup[0], mGroup.size());
+    }
+
+    const uint64_t size = mRing.size();
+    const uint64_t tail = mTail.get();
+    for (;;) {
+        uint64_t head = mHead.get();
+        if (tail - head + mGroup.size() <= size) {
+            break;
+        }
+        switch (mBackpressure) {
+        case BACKPRESSURE_BLOCK:
+            pthread_mutex_lock(&mLock);
+            mWaiters.getAndAdd(1);
+            while (tail - mHead.get() + mGroup.size() > size) {
+                pthread_cond_wait(&mSignal, &mLock);
+            }
+            mWaiters.getAndAdd(-1);
+            pthread_mutex_unlock(&mLock);
+            break;
+        case BACKPRESSURE_DROP_OLDEST: {
+            // the adapter's thread could take the group at the same time - one of us moves the head
+            unsigned int dropped = groupSize(head, tail);
+            if (mHead.compareAndSet(head, head + dropped)) {
+                mDropped.getAndAdd(dropped);
+            }
+            break;
+        }
+        case BACKPRESSURE_COALESCE:
+            if (mHead.compareAndSet(head, tail)) {
+                mDropped.getAndAdd(tail - head);
+                // the state already includes the notification
+                mGroup.clear();
+                add(EVENT_GAME_RESTORED, NULL, mState.mDeckCards, 0);
+                mGroup.back().suit = mState.mTrumpSuit;
+                for (PlayerIds::const_iterator it = mState.mPlayers.begin(); it != mState.mPlayers.end(); ++it) {
+                    add(EVENT_PLAYER, *it, mState.mPlayersCards[*it], 0);
+                }
+                for (std::vector<Card>::const_iterator it = mState.mAttackCards.begin(); it != mState.mAttackCards.end(); ++it) {
+                    add(EVENT_TABLE_ATTACK_CARD, NULL, 0, CardSet::cardMask(*it));
+                }
+                for (std::vector<Card>::const_iterator it = mState.mDefendCards.begin(); it != mState.mDefendCards.end(); ++it) {
+                    add(EVENT_TABLE_DEFEND_CARD, NULL, 0, CardSet::cardMask(*it));
+                }
+            }
+            break;
+        }
+    }
+    assert(mGroup.size() <= size);
+
+    // the slots of the dropped events could be still copied by the adapter's thread
+    if (tail + mGroup.size() > size) {
+        const uint64_t firstKept = tail + mGroup.size() - size;
+        while (mReading.get() < firstKept) {
+            sched_yield();
+        }
+    }
+    for (unsigned int i = 0; i < mGroup.size(); ++i) {
+        mRing[(tail + i) & (size - 1)] = mGroup[i];
+    }
+    mTail.setAndGet(tail + mGroup.size());
+    mGroup.clear();
+    wake();
+}
+
+unsigned int AsyncObserver::groupSize(uint64_t position, uint64_t tail) const
+{
+    const uint64_t mask = mRing.size() - 1;
+    unsigned int res = 1;
+    while (position + res < tail && continuation(mRing[(position + res) & mask])) {
+        res++;
+    }
+    return res;
+}
+
+bool AsyncObserver::continuation(const GameEvent& event)
+{
+    switch (event.type) {
+    case EVENT_PLAYER:
+    case EVENT_ATTACKER:
+    case EVENT_TABLE_ATTACK_CARD:
+    case EVENT_TABLE_DEFEND_CARD:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void AsyncObserver::wake()
+{
+    // waiters increment the counter before they check their condition, so the wake up is not lost
+    if (mWaiters.get()) {
+        pthread_mutex_lock(&mLock);
+        pthread_cond_broadcast(&mSignal);
+        pthread_mutex_unlock(&mLock);
+    }
+}
+
+void AsyncObserver::pause(uint64_t target)
+{
+    if (!mThreadStarted) {
+        // the observer is notified from the game thread
+        return;
+    }
+    pthread_mutex_lock(&mLock);
+    // one barrier at a time
+    while (mPause.get()) {
+        pthread_cond_wait(&mSignal, &mLock);
+    }
+    mPauseTarget = target;
+    mPause.setAndGet(true);
+    pthread_cond_broadcast(&mSignal);
+    while (!mPaused) {
+        pthread_cond_wait(&mSignal, &mLock);
+    }
+    pthread_mutex_unlock(&mLock);
+}
+
+void AsyncObserver::resume()
+{
+    if (!mThreadStarted) {
+        return;
+    }
+    pthread_mutex_lock(&mLock);
+    mPause.setAndGet(false);
+    pthread_cond_broadcast(&mSignal);
+    // next pause() should not see this pause
+    while (mPaused) {
+        pthread_cond_wait(&mSignal, &mLock);
+    }
+    pthread_mutex_unlock(&mLock);
+}
+
+void* AsyncObserver::thread(void* data)
+{
+    static_cast<AsyncObserver*>(data)->run();
+    return NULL;
+}
+
+void AsyncObserver::run()
+{
+    const uint64_t mask = mRing.size() - 1;
+    for (;;) {
+        if (mPause.get()) {
+            pthread_mutex_lock(&mLock);
+            if (mPause.get() && mHead.get() >= mPauseTarget) {
+                mPaused = true;
+                pthread_cond_broadcast(&mSignal);
+                while (mPause.get()) {
+                    pthread_cond_wait(&mSignal, &mLock);
+                }
+                mPaused = false;
+                pthread_cond_broadcast(&mSignal);
+            }
+            pthread_mutex_unlock(&mLock);
+        }
+
+        uint64_t head = mHead.get();
+        uint64_t tail = mTail.get();
+        if (head == tail) {
+            pthread_mutex_lock(&mLock);
+            mWaiters.getAndAdd(1);
+            while (!mStop && !mPause.get() && mHead.get() == mTail.get()) {
+                pthread_cond_wait(&mSignal, &mLock);
+            }
+            mWaiters.getAndAdd(-1);
+            bool stop = mStop && mHead.get() == mTail.get();
+            pthread_mutex_unlock(&mLock);
+            if (stop) {
+                break;
+            }
+            continue;
+        }
+
+        // the game thread does not overwrite the slots from the position till the copy is done,
+        // it could drop the events before it saw the position
+        mReading.setAndGet(head);
+        if (mHead.get() != head) {
+            mReading.setAndGet(NOT_READING);
+            continue;
+        }
+        unsigned int amount = groupSize(head, tail);
+        mDispatchGroup.clear();
+        for (unsigned int i = 0; i < amount; ++i) {
+            mDispatchGroup.push_back(mRing[(head + i) & mask]);
+        }
+        mReading.setAndGet(NOT_READING);
+        // the game thread dropped the events while they were copied
+        if (!mHead.compareAndSet(head, head + amount)) {
+            continue;
+        }
+        // the game thread could wait for the space
+        wake();
+        dispatch(&mDispatchGroup[0], amount);
+    }
+}
+
+void AsyncObserver::dispatch(const GameEvent* events, unsigned int amount)
+{
+    const GameEvent& event = events[0];
+    switch (event.type) {
+    case EVENT_GAME_STARTED: {
+        std::vector<const PlayerId*> players;
+        for (unsigned int i = 1; i < amount; ++i) {
+            players.push_back(events[i].player);
+        }
+        mObserver.gameStarted(static_cast<Suit>(event.suit), CardSet(event.cards), players);
+        break;
+    }
+    case EVENT_GAME_RESTORED: {
+        std::vector<const PlayerId*> players;
+        std::map<const PlayerId*, unsigned int> playersCards;
+        std::vector<Card> attackCards;
+        std::vector<Card> defendCards;
+        for (unsigned int i = 1; i < amount; ++i) {
+            if (EVENT_PLAYER == events[i].type) {
+                players.push_back(events[i].player);
+                playersCards[events[i].player] = events[i].value;
+            } else {
+                (EVENT_TABLE_ATTACK_CARD == events[i].type ? attackCards : defendCards).push_back(*CardSet(events[i].cards).begin());
+            }
+        }
+        mObserver.gameRestored(players, playersCards, event.value, static_cast<Suit>(event.suit), attackCards, defendCards);
+        break;
+    }
+    case EVENT_ROUND_STARTED: {
+        std::vector<const PlayerId*> attackers;
+        for (unsigned int i = 1; i < amount; ++i) {
+            attackers.push_back(events[i].player);
+        }
+        mObserver.roundStarted(event.value, attackers, event.player);
+        break;
+    }
+    case EVENT_ROUND_ENDED:
+        mObserver.roundEnded(event.value);
+        break;
+    case EVENT_CARDS_PICKED_UP:
+        mObserver.cardsPickedUp(event.player, CardSet(event.cards));
+        break;
+    case EVENT_CARDS_DEALT:
+        mObserver.cardsDealed(event.player, event.value);
+        break;
+    case EVENT_CARDS_GONE:
+        mObserver.cardsGone(CardSet(event.cards));
+        break;
+    case EVENT_CARDS_DROPPED:
+        mObserver.cardsDropped(event.player, CardSet(event.cards));
+        break;
+    default:
+        // continuation of dropped group
+        break;
+    }
+}
+
+}
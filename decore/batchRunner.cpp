@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <cassert>
+#include <unistd.h>
+
+#include "batchRunner.h"
+#include "engine.h"
+#include "player.h"
+#include "deck.h"
+
+namespace decore {
+
+void PlayerFactory::destroy(Player* player)
+{
+    delete player;
+}
+
+BatchResult::BatchResult()
+    : games(0)
+    , draws(0)
+    , unfinished(0)
+    , rounds(0)
+    , minRounds(0)
+    , maxRounds(0)
+{
+}
+
+void BatchResult::add(const BatchResult& other)
+{
+    if (!other.games) {
+        return;
+    }
+    minRounds = games ? std::min(minRounds, other.minRounds) : other.minRounds;
+    maxRounds = std::max(maxRounds, other.maxRounds);
+    games += other.games;
+    draws += other.draws;
+    unfinished += other.unfinished;
+    rounds += other.rounds;
+    if (losses.size() < other.losses.size()) {
+        losses.resize(other.losses.size());
+    }
+    for (unsigned int i = 0; i < other.losses.size(); ++i) {
+        losses[i] += other.losses[i];
+    }
+}
+
+bool BatchResult::operator==(const BatchResult& other) const
+{
+    return games == other.games
+        && draws == other.draws
+        && unfinished == other.unfinished
+        && losses == other.losses
+        && rounds == other.rounds
+        && minRounds == other.minRounds
+        && maxRounds == other.maxRounds;
+}
+
+bool BatchResult::operator!=(const BatchResult& other) const
+{
+    return !(*this == other);
+}
+
+BatchRunner::Worker::Worker()
+    : mNext(0)
+    , mEnd(0)
+    , mStarted(false)
+    , mRunner(NULL)
+    , mIndex(0)
+{
+    pthread_mutex_init(&mLock, NULL);
+}
+
+BatchRunner::Worker::~Worker()
+{
+    pthread_mutex_destroy(&mLock);
+}
+
+void BatchRunner::Worker::assign(uint64_t begin, uint64_t end)
+{
+    pthread_mutex_lock(&mLock);
+    mNext = begin;
+    mEnd = end;
+    pthread_mutex_unlock(&mLock);
+}
+
+bool BatchRunner::Worker::pop(uint64_t& game)
+{
+    pthread_mutex_lock(&mLock);
+    bool res = mNext < mEnd;
+    if (res) {
+        game = mNext++;
+    }
+    pthread_mutex_unlock(&mLock);
+    return res;
+}
+
+bool BatchRunner::Worker::steal(uint64_t& begin, uint64_t& end)
+{
+    pthread_mutex_lock(&mLock);
+    bool res = mNext < mEnd;
+    if (res) {
+        // the owner keeps the lower half, one game is stolen whole
+        end = mEnd;
+        mEnd -= (mEnd - mNext + 1) / 2;
+        begin = mEnd;
+    }
+    pthread_mutex_unlock(&mLock);
+    return res;
+}
+
+BatchRunner::BatchRunner(PlayerFactory& factory, unsigned int players)
+    : mFactory(factory)
+    , mPlayers(players)
+    , mPinThreads(false)
+    , mMaxRounds(1000)
+    , mSeed(0)
+{
+    assert(mPlayers >= 2);
+    for (int rank = RANK_6; rank < RANK_LAST; ++rank) {
+        mRanks.push_back(static_cast<Rank>(rank));
+    }
+    for (int suit = SUIT_SPADES; suit < SUIT_LAST; ++suit) {
+        mSuits.push_back(static_cast<Suit>(suit));
+    }
+}
+
+void BatchRunner::setCards(const Rank* ranks, unsigned int ranksSize, const Suit* suits, unsigned int suitsSize)
+{
+    mRanks.assign(ranks, ranks + ranksSize);
+    mSuits.assign(suits, suits + suitsSize);
+}
+
+void BatchRunner::setPinThreads(bool pin)
+{
+    mPinThreads = pin;
+}
+
+void BatchRunner::setMaxRounds(unsigned int maxRounds)
+{
+    mMaxRounds = maxRounds;
+}
+
+BatchResult BatchRunner::run(uint64_t seed, uint64_t firstGame, uint64_t games, unsigned int threads)
+{
+    assert(mWorkers.empty());
+    if (!threads) {
+        threads = 1;
+    }
+    mSeed = seed;
+
+    // contiguous equal parts of the range
+    for (unsigned int i = 0; i < threads; ++i) {
+        Worker* worker = new Worker();
+        worker->mRunner = this;
+        worker->mIndex = i;
+        worker->assign(firstGame + games * i / threads, firstGame + games * (i + 1) / threads);
+        mWorkers.push_back(worker);
+    }
+
+    // the calling thread is the worker 0
+    // the range of a worker not started is stolen by the others, so the games are played anyway
+    for (unsigned int i = 1; i < threads; ++i) {
+        mWorkers[i]->mStarted = !pthread_create(&mWorkers[i]->mThread, NULL, workerThread, mWorkers[i]);
+    }
+    work(*mWorkers[0]);
+
+    // workers could steal from each other till the last one finished
+    for (unsigned int i = 1; i < threads; ++i) {
+        if (mWorkers[i]->mStarted) {
+            pthread_join(mWorkers[i]->mThread, NULL);
+        }
+    }
+
+    BatchResult res;
+    res.losses.resize(mPlayers);
+    for (unsigned int i = 0; i < threads; ++i) {
+        res.add(mWorkers[i]->mResult);
+        delete mWorkers[i];
+    }
+    mWorkers.clear();
+
+    return res;
+}
+
+void* BatchRunner::workerThread(void* data)
+{
+    Worker& worker = *static_cast<Worker*>(data);
+    worker.mRunner->work(worker);
+    return NULL;
+}
+
+void BatchRunner::work(Worker& worker)
+{
+    if (mPinThreads) {
+        pin(worker.mIndex);
+    }
+    worker.mResult.losses.resize(mPlayers);
+
+    for (;;) {
+        uint64_t game;
+        while (worker.pop(game)) {
+            play(game, worker.mResult);
+        }
+
+        // own range is empty - steal from the others starting from the next one
+        // no games are added, so a round without a steal means all the games are taken
+        bool stolen = false;
+        for (unsigned int i = 1; i < mWorkers.size() && !stolen; ++i) {
+            uint64_t begin;
+            uint64_t end;
+            if (mWorkers[(worker.mIndex + i) % mWorkers.size()]->steal(begin, end)) {
+                worker.assign(begin, end);
+                stolen = true;
+            }
+        }
+        if (!stolen) {
+            break;
+        }
+    }
+}
+
+void BatchRunner::play(uint64_t game, BatchResult& result)
+{
+    Deck deck;
+    deck.generate(&mRanks[0], mRanks.size(), &mSuits[0], mSuits.size(), mSeed, game);
+
+    // the games are not saved or quit from other threads
+    Engine engine(false);
+    std::vector<Player*> players;
+    for (unsigned int seat = 0; seat < mPlayers; ++seat) {
+        players.push_back(mFactory.create(seat, game));
+        engine.add(*players.back());
+    }
+    engine.setDeck(deck);
+
+    unsigned int rounds = 0;
+    bool next;
+    do {
+        next = engine.playRound();
+        rounds++;
+    } while (next && rounds < mMaxRounds);
+
+    const PlayerId* loser = engine.getLoser();
+    if (next) {
+        result.unfinished++;
+    } else if (loser) {
+        result.losses[loser->seat()]++;
+    } else {
+        result.draws++;
+    }
+    result.minRounds = result.games ? std::min(result.minRounds, rounds) : rounds;
+    result.maxRounds = std::max(result.maxRounds, rounds);
+    result.rounds += rounds;
+    result.games++;
+
+    for (std::vector<Player*>::iterator it = players.begin(); it != players.end(); ++it) {
+        mFactory.destroy(*it);
+    }
+}
+
+void BatchRunner::pin(unsigned int index)
+{
+#if defined(__linux__) && defined(_GNU_SOURCE)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(index % cpus, &cpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    }
+#else
+    (void) index;
+#endif
+}
+
+}
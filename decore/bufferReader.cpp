@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <string.h>
+
+#include "bufferReader.h"
+
+namespace decore {
+
+BufferReader::BufferReader()
+    : mData(NULL)
+    , mSize(0)
+    , mPosition(0)
+    , mFailed(false)
+{
+}
+
+BufferReader::BufferReader(const void* data, unsigned int dataSizeBytes)
+    : mData(NULL)
+    , mSize(0)
+    , mPosition(0)
+    , mFailed(false)
+{
+    reset(data, dataSizeBytes);
+}
+
+void BufferReader::reset(const void* data, unsigned int dataSizeBytes)
+{
+    mData = static_cast<const unsigned char*>(data);
+    mSize = mData ? dataSizeBytes : 0;
+    mPosition = 0;
+    mFailed = false;
+}
+
+unsigned int BufferReader::size() const
+{
+    return mSize;
+}
+
+bool BufferReader::failed() const
+{
+    return mFailed;
+}
+
+const void* BufferReader::view(unsigned int dataSizeBytes)
+{
+    if (mSize - mPosition < dataSizeBytes) {
+        mFailed = true;
+        return NULL;
+    }
+    const unsigned char* data = mData + mPosition;
+    mPosition += dataSizeBytes;
+    return data;
+}
+
+unsigned int BufferReader::position() const
+{
+    return mPosition;
+}
+
+void BufferReader::read(void* data, unsigned int dataSizeBytes)
+{
+    const void* bytes = view(dataSizeBytes);
+    if (bytes) {
+        memcpy(data, bytes, dataSizeBytes);
+    } else {
+        memset(data, 0, dataSizeBytes);
+    }
+}
+
+void BufferReader::readArray(void* data, unsigned int elementSizeBytes, unsigned int elementsCount)
+{
+    read(data, elementSizeBytes * elementsCount);
+}
+
+}
@@ -0,0 +1,38 @@
+#include <cstddef>
+
+#include "bufferWriter.h"
+
+namespace decore {
+
+const unsigned char* BufferWriter::data() const
+{
+    return mBytes.empty() ? NULL : &mBytes[0];
+}
+
+unsigned int BufferWriter::size() const
+{
+    return mBytes.size();
+}
+
+void BufferWriter::clear()
+{
+    mBytes.clear();
+}
+
+unsigned int BufferWriter::position() const
+{
+    return mBytes.size();
+}
+
+void BufferWriter::write(const void* data, unsigned int dataSizeBytes)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    mBytes.insert(mBytes.end(), bytes, bytes + dataSizeBytes);
+}
+
+void BufferWriter::writeArray(const void* data, unsigned int elementSizeBytes, unsigned int elementsCount)
+{
+    write(data, elementSizeBytes * elementsCount);
+}
+
+}
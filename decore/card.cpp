@@ -1,30 +1,78 @@
+#include <cassert>
+#include <functional>
+
 #include "card.h"
 
 namespace decore {
 
-Card::Card(const Suit &suit, const Rank &rank)
-    : mSuit(suit), mRank(rank)
-{
-}
+#define SUIT_SUITS(suit) \
+    suit, suit, suit, suit, suit, suit, suit, suit, suit
 
-bool Card::operator ==(const Card &other) const
-{
-    return mRank == other.mRank && mSuit == other.mSuit;
-}
+const Suit Card::SUITS[INVALID_INDEX + 1] = {
+    SUIT_SUITS(SUIT_SPADES),
+    SUIT_SUITS(SUIT_HEARTS),
+    SUIT_SUITS(SUIT_DIAMONDS),
+    SUIT_SUITS(SUIT_CLUBS),
+    SUIT_LAST,
+};
+
+#undef SUIT_SUITS
 
-bool Card::operator <(const Card &other) const
+#define SUIT_RANKS \
+    RANK_6, RANK_7, RANK_8, RANK_9, RANK_10, RANK_JACK, RANK_QUEEN, RANK_KING, RANK_ACE
+
+const Rank Card::RANKS[INVALID_INDEX + 1] = {
+    SUIT_RANKS,
+    SUIT_RANKS,
+    SUIT_RANKS,
+    SUIT_RANKS,
+    RANK_LAST,
+};
+
+#undef SUIT_RANKS
+
+#define SUIT_CARDS(suit) \
+    Card(suit, RANK_6), \
+    Card(suit, RANK_7), \
+    Card(suit, RANK_8), \
+    Card(suit, RANK_9), \
+    Card(suit, RANK_10), \
+    Card(suit, RANK_JACK), \
+    Card(suit, RANK_QUEEN), \
+    Card(suit, RANK_KING), \
+    Card(suit, RANK_ACE)
+
+/**
+ * @brief Returns the table of interned cards
+ */
+static const Card* internedCards()
 {
-    return mSuit * RANK_LAST + mRank < other.mSuit * RANK_LAST + other.mRank;
+    static const Card cards[Card::INVALID_INDEX] = {
+        SUIT_CARDS(SUIT_SPADES),
+        SUIT_CARDS(SUIT_HEARTS),
+        SUIT_CARDS(SUIT_DIAMONDS),
+        SUIT_CARDS(SUIT_CLUBS),
+    };
+    return cards;
 }
 
-const Rank& Card::rank() const
+#undef SUIT_CARDS
+
+const Card& Card::interned(unsigned int index)
 {
-    return mRank;
+    assert(index < INVALID_INDEX);
+    return internedCards()[index];
 }
 
-const Suit& Card::suit() const
+unsigned int Card::internedIndex(const Card* card)
 {
-    return mSuit;
+    const Card* cards = internedCards();
+    // compare pointers with std::less, pointers to unrelated objects are not comparable with `<`
+    std::less<const Card*> less;
+    if (less(card, cards) || !less(card, cards + INVALID_INDEX)) {
+        return INVALID_INDEX;
+    }
+    return card - cards;
 }
 
 }
@@ -1,12 +1,31 @@
-#include <algorithm>
+#include <cassert>
 
 #include "cardSet.h"
+#include "bits.h"
 
 namespace decore {
 
+/**
+ * @brief Mask with one bit per rank of a suit
+ */
+static const CardSet::Mask SUIT_BITS = (static_cast<CardSet::Mask>(1) << RANK_LAST) - 1;
+
+/**
+ * @brief Mask with one bit per suit for the lowest rank
+ */
+static const CardSet::Mask RANK_BITS = 1
+    | static_cast<CardSet::Mask>(1) << RANK_LAST
+    | static_cast<CardSet::Mask>(1) << RANK_LAST * 2
+    | static_cast<CardSet::Mask>(1) << RANK_LAST * 3;
+
 CardSet::CardSet()
+    : mMask(0)
+{
+}
+
+CardSet::CardSet(Mask mask)
+    : mMask(mask)
 {
-    //ctor
 }
 
 CardSet::~CardSet()
@@ -14,63 +33,226 @@ CardSet::~CardSet()
     //dtor
 }
 
+CardSet::const_iterator CardSet::begin() const
+{
+    return const_iterator(&mMask, next(mMask, 0));
+}
+
+CardSet::const_iterator CardSet::end() const
+{
+    return const_iterator(&mMask, CARDS);
+}
+
+bool CardSet::empty() const
+{
+    return !mMask;
+}
+
+CardSet::size_type CardSet::size() const
+{
+    return bitCount(mMask);
+}
+
+std::pair<CardSet::iterator, bool> CardSet::insert(const Card& card)
+{
+    Mask bit = cardMask(card);
+    bool inserted = !(mMask & bit);
+    mMask |= bit;
+    return std::make_pair(find(card), inserted);
+}
+
+CardSet::iterator CardSet::insert(const_iterator hint, const Card& card)
+{
+    (void) hint;
+    return insert(card).first;
+}
+
+CardSet::size_type CardSet::erase(const Card& card)
+{
+    Mask bit = cardMask(card);
+    size_type erased = (mMask & bit) ? 1 : 0;
+    mMask &= ~bit;
+    return erased;
+}
+
+void CardSet::erase(const_iterator position)
+{
+    assert(position != end());
+    erase(*position);
+}
+
+CardSet::const_iterator CardSet::find(const Card& card) const
+{
+    if (mMask & cardMask(card)) {
+        return const_iterator(&mMask, card.index());
+    }
+    return end();
+}
+
+CardSet::size_type CardSet::count(const Card& card) const
+{
+    return (mMask & cardMask(card)) ? 1 : 0;
+}
+
+bool CardSet::contains(const Card* card) const
+{
+    unsigned int index = Card::internedIndex(card);
+    return index != Card::INVALID_INDEX && (mMask >> index & 1);
+}
+
+void CardSet::clear()
+{
+    mMask = 0;
+}
+
+bool CardSet::operator==(const CardSet& other) const
+{
+    return mMask == other.mMask;
+}
+
+bool CardSet::operator!=(const CardSet& other) const
+{
+    return mMask != other.mMask;
+}
+
 bool CardSet::addAll(const std::vector<Card> &cards)
 {
     unsigned int oldSize = size();
-    std::copy(cards.begin(), cards.end(), std::inserter(*this, begin()));
+    insert(cards.begin(), cards.end());
     return oldSize + cards.size() == size();
 }
 
-/**
- * @brief std::for_each function
- */
-class RankFilter
-{
-    const Rank& mRank;
-    CardSet& mCards;
-public:
-    RankFilter(const Rank &rank, CardSet& cards)
-        : mRank(rank)
-        , mCards(cards)
-    {}
-
-    void operator() (const Card& card)
-    {
-        if (card.rank() == mRank) {
-           mCards.insert(card);
-        }
-    }
-};
+bool CardSet::addAll(const CardSet& cards)
+{
+    bool res = !(mMask & cards.mMask);
+    mMask |= cards.mMask;
+    return res;
+}
+
+void CardSet::removeAll(const CardSet& cards)
+{
+    mMask &= ~cards.mMask;
+}
 
 void CardSet::getCards(const Rank &rank, CardSet &cards) const
 {
-    std::for_each(begin(), end(), RankFilter(rank, cards));
+    cards.mMask |= mMask & rankMask(rank);
 }
 
-/**
- * @brief std::for_each function
- */
-class SuitFilter
-{
-    const Suit& mSuit;
-    CardSet& mCards;
-public:
-    SuitFilter(const Suit& suit, CardSet& cards)
-        : mSuit(suit)
-        , mCards(cards)
-    {}
-
-    void operator() (const Card& card)
-    {
-        if (card.suit() == mSuit) {
-            mCards.insert(card);
-        }
+void CardSet::getCards(const Suit &suit, CardSet &cards) const
+{
+    cards.mMask |= mMask & suitMask(suit);
+}
+
+CardSet::Mask CardSet::mask() const
+{
+    return mMask;
+}
+
+unsigned int CardSet::ranks() const
+{
+    Mask ranks = mMask | mMask >> RANK_LAST | mMask >> RANK_LAST * 2 | mMask >> RANK_LAST * 3;
+    return static_cast<unsigned int>(ranks & SUIT_BITS);
+}
+
+CardSet::Mask CardSet::cardMask(const Card& card)
+{
+    assert(card.index() < CARDS);
+    return static_cast<Mask>(1) << card.index();
+}
+
+CardSet::Mask CardSet::rankMask(const Rank& rank)
+{
+    return RANK_BITS << rank;
+}
+
+CardSet::Mask CardSet::suitMask(const Suit& suit)
+{
+    return SUIT_BITS << suit * RANK_LAST;
+}
+
+CardSet::Mask CardSet::rankColumns(unsigned int ranks)
+{
+    assert(!(ranks & ~SUIT_BITS));
+    return RANK_BITS * ranks;
+}
+
+unsigned int CardSet::next(Mask mask, unsigned int from)
+{
+    if (from >= CARDS) {
+        return CARDS;
     }
-};
+    mask >>= from;
+    return mask ? from + lowestBit(mask) : CARDS;
+}
 
-void CardSet::getCards(const Suit &suit, CardSet &cards) const
+unsigned int CardSet::previous(Mask mask, unsigned int to)
+{
+    if (to < CARDS) {
+        mask &= (static_cast<Mask>(1) << to) - 1;
+    }
+    return mask ? highestBit(mask) : CARDS;
+}
+
+CardSet::const_iterator::const_iterator()
+    : mMask(NULL)
+    , mIndex(CARDS)
+{
+}
+
+CardSet::const_iterator::const_iterator(const Mask* mask, unsigned int index)
+    : mMask(mask)
+    , mIndex(index)
+{
+}
+
+CardSet::const_iterator::reference CardSet::const_iterator::operator*() const
+{
+    return Card::interned(mIndex);
+}
+
+CardSet::const_iterator::pointer CardSet::const_iterator::operator->() const
+{
+    return &Card::interned(mIndex);
+}
+
+CardSet::const_iterator& CardSet::const_iterator::operator++()
+{
+    assert(mMask && mIndex < CARDS);
+    mIndex = next(*mMask, mIndex + 1);
+    return *this;
+}
+
+CardSet::const_iterator CardSet::const_iterator::operator++(int)
+{
+    const_iterator res(*this);
+    ++*this;
+    return res;
+}
+
+CardSet::const_iterator& CardSet::const_iterator::operator--()
+{
+    assert(mMask);
+    mIndex = previous(*mMask, mIndex);
+    assert(mIndex < CARDS);
+    return *this;
+}
+
+CardSet::const_iterator CardSet::const_iterator::operator--(int)
+{
+    const_iterator res(*this);
+    --*this;
+    return res;
+}
+
+bool CardSet::const_iterator::operator==(const const_iterator& other) const
+{
+    return mIndex == other.mIndex;
+}
+
+bool CardSet::const_iterator::operator!=(const const_iterator& other) const
 {
-    std::for_each(begin(), end(), SuitFilter(suit, cards));
+    return mIndex != other.mIndex;
 }
 
 }
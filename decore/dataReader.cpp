@@ -1,3 +1,5 @@
+#include <stddef.h>
+
 #include "dataReader.h"
 
 namespace decore
@@ -11,4 +13,41 @@ DataReader::~DataReader()
 {
 }
 
+uint8_t DataReader::readUint8()
+{
+    uint8_t value;
+    read(static_cast<void*>(&value), sizeof(value));
+    return value;
+}
+
+uint32_t DataReader::readUint32()
+{
+    unsigned char bytes[sizeof(uint32_t)];
+    read(static_cast<void*>(bytes), sizeof(bytes));
+    uint32_t value = 0;
+    for (unsigned int i = 0; i < sizeof(bytes); ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+    }
+    return value;
+}
+
+void DataReader::readArray(void* data, unsigned int elementSizeBytes, unsigned int elementsCount)
+{
+    unsigned char* element = static_cast<unsigned char*>(data);
+    while (elementsCount--) {
+        read(static_cast<void*>(element), elementSizeBytes);
+        element += elementSizeBytes;
+    }
+}
+
+void DataReader::readBytes(void* data, unsigned int dataSizeBytes)
+{
+    read(data, dataSizeBytes);
+}
+
+const void* DataReader::view(unsigned int)
+{
+    return NULL;
+}
+
 }
@@ -11,5 +11,32 @@ DataWriter::~DataWriter()
 {
 }
 
+void DataWriter::writeUint8(uint8_t value)
+{
+    write(static_cast<const void*>(&value), sizeof(value));
+}
+
+void DataWriter::writeUint32(uint32_t value)
+{
+    unsigned char bytes[sizeof(value)];
+    for (unsigned int i = 0; i < sizeof(bytes); ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (i * 8));
+    }
+    write(static_cast<const void*>(bytes), sizeof(bytes));
 }
 
+void DataWriter::writeArray(const void* data, unsigned int elementSizeBytes, unsigned int elementsCount)
+{
+    const unsigned char* element = static_cast<const unsigned char*>(data);
+    while (elementsCount--) {
+        write(static_cast<const void*>(element), elementSizeBytes);
+        element += elementSizeBytes;
+    }
+}
+
+void DataWriter::writeBytes(const void* data, unsigned int dataSizeBytes)
+{
+    write(data, dataSizeBytes);
+}
+
+}
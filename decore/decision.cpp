@@ -0,0 +1,31 @@
+#include <cstddef>
+
+#include "decision.h"
+#include "player.h"
+
+namespace decore {
+
+Decision::Decision()
+    : type(DECISION_NONE)
+    , player(NULL)
+    , opponent(NULL)
+    , attackCard(SUIT_LAST, RANK_LAST)
+{
+}
+
+const Card* Decision::ask(Player& player) const
+{
+    switch (type) {
+    case DECISION_ATTACK:
+        return &player.attack(opponent, cards);
+    case DECISION_PITCH:
+        return player.pitch(opponent, cards);
+    case DECISION_DEFEND:
+        return player.defend(opponent, attackCard, cards);
+    case DECISION_NONE:
+        break;
+    }
+    return NULL;
+}
+
+}
@@ -1,19 +1,164 @@
 #include <map>
 #include <cstddef>
 #include <ctime>
-#include <cstdlib>
 #include <cassert>
 
 #include "deck.h"
+#include "random.h"
+#include "atomic.h"
 
 namespace decore {
 
+/**
+ * @brief Amount of shuffle() calls, makes seeds of the calls in same second differ
+ */
+static Atomic<uint64_t> shuffleCounter(0);
+
+/**
+ * @brief Returns seed for shuffle()
+ */
+static uint64_t shuffleSeed()
+{
+    uint64_t counter = shuffleCounter.getAndAdd(1);
+    uint64_t seed = static_cast<uint64_t>(std::time(NULL)) ^ static_cast<uint64_t>(std::clock()) << 32;
+    return seed ^ Random::splitMix(counter);
+}
+
+Deck::Deck()
+    : mTrumpSuit(SUIT_LAST)
+    , mTop(0)
+{
+}
+
+Deck::Deck(const Deck& other)
+    : mCards(other.begin(), other.end())
+    , mTrumpSuit(other.mTrumpSuit)
+    , mTop(0)
+{
+}
+
+Deck& Deck::operator=(const Deck& other)
+{
+    if (this != &other) {
+        mCards.assign(other.begin(), other.end());
+        mTrumpSuit = other.mTrumpSuit;
+        mTop = 0;
+    }
+    return *this;
+}
+
 void Deck::push_back(const Card &card)
 {
-    std::vector<Card>::push_back(card);
+    mCards.push_back(card);
     mTrumpSuit = card.suit();
 }
 
+void Deck::clear()
+{
+    mCards.clear();
+    mTop = 0;
+}
+
+void Deck::resize(size_type size, const Card& card)
+{
+    mCards.resize(mTop + size, card);
+}
+
+Deck::iterator Deck::begin()
+{
+    return mCards.begin() + mTop;
+}
+
+Deck::const_iterator Deck::begin() const
+{
+    return mCards.begin() + mTop;
+}
+
+Deck::iterator Deck::end()
+{
+    return mCards.end();
+}
+
+Deck::const_iterator Deck::end() const
+{
+    return mCards.end();
+}
+
+Deck::size_type Deck::size() const
+{
+    return mCards.size() - mTop;
+}
+
+bool Deck::empty() const
+{
+    return !size();
+}
+
+Deck::size_type Deck::capacity() const
+{
+    return mCards.capacity();
+}
+
+Deck::reference Deck::operator[](size_type index)
+{
+    return mCards[mTop + index];
+}
+
+Deck::const_reference Deck::operator[](size_type index) const
+{
+    return mCards[mTop + index];
+}
+
+Deck::reference Deck::at(size_type index)
+{
+    return mCards.at(mTop + index);
+}
+
+Deck::const_reference Deck::at(size_type index) const
+{
+    return mCards.at(mTop + index);
+}
+
+Deck::reference Deck::front()
+{
+    return *begin();
+}
+
+Deck::const_reference Deck::front() const
+{
+    return *begin();
+}
+
+Deck::reference Deck::back()
+{
+    return mCards.back();
+}
+
+Deck::const_reference Deck::back() const
+{
+    return mCards.back();
+}
+
+bool Deck::operator==(const Deck& other) const
+{
+    return size() == other.size() && std::equal(begin(), end(), other.begin());
+}
+
+bool Deck::operator!=(const Deck& other) const
+{
+    return !(*this == other);
+}
+
+unsigned int Deck::deal(CardSet& cards, unsigned int amount)
+{
+    if (amount > size()) {
+        amount = size();
+    }
+    cards.insert(begin(), begin() + amount);
+    mTop += amount;
+    return amount;
+}
+
 void Deck::generate(const Rank *ranks, unsigned int ranksSize, const Suit *suits, unsigned int suitsSize)
 {
     clear();
@@ -27,23 +172,18 @@ void Deck::generate(const Rank *ranks, unsigned int ranksSize, const Suit *suits
     }
 }
 
-unsigned int Deck::shuffle()
+void Deck::generate(const Rank *ranks, unsigned int ranksSize, const Suit *suits, unsigned int suitsSize, uint64_t seed, uint64_t gameIndex)
 {
-    std::vector<Card> cards(*this);
-    std::vector<Card> origin(*this);
-    clear();
-    std::srand(std::time(NULL));
-    while (!cards.empty()) {
-        unsigned int index = std::rand() * (cards.size() - 1) / RAND_MAX;
-        assert(index < cards.size());
-        Card card = cards[index];
-        cards.erase(cards.begin() + index);
-        push_back(card);
-    }
+    generate(ranks, ranksSize, suits, suitsSize);
+    CounterRandom generator(seed, gameIndex);
+    shuffle(generator);
+}
 
-    if (!empty()) {
-        mTrumpSuit = (end() - 1)->suit();
-    }
+unsigned int Deck::shuffle()
+{
+    std::vector<Card> origin(begin(), end());
+    Random generator(shuffleSeed());
+    shuffle(generator);
 
     unsigned int notShuffledCards = 0;
 
@@ -25,7 +25,17 @@ SOURCES += \
     gameCardsTracker.cpp \
     dataWriter.cpp \
     dataReader.cpp \
-    playerIds.cpp
+    playerIds.cpp \
+    random.cpp \
+    simulation.cpp \
+    batchRunner.cpp \
+    asyncObserver.cpp \
+    decision.cpp \
+    tableHost.cpp \
+    bufferWriter.cpp \
+    bufferReader.cpp \
+    mappedFileReader.cpp \
+    saveFormat.cpp
 
 HEADERS += \
     include/card.h \
@@ -42,4 +52,20 @@ HEADERS += \
     include/dataWriter.h \
     include/dataReader.h \
     include/playerIds.h \
-    include/atomic.h
+    include/atomic.h \
+    include/random.h \
+    include/simulation.h \
+    include/batchRunner.h \
+    include/eventObserver.h \
+    include/asyncObserver.h \
+    include/decision.h \
+    include/journal.h \
+    include/seqLock.h \
+    include/spectatorState.h \
+    include/tableHost.h \
+    include/bufferWriter.h \
+    include/bufferReader.h \
+    include/mappedFileReader.h \
+    include/saveFormat.h \
+    include/typeTraits.h \
+    include/bits.h
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "engine.h"
 #include "player.h"
@@ -8,27 +9,45 @@
 #include "deck.h"
 #include "dataWriter.h"
 #include "dataReader.h"
+#include "simulation.h"
+#include "bits.h"
+#include "bufferWriter.h"
+#include "bufferReader.h"
+#include "saveFormat.h"
 
 namespace decore {
 
-Engine::Engine()
-    : mDeck(NULL)
+Engine::Engine(bool threadSafe)
+    : mSeatsWithCards(0)
+    , mDeck(NULL)
     , mPlayerIdCounter(0)
     , mCurrentPlayer(NULL)
     , mRoundIndex(0)
+    , mAttackerSeats(0)
     , mDefender(NULL)
 #ifndef NDEBUG
     , mLocked(false)
 #endif
     , mQuit(false)
+    , mThreadSafe(threadSafe)
     , mCurrentRoundAttackerId(NULL)
     , mPassedCounter(0)
     , mMaxAttackCards(0)
     , mDefendFailed(false)
     , mPickAttackCardFromTable(false)
     , mCurrentRoundIndex(NULL)
+    , mAnswer(NULL)
+    , mAnswered(false)
+    , mJournal(NULL)
+    , mSnapshotRounds(1)
+    , mSnapshotPending(false)
+    , mReplayPosition(0)
+    , mReplayFailed(false)
+    , mSpectatorVersion(0)
+    , mSpectatorState(SpectatorState())
 {
     pthread_mutex_init(&mLock, NULL);
+    pthread_mutex_init(&mSaveLock, NULL);
 }
 
 Engine::~Engine()
@@ -37,12 +56,13 @@ Engine::~Engine()
     for(std::vector<const PlayerId*>::iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
         delete *it;
     }
+    pthread_mutex_destroy(&mSaveLock);
     pthread_mutex_destroy(&mLock);
 }
 
 PlayerId *Engine::add(Player& player)
 {
-    if (mDeck) {
+    if (mDeck || mGeneratedIds.size() == Rules::MAX_SEATS) {
         return NULL;
     }
 
@@ -50,8 +70,8 @@ PlayerId *Engine::add(Player& player)
 
     // initialize player related data
     mGeneratedIds.push_back(id);
-    mPlayers[id] = &player;
-    mPlayersCards[id] = CardSet();
+    mPlayers.push_back(&player);
+    mPlayersCards.push_back(CardSet());
 
     // add this player to game observers
     addGameObserver(player);
@@ -85,20 +105,33 @@ bool Engine::setDeck(const Deck &deck)
         return false;
     }
 
+    startGame(deck);
+
+    return true;
+}
+
+void Engine::startGame(const Deck& deck)
+{
     mDeck = new Deck(deck);
+    notifyGameStarted();
+    publish();
+}
 
+void Engine::notifyGameStarted()
+{
     CardSet cards;
 
-    cards.insert(deck.begin(), deck.end());
+    cards.insert(mDeck->begin(), mDeck->end());
 
     std::for_each(mGameObservers.begin(), mGameObservers.end(), GameStartNotification(mDeck->trumpSuit(), mGeneratedIds, cards));
-
-    return true;
+    postGameEvents(EVENT_GAME_STARTED, cards);
 }
 
 void Engine::lock() const
 {
-    pthread_mutex_lock(&mLock);
+    if (mThreadSafe) {
+        pthread_mutex_lock(&mLock);
+    }
 #ifndef NDEBUG
     assert(!mLocked);
     mLocked = true;
@@ -111,69 +144,115 @@ void Engine::unlock() const
     assert(mLocked);
     mLocked = false;
 #endif
-    pthread_mutex_unlock(&mLock);
+    if (mThreadSafe) {
+        pthread_mutex_unlock(&mLock);
+    }
 }
 
-bool Engine::findByPtr(const CardSet& cards, const Card* card)
+bool Engine::playRound()
 {
-    for (CardSet::const_iterator it = cards.begin(); it != cards.end(); ++it) {
-        if (&*it == card) {
+    for (;;) {
+        switch (advance()) {
+        case PROGRESS_DECISION:
+            // the player's card is checked by its address, see CardSet::contains()
+            mAnswer = mDecision.ask(*mPlayers[mDecision.player->seat()]);
+            mAnswered = true;
+            break;
+        case PROGRESS_ROUND_ENDED:
             return true;
+        case PROGRESS_GAME_ENDED:
+            return false;
         }
     }
-    return false;
 }
 
-bool Engine::playRound()
+bool Engine::step(Decision& decision)
 {
-    if (!mDeck) {
-        // no cards set
-        return false;
+    Progress progress;
+    while (PROGRESS_ROUND_ENDED == (progress = advance()));
+    if (PROGRESS_DECISION == progress) {
+        decision = mDecision;
+        return true;
     }
+    return false;
+}
 
-    if (mGeneratedIds.size() < 2) {
-        // too few players - at least two should be set
+bool Engine::submit(const Card* card)
+{
+    if (DECISION_NONE == mDecision.type || mAnswered) {
+        // stray or duplicate answer: the next decision must not be answered with it
         return false;
     }
+    // the card could be owned by the caller - take the interned one
+    mAnswer = card && card->index() < Card::INVALID_INDEX ? &Card::interned(card->index()) : NULL;
+    mAnswered = true;
+    return true;
+}
 
-    if (gameEnded()) {
-        return false;
+const PlayerId *Engine::getLoser()
+{
+    // the only player with cards
+    if (!mSeatsWithCards || (mSeatsWithCards & (mSeatsWithCards - 1))) {
+        return NULL;
     }
+    return mGeneratedIds[lowestBit(mSeatsWithCards)];
+}
 
-    bool defended = playCurrentRound();
-
-    lock();
-    mDefendFailed = false;
-    mRoundIndex++;
-
-    // if attack failed "next move" goes to defender
-    // or to next player after the defender otherwise
-    mCurrentPlayer = defended ? mDefender : Rules::pickNext(mGeneratedIds, mDefender, &mPlayersCards);
-
-    // cleanup
-    mAttackers.clear();
-    mDefender = NULL;
-    mTableCards.clear();
+void Engine::addGameObserver(GameObserver &observer)
+{
+    mGameObservers.push_back(&observer);
+}
 
-    unlock();
+void Engine::addEventObserver(EventObserver& observer)
+{
+    mEventObservers.push_back(&observer);
+}
 
-    return !gameEnded();
+void Engine::post(GameEventType type, const PlayerId* player, unsigned int value, CardSet::Mask cards)
+{
+    if (mEventObservers.empty()) {
+        return;
+    }
+    GameEvent event;
+    event.cards = cards;
+    event.player = player;
+    event.value = value;
+    event.type = type;
+    event.suit = 0;
+    mEvents.push_back(event);
 }
 
-const PlayerId *Engine::getLoser()
+void Engine::postGameEvents(GameEventType type, const CardSet& cards)
 {
-    std::vector<const PlayerId*> playersWithCards;
-    for(std::map<const PlayerId*, CardSet>::const_iterator it = mPlayersCards.begin(); it != mPlayersCards.end(); ++it) {
-        if(!it->second.empty()) {
-            playersWithCards.push_back(it->first);
+    if (mEventObservers.empty()) {
+        return;
+    }
+    post(type, NULL, EVENT_GAME_RESTORED == type ? mDeck->size() : 0, cards.mask());
+    mEvents.back().suit = mDeck->trumpSuit();
+    for (PlayerIds::const_iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
+        post(EVENT_PLAYER, *it, EVENT_GAME_RESTORED == type ? mPlayersCards[(*it)->seat()].size() : 0, 0);
+    }
+    if (EVENT_GAME_RESTORED == type) {
+        const std::vector<Card>& attackCards = mTableCards.attackCards();
+        for (std::vector<Card>::const_iterator it = attackCards.begin(); it != attackCards.end(); ++it) {
+            post(EVENT_TABLE_ATTACK_CARD, NULL, 0, CardSet::cardMask(*it));
+        }
+        const std::vector<Card>& defendCards = mTableCards.defendCards();
+        for (std::vector<Card>::const_iterator it = defendCards.begin(); it != defendCards.end(); ++it) {
+            post(EVENT_TABLE_DEFEND_CARD, NULL, 0, CardSet::cardMask(*it));
         }
     }
-    return playersWithCards.empty() ? NULL : 1 == playersWithCards.size() ? playersWithCards[0] : NULL;
 }
 
-void Engine::addGameObserver(GameObserver &observer)
+void Engine::flushEvents()
 {
-    mGameObservers.push_back(&observer);
+    if (mEvents.empty()) {
+        return;
+    }
+    for (std::vector<EventObserver*>::iterator it = mEventObservers.begin(); it != mEventObservers.end(); ++it) {
+        (*it)->events(&mEvents[0], mEvents.size());
+    }
+    mEvents.clear();
 }
 
 bool Engine::gameEnded() const
@@ -187,73 +266,240 @@ bool Engine::gameEnded() const
         return false;
     }
 
-    unsigned int playersWithCards = 0;
-    for(std::map<const PlayerId*, CardSet>::const_iterator it = mPlayersCards.begin(); it != mPlayersCards.end(); ++it) {
-        if(!it->second.empty()) {
-            playersWithCards++;
-        }
-    }
-
-    return playersWithCards < 2;
+    // less than two bits set
+    return !(mSeatsWithCards & (mSeatsWithCards - 1));
 }
 
-void Engine::save(DataWriter& writer) const
+// players are identified by index as in the saved data
+class Engine::SavedGame
 {
-    if (!mDeck || !mCurrentPlayer) {
-        // save called too early - nothing to save actually because the game has not been even started
-        return;
+public:
+    std::vector<CardSet> mPlayersCards;
+    Deck mDeck;
+    unsigned int mCurrentPlayer;
+    unsigned int mRoundIndex;
+    bool mRoundRunning;
+    std::vector<unsigned int> mAttackers;
+    unsigned int mDefender;
+    unsigned int mPassedCounter;
+    unsigned int mCurrentRoundAttacker;
+    std::vector<Card> mAttackCards;
+    std::vector<Card> mDefendCards;
+    unsigned int mMaxAttackCards;
+    bool mDefendFailed;
+
+    /**
+     * @brief Writes the state in the format of init()
+     * @param writer destination
+     */
+    void write(DataWriter& writer) const;
+    /**
+     * @brief Reads the state written by write()
+     *
+     * The data is not trusted: the indexes and the cards are checked.
+     * @param reader source
+     * @param players amount of the players of the game
+     * @return false if the data is not valid
+     */
+    bool read(BufferReader& reader, unsigned int players);
+};
+
+/**
+ * @brief Reads cards written by SaveFormat::writeCards() to the end of the `cards`
+ * @param reader source
+ * @param cards destination
+ * @return false if the data is not valid
+ */
+template <typename T>
+static bool readValidCards(BufferReader& reader, T& cards)
+{
+    const uint32_t amount = reader.readUint32();
+    if (reader.failed() || amount > Card::INVALID_INDEX) {
+        return false;
     }
+    reader.readElements(cards, amount, Card(SUIT_LAST, RANK_LAST));
+    for (typename T::const_iterator it = cards.begin(); it != cards.end(); ++it) {
+        if (it->index() >= Card::INVALID_INDEX) {
+            return false;
+        }
+    }
+    return !reader.failed();
+}
 
-    lock();
-
+void Engine::SavedGame::write(DataWriter& writer) const
+{
     // save players count
-    writer.write(mGeneratedIds.size());
+    writer.writeUint32(mPlayersCards.size());
     // save each player cards
-    for (std::vector<const PlayerId*>::const_iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
-        const CardSet& playerCards = mPlayersCards.at(*it);
-        writer.write(playerCards.begin(), playerCards.end());
+    for (std::vector<CardSet>::const_iterator it = mPlayersCards.begin(); it != mPlayersCards.end(); ++it) {
+        SaveFormat::writeCards(writer, it->begin(), it->end());
     }
     // save deck
-    writer.write(mDeck->begin(), mDeck->end());
+    SaveFormat::writeCards(writer, mDeck.begin(), mDeck.end());
     // save trump suit
-    writer.write(mDeck->trumpSuit());
+    writer.writeUint8(mDeck.trumpSuit());
     // save current player index
-    writer.write(mGeneratedIds.index(mCurrentPlayer));
+    writer.writeUint32(mCurrentPlayer);
     // save current round index
-    writer.write(mRoundIndex);
+    writer.writeUint32(mRoundIndex);
 
     // save bool if round is running
-    writer.write(static_cast<bool>(mCurrentRoundIndex));
+    writer.writeUint8(mRoundRunning);
     // save current round related data
-    if (mCurrentRoundIndex) {
+    if (mRoundRunning) {
         // save attackers
-        writer.write(mAttackers.size());
+        writer.writeUint32(mAttackers.size());
+        for (std::vector<unsigned int>::const_iterator it = mAttackers.begin(); it != mAttackers.end(); ++it) {
+            writer.writeUint32(*it);
+        }
+        writer.writeUint32(mDefender);
+        writer.writeUint32(mPassedCounter);
+        writer.writeUint32(mCurrentRoundAttacker);
+        SaveFormat::writeCards(writer, mAttackCards.begin(), mAttackCards.end());
+        SaveFormat::writeCards(writer, mDefendCards.begin(), mDefendCards.end());
+        writer.writeUint32(mMaxAttackCards);
+        writer.writeUint8(mDefendFailed);
+    }
+}
+
+bool Engine::SavedGame::read(BufferReader& reader, unsigned int players)
+{
+    for (unsigned int i = 0; i < players; ++i) {
+        std::vector<Card> cards;
+        if (!readValidCards(reader, cards)) {
+            return false;
+        }
+        mPlayersCards.push_back(CardSet());
+        mPlayersCards.back().insert(cards.begin(), cards.end());
+    }
+
+    if (!readValidCards(reader, mDeck)) {
+        return false;
+    }
+    const unsigned int trumpSuit = reader.readUint8();
+    if (trumpSuit >= SUIT_LAST) {
+        return false;
+    }
+    mDeck.setTrumpSuit(static_cast<Suit>(trumpSuit));
+    mCurrentPlayer = reader.readUint32();
+    mRoundIndex = reader.readUint32();
+    mRoundRunning = reader.readUint8();
+    if (mCurrentPlayer >= players) {
+        return false;
+    }
+
+    if (mRoundRunning) {
+        const uint32_t attackersAmount = reader.readUint32();
+        if (attackersAmount > players) {
+            return false;
+        }
+        for (unsigned int i = 0; i < attackersAmount; ++i) {
+            mAttackers.push_back(reader.readUint32());
+            if (mAttackers.back() >= players) {
+                return false;
+            }
+        }
+        mDefender = reader.readUint32();
+        mPassedCounter = reader.readUint32();
+        mCurrentRoundAttacker = reader.readUint32();
+        if (mDefender >= players || mCurrentRoundAttacker >= players
+            || !readValidCards(reader, mAttackCards) || !readValidCards(reader, mDefendCards)
+            || mAttackCards.size() > Rules::MAX_PLAYER_CARDS || mDefendCards.size() > mAttackCards.size()) {
+            return false;
+        }
+        mMaxAttackCards = reader.readUint32();
+        mDefendFailed = reader.readUint8();
+    }
+    return !reader.failed();
+}
+
+void Engine::save(DataWriter& writer) const
+{
+    if (mThreadSafe) {
+        // the observers keep one snapshot at a time
+        pthread_mutex_lock(&mSaveLock);
+    }
+
+    SavedGame game;
+    // observers data by observer index
+    std::vector<BufferWriter> sections(mGameObservers.size());
+    std::vector<bool> copied(mGameObservers.size());
+
+    lock();
+    if (!mDeck || !mCurrentPlayer) {
+        // save called too early - nothing to save actually because the game has not been even started
+        unlock();
+        if (mThreadSafe) {
+            pthread_mutex_unlock(&mSaveLock);
+        }
+        return;
+    }
+    game.mPlayersCards = mPlayersCards;
+    game.mDeck = *mDeck;
+    game.mCurrentPlayer = mGeneratedIds.index(mCurrentPlayer);
+    game.mRoundIndex = mRoundIndex;
+    game.mRoundRunning = mCurrentRoundIndex;
+    if (mCurrentRoundIndex) {
         for (std::vector<const PlayerId*>::const_iterator it = mAttackers.begin(); it != mAttackers.end(); ++it) {
-            writer.write(mGeneratedIds.index(*it));
+            game.mAttackers.push_back(mGeneratedIds.index(*it));
         }
         assert(mDefender);
-        writer.write(mGeneratedIds.index(mDefender));
-        writer.write(mPassedCounter);
+        game.mDefender = mGeneratedIds.index(mDefender);
+        game.mPassedCounter = mPassedCounter;
         assert(mCurrentRoundAttackerId);
-        writer.write(mGeneratedIds.index(mCurrentRoundAttackerId));
-        writer.write(mTableCards.attackCards().begin(), mTableCards.attackCards().end());
-        writer.write(mTableCards.defendCards().begin(), mTableCards.defendCards().end());
-        writer.write(mMaxAttackCards);
-        writer.write(mDefendFailed);
+        game.mCurrentRoundAttacker = mGeneratedIds.index(mCurrentRoundAttackerId);
+        game.mAttackCards = mTableCards.attackCards();
+        game.mDefendCards = mTableCards.defendCards();
+        game.mMaxAttackCards = mMaxAttackCards;
+        game.mDefendFailed = mDefendFailed;
     }
+    // observers copy their data matching the game state, the rest are saved right away
+    for (unsigned int i = 0; i < mGameObservers.size(); ++i) {
+        copied[i] = mGameObservers[i]->snapshot();
+        if (!copied[i]) {
+            mGameObservers[i]->save(sections[i]);
+        }
+    }
+    unlock();
+
+    for (unsigned int i = 0; i < mGameObservers.size(); ++i) {
+        if (copied[i]) {
+            mGameObservers[i]->save(sections[i]);
+        }
+    }
+
+    if (mThreadSafe) {
+        pthread_mutex_unlock(&mSaveLock);
+    }
+
+    // the payload is collected in memory: its size and checksum go to the header
+    BufferWriter payload;
+    BufferWriter section;
+    game.write(section);
+    payload.writeUint32(section.size());
+    payload.writeBytes(section.data(), section.size());
 
     // save observers data
-    unsigned int observersCount = mGameObservers.size();
-    writer.write(observersCount);
-    for (std::vector<GameObserver*>::const_iterator it = mGameObservers.begin(); it != mGameObservers.end(); ++it) {
-        unsigned int observerDataStart = writer.position();
-        (*it)->save(writer);
-        writer.write(static_cast<unsigned int>(writer.position() - observerDataStart));
+    payload.writeUint32(sections.size());
+    for (std::vector<BufferWriter>::const_iterator it = sections.begin(); it != sections.end(); ++it) {
+        payload.writeUint32(it->size());
+        if (it->size()) {
+            payload.writeBytes(it->data(), it->size());
+        }
     }
-    unlock();
+
+    assert(payload.size() <= SaveFormat::MAX_PAYLOAD_SIZE);
+    BufferWriter header;
+    header.writeUint32(SaveFormat::MAGIC);
+    header.writeUint32(SaveFormat::VERSION);
+    header.writeUint32(payload.size());
+    header.writeUint32(SaveFormat::crc32(payload.data(), payload.size()));
+    assert(header.size() == SaveFormat::HEADER_SIZE);
+    writer.writeBytes(header.data(), header.size());
+    writer.writeBytes(payload.data(), payload.size());
 }
 
-void Engine::init(DataReader& reader, const std::vector<Player*> players, const std::vector<GameObserver*>& observers)
+bool Engine::init(DataReader& reader, const std::vector<Player*> players, const std::vector<GameObserver*>& observers)
 {
     // check that engine is not initialized yet
     assert(!mPlayerIdCounter);
@@ -262,98 +508,211 @@ void Engine::init(DataReader& reader, const std::vector<Player*> players, const
     assert(!mDeck);
     assert(mGameObservers.empty());
 
+    // check header
+    unsigned char headerBytes[SaveFormat::HEADER_SIZE];
+    reader.readBytes(headerBytes, sizeof(headerBytes));
+    BufferReader header(headerBytes, sizeof(headerBytes));
+    if (header.readUint32() != SaveFormat::MAGIC || header.readUint32() != SaveFormat::VERSION) {
+        return false;
+    }
+    const uint32_t payloadSize = header.readUint32();
+    const uint32_t payloadCrc = header.readUint32();
+    if (payloadSize > SaveFormat::MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    // the payload is checked and read in place if the reader is in memory, copied otherwise
+    std::vector<unsigned char> payloadCopy;
+    const void* payloadData = reader.view(payloadSize);
+    if (!payloadData && payloadSize) {
+        payloadCopy.resize(payloadSize);
+        reader.readBytes(&payloadCopy[0], payloadSize);
+        payloadData = &payloadCopy[0];
+    }
+    if (SaveFormat::crc32(payloadData, payloadSize) != payloadCrc) {
+        return false;
+    }
+    BufferReader payload(payloadData, payloadSize);
+    const uint32_t gameSize = payload.readUint32();
+    BufferReader game(payload.view(gameSize), gameSize);
+
     // read players count
-    std::vector<const PlayerId*>::size_type playersCount;
-    reader.read(playersCount);
+    const uint32_t playersCount = game.readUint32();
+    if (payload.failed() || game.failed() || players.size() != playersCount) {
+        return false;
+    }
+    // the data is checked before the engine or the observers are touched
+    SavedGame saved;
+    if (!saved.read(game, playersCount)) {
+        return false;
+    }
+    // the players are observers too
+    const uint32_t savedObservers = payload.readUint32();
+    if (savedObservers != playersCount + observers.size()) {
+        return false;
+    }
+    std::vector<BufferReader> observersData;
+    for (unsigned int i = 0; i < savedObservers; ++i) {
+        const uint32_t observerSize = payload.readUint32();
+        observersData.push_back(BufferReader(payload.view(observerSize), observerSize));
+    }
+    if (payload.failed()) {
+        return false;
+    }
 
-    assert(players.size() == playersCount);
     // add players
     for (std::vector<Player*>::const_iterator it = players.begin(); it != players.end(); ++it) {
         add(**it);
     }
 
-    const Card defaultCard(SUIT_LAST, RANK_LAST);
-    // read each player cards
+    // restore each player cards
     for (std::vector<const PlayerId*>::const_iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
-        CardSet& playerCards = mPlayersCards[*it];
+        CardSet& playerCards = mPlayersCards[(*it)->seat()];
         assert(playerCards.empty());
-        reader.read(playerCards, defaultCard);
-        mPlayers[*it]->cardsRestored(playerCards);
-    }
-
-    // read deck
-    Deck deck;
-    reader.read(deck, defaultCard);
-    Suit trumpSuit;
-    reader.read(trumpSuit);
-    deck.setTrumpSuit(trumpSuit);
-    setDeck(deck);
-
-    // read current player index
-    unsigned int currentPlayerindex;
-    reader.read(currentPlayerindex);
-    mCurrentPlayer = mGeneratedIds[currentPlayerindex];
-    // read current round index
-    reader.read(mRoundIndex);
-
-    bool roundRunning;
-    reader.read(roundRunning);
-    if (roundRunning) {
+        playerCards = saved.mPlayersCards[(*it)->seat()];
+        updateSeat((*it)->seat());
+        mPlayers[(*it)->seat()]->cardsRestored(playerCards);
+    }
+
+    // the deck of the saved game could be empty already - setDeck() does not accept it
+    startGame(saved.mDeck);
+
+    mCurrentPlayer = mGeneratedIds[saved.mCurrentPlayer];
+    mRoundIndex = saved.mRoundIndex;
+
+    if (saved.mRoundRunning) {
         mCurrentRoundIndex = &mRoundIndex;
-        // read current round data
-        std::vector<const PlayerId*>::size_type attackersAmount;
-        reader.read(attackersAmount);
-
-        while (attackersAmount--) {
-            unsigned int attackerIndex;
-            reader.read(attackerIndex);
-            mAttackers.push_back(mGeneratedIds[attackerIndex]);
-        }
-        unsigned int defenderIndex;
-        reader.read(defenderIndex);
-        mDefender = mGeneratedIds[defenderIndex];
-        reader.read(mPassedCounter);
-        unsigned int currentRoundAttackerIndex;
-        reader.read(currentRoundAttackerIndex);
-        mCurrentRoundAttackerId = mGeneratedIds[currentRoundAttackerIndex];
-
-        std::vector<Card> attackCards;
-        reader.read(attackCards, defaultCard);
-        for (std::vector<Card>::iterator it = attackCards.begin(); it != attackCards.end(); ++it) {
+        for (std::vector<unsigned int>::const_iterator it = saved.mAttackers.begin(); it != saved.mAttackers.end(); ++it) {
+            mAttackers.push_back(mGeneratedIds[*it]);
+            mAttackerSeats |= static_cast<Rules::Seats>(1) << *it;
+        }
+        mDefender = mGeneratedIds[saved.mDefender];
+        mPassedCounter = saved.mPassedCounter;
+        mCurrentRoundAttackerId = mGeneratedIds[saved.mCurrentRoundAttacker];
+        for (std::vector<Card>::const_iterator it = saved.mAttackCards.begin(); it != saved.mAttackCards.end(); ++it) {
             mTableCards.addAttackCard(*it);
         }
-
-        std::vector<Card> defendCards;
-        reader.read(defendCards, defaultCard);
-        for (std::vector<Card>::iterator it = defendCards.begin(); it != defendCards.end(); ++it) {
+        for (std::vector<Card>::const_iterator it = saved.mDefendCards.begin(); it != saved.mDefendCards.end(); ++it) {
             mTableCards.addDefendCard(*it);
         }
-        reader.read(mMaxAttackCards);
-        reader.read(mDefendFailed);
-        mPickAttackCardFromTable = !mDefendFailed && attackCards.size() == defendCards.size() + 1;
+        mMaxAttackCards = saved.mMaxAttackCards;
+        mDefendFailed = saved.mDefendFailed;
+        mPickAttackCardFromTable = !mDefendFailed && saved.mAttackCards.size() == saved.mDefendCards.size() + 1;
     }
 
+    restored(observers);
+
+    // initialize observers
+    for (unsigned int i = 0; i < mGameObservers.size(); ++i) {
+        mGameObservers[i]->init(observersData[i]);
+        assert(observersData[i].position() == observersData[i].size());
+    }
+    return true;
+}
+
+void Engine::clone(const Engine& source, const std::vector<Player*>& players, const std::vector<GameObserver*>& observers)
+{
+    // check that engine is not initialized yet
+    assert(!mPlayerIdCounter);
+    assert(mGeneratedIds.empty());
+    assert(mPlayers.empty());
+    assert(!mDeck);
+    assert(mGameObservers.empty());
+
+    assert(source.mDeck);
+    assert(players.size() == source.mGeneratedIds.size());
+    // add players
+    for (std::vector<Player*>::const_iterator it = players.begin(); it != players.end(); ++it) {
+        add(**it);
+    }
+
+    source.lock();
+    // source's ids are mapped to ours by index
+    mPlayersCards = source.mPlayersCards;
+    mSeatsWithCards = source.mSeatsWithCards;
+    mDeck = new Deck(*source.mDeck);
+    mCurrentPlayer = mGeneratedIds[source.mGeneratedIds.index(source.mCurrentPlayer)];
+    mRoundIndex = source.mRoundIndex;
+
+    if (source.mCurrentRoundIndex) {
+        mCurrentRoundIndex = &mRoundIndex;
+        for (std::vector<const PlayerId*>::const_iterator it = source.mAttackers.begin(); it != source.mAttackers.end(); ++it) {
+            mAttackers.push_back(mGeneratedIds[source.mGeneratedIds.index(*it)]);
+        }
+        mAttackerSeats = source.mAttackerSeats;
+        mDefender = mGeneratedIds[source.mGeneratedIds.index(source.mDefender)];
+        mPassedCounter = source.mPassedCounter;
+        if (source.mCurrentRoundAttackerId) {
+            mCurrentRoundAttackerId = mGeneratedIds[source.mGeneratedIds.index(source.mCurrentRoundAttackerId)];
+        }
+        mTableCards = source.mTableCards;
+        mMaxAttackCards = source.mMaxAttackCards;
+        mDefendFailed = source.mDefendFailed;
+        // source could be waiting for the defender - the clone asks the defender to beat the same card
+        mPickAttackCardFromTable = !mDefendFailed && mTableCards.attackCards().size() == mTableCards.defendCards().size() + 1;
+    }
+    source.unlock();
+
+    for (std::vector<const PlayerId*>::const_iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
+        mPlayers[(*it)->seat()]->cardsRestored(mPlayersCards[(*it)->seat()]);
+    }
+
+    notifyGameStarted();
+
+    restored(observers);
+}
+
+void Engine::setJournal(Journal* journal, unsigned int snapshotRounds)
+{
+    assert(snapshotRounds);
+    mJournal = journal;
+    mSnapshotRounds = snapshotRounds;
+    mSnapshotPending = true;
+}
+
+bool Engine::replay(DataReader& reader, unsigned int records)
+{
+    mReplay.resize(records);
+    for (std::vector<JournalRecord>::iterator it = mReplay.begin(); it != mReplay.end(); ++it) {
+        reader.read(*it);
+    }
+    mReplayPosition = 0;
+    mReplayFailed = false;
+    // the records follow the snapshot the game is restored from
+    mSnapshotPending = false;
+
+    Decision decision;
+    // each decision record is reproduced by the next step() after submit()
+    while (!mReplayFailed && mReplayPosition < mReplay.size() && step(decision) && mReplayPosition < mReplay.size()) {
+        const JournalRecord& record = mReplay[mReplayPosition];
+        if (JOURNAL_DECISION != record.type
+            || record.seat != decision.player->seat()
+            || record.action != decision.type
+            || (JournalRecord::NO_CARD != record.card && record.card >= Card::INVALID_INDEX)) {
+            mReplayFailed = true;
+            break;
+        }
+        submit(JournalRecord::NO_CARD == record.card ? NULL : &Card::interned(record.card));
+    }
+
+    bool replayed = !mReplayFailed && mReplayPosition == mReplay.size();
+    mReplay.clear();
+    mReplayPosition = 0;
+    return replayed;
+}
+
+void Engine::restored(const std::vector<GameObserver*>& observers)
+{
     // append observers
     mGameObservers.insert(mGameObservers.end(), observers.begin(), observers.end());
 
     std::map<const PlayerId*, unsigned int> playersCards;
     for (PlayerIds::const_iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
-        playersCards[*it] = mPlayersCards[*it].size();
+        playersCards[*it] = mPlayersCards[(*it)->seat()].size();
     }
     std::for_each(mGameObservers.begin(), mGameObservers.end(), GameRestoredNotification(mGeneratedIds, playersCards, mDeck->size(), mDeck->trumpSuit(), mTableCards));
-
-    // initialize observers
-    unsigned int savedObservers;
-    reader.read(savedObservers);
-    assert(savedObservers == mGameObservers.size());
-    for (std::vector<GameObserver*>::iterator it = mGameObservers.begin(); it != mGameObservers.end(); ++it) {
-        unsigned int observerDataStart = reader.position();
-        (*it)->init(reader);
-        unsigned int actualObserverDataSize = reader.position() - observerDataStart;
-        unsigned int expectedObserverDataSize;
-        reader.read(expectedObserverDataSize);
-        assert(actualObserverDataSize == expectedObserverDataSize);
-    }
+    postGameEvents(EVENT_GAME_RESTORED, CardSet());
+    publish();
 }
 
 void Engine::quit()
@@ -365,8 +724,104 @@ void Engine::quit()
     }
 }
 
-Engine::PlayerIdImplementation::PlayerIdImplementation(unsigned int id)
-    : mId(id)
+bool Engine::exportState(sim::GameState& state) const
+{
+    lock();
+
+    // the round is started and the cards are dealt
+    if (!mCurrentRoundIndex || !mCurrentRoundAttackerId || mGeneratedIds.size() > sim::MAX_PLAYERS) {
+        unlock();
+        return false;
+    }
+
+    state.players = mGeneratedIds.size();
+    for (unsigned int i = 0; i < mGeneratedIds.size(); ++i) {
+        state.hands[i] = mPlayersCards[i].mask();
+    }
+    for (unsigned int i = mGeneratedIds.size(); i < sim::MAX_PLAYERS; ++i) {
+        state.hands[i] = 0;
+    }
+
+    assert(mDeck->size() <= CardSet::CARDS);
+    state.deckSize = mDeck->size();
+    state.deckTop = 0;
+    for (unsigned int i = 0; i < mDeck->size(); ++i) {
+        state.deck[i] = (*mDeck)[i].index();
+    }
+    state.trumpSuit = mDeck->trumpSuit();
+
+    state.currentPlayer = mGeneratedIds.index(mCurrentPlayer);
+    state.defender = mGeneratedIds.index(mDefender);
+    state.attackersAmount = mAttackers.size();
+    for (unsigned int i = 0; i < mAttackers.size(); ++i) {
+        state.attackers[i] = mGeneratedIds.index(mAttackers[i]);
+    }
+    state.attacker = mGeneratedIds.index(mCurrentRoundAttackerId);
+    state.passed = mPassedCounter;
+    state.maxAttackCards = mMaxAttackCards;
+
+    const std::vector<Card>& attackCards = mTableCards.attackCards();
+    const std::vector<Card>& defendCards = mTableCards.defendCards();
+    state.attackCardsAmount = attackCards.size();
+    state.defendCardsAmount = defendCards.size();
+    for (unsigned int i = 0; i < attackCards.size(); ++i) {
+        state.attackCards[i] = attackCards[i].index();
+    }
+    for (unsigned int i = 0; i < defendCards.size(); ++i) {
+        state.defendCards[i] = defendCards[i].index();
+    }
+    state.table = mTableCards.all().mask();
+    state.tableRanks = mTableCards.ranks();
+    state.defendFailed = mDefendFailed;
+    state.roundIndex = mRoundIndex;
+    // not beaten attack card - the defender moves
+    state.phase = !mDefendFailed && attackCards.size() > defendCards.size() ? sim::PHASE_DEFEND : sim::PHASE_ATTACK;
+
+    unlock();
+    return true;
+}
+
+/**
+ * @brief Returns amount of memory allocated by the vector
+ */
+template <typename T>
+static size_t capacityBytes(const std::vector<T>& vector)
+{
+    return vector.capacity() * sizeof(T);
+}
+
+void Engine::spectatorState(SpectatorState& state) const
+{
+    if (mThreadSafe) {
+        mSpectatorState.load(state);
+    } else {
+        fillSpectatorState(state);
+    }
+}
+
+size_t Engine::memoryUsage() const
+{
+    size_t res = sizeof(*this)
+        + capacityBytes(mGeneratedIds) + mGeneratedIds.size() * sizeof(PlayerIdImplementation)
+        + capacityBytes(mPlayers)
+        + capacityBytes(mPlayersCards)
+        + capacityBytes(mGameObservers)
+        + capacityBytes(mEventObservers)
+        + capacityBytes(mEvents)
+        + capacityBytes(mAttackers)
+        + capacityBytes(mTableCards.attackCards())
+        + capacityBytes(mTableCards.defendCards())
+        + capacityBytes(mReplay)
+        + capacityBytes(mDealCards)
+        + capacityBytes(mDealCardsAmount);
+    if (mDeck) {
+        res += sizeof(*mDeck) + mDeck->capacity() * sizeof(Card);
+    }
+    return res;
+}
+
+Engine::PlayerIdImplementation::PlayerIdImplementation(unsigned int seat)
+    : PlayerId(seat)
 {}
 
 Engine::GameStartNotification::GameStartNotification(const Suit &trumpSuit, const std::vector<const PlayerId *> &players, const CardSet &gameCards)
@@ -404,16 +859,23 @@ void Engine::RoundEndNotification::operator()(GameObserver *observer)
     observer->roundEnded(mRoundIndex);
 }
 
+Engine::TableCards::TableCards()
+    : mRanks(0)
+{
+}
+
 void Engine::TableCards::addAttackCard(const Card& card)
 {
     mAttackCards.push_back(card);
     mAll.insert(card);
+    mRanks |= 1 << card.rank();
 }
 
 void Engine::TableCards::addDefendCard(const Card& card)
 {
     mDefendCards.push_back(card);
     mAll.insert(card);
+    mRanks |= 1 << card.rank();
 }
 
 const CardSet& Engine::TableCards::all() const
@@ -421,6 +883,11 @@ const CardSet& Engine::TableCards::all() const
     return mAll;
 }
 
+unsigned int Engine::TableCards::ranks() const
+{
+    return mRanks;
+}
+
 bool Engine::TableCards::empty() const
 {
     return mAll.empty();
@@ -441,158 +908,257 @@ void Engine::TableCards::clear()
     mAttackCards.clear();
     mDefendCards.clear();
     mAll.clear();
+    mRanks = 0;
 }
 
-bool Engine::playCurrentRound()
+Engine::Progress Engine::advance()
 {
-#define CHECK_QUIT \
-if (mQuit.get()) { \
-    return false; \
-}
+    if (!mDeck) {
+        // no cards set
+        return PROGRESS_GAME_ENDED;
+    }
 
-    lock();
-    if (!mCurrentRoundIndex) {
-        mCurrentRoundIndex = &mRoundIndex;
-        // prepare round data
-        // pick current player as first attacker
-        mAttackers.push_back(mCurrentPlayer);
-        // if there was no deal yet (very first round) - do not consider cards while picking next players
-        std::map<const PlayerId*, CardSet>* cards = *mCurrentRoundIndex ? &mPlayersCards : NULL;
-        // pick next player as defender
-        mDefender = Rules::pickNext(mGeneratedIds, mCurrentPlayer, cards);
-        // gather rest players as additional attackers
-        const PlayerId* attacker = mDefender;
-        while((attacker = Rules::pickNext(mGeneratedIds, attacker, cards)) != mCurrentPlayer) {
-            if (attacker) {
-                mAttackers.push_back(attacker);
-            }
+    if (mGeneratedIds.size() < 2) {
+        // too few players - at least two should be set
+        return PROGRESS_GAME_ENDED;
+    }
+
+    if (DECISION_NONE != mDecision.type) {
+        if (!mAnswered) {
+            return PROGRESS_DECISION;
         }
-        unlock();
-        std::for_each(mGameObservers.begin(), mGameObservers.end(), RoundStartNotification(mAttackers, mDefender, mRoundIndex));
-        // deal cards
-        dealCards();
-        lock();
-        mMaxAttackCards = Rules::maxAttackCards(mPlayersCards[mDefender].size());
-        assert(mMaxAttackCards);
+        const DecisionType type = mDecision.type;
+        mDecision.type = DECISION_NONE;
+        mAnswered = false;
+        // check if quit requested and only after that transfer move to the next player
+        if (mQuit.get()) {
+            return PROGRESS_GAME_ENDED;
+        }
+        if (DECISION_DEFEND == type) {
+            playDefendCard(mAnswer);
+        } else if (!playAttackCard(mAnswer, DECISION_PITCH == type)) {
+            return endRound();
+        }
+        if (mQuit.get()) {
+            return PROGRESS_GAME_ENDED;
+        }
+    } else if (!mCurrentRoundIndex) {
+        if (gameEnded()) {
+            return PROGRESS_GAME_ENDED;
+        }
+        if (mJournal && mReplayPosition == mReplay.size() && (mSnapshotPending || !(mRoundIndex % mSnapshotRounds))) {
+            // between the rounds: the records so far are not needed after the snapshot
+            mSnapshotPending = false;
+            mJournal->snapshot(*this);
+        }
+        startRound();
     }
 
-    CardSet& defenderCards = mPlayersCards[mDefender];
+    if (mQuit.get()) {
+        return PROGRESS_GAME_ENDED;
+    }
 
+    lock();
     if (!mCurrentRoundAttackerId) {
         mCurrentRoundAttackerId = mAttackers[0];
         mPassedCounter = 0;
     }
-
-    Player& defender = *mPlayers[mDefender];
-
     unlock();
 
     for (;;) {
 
+        if (mPickAttackCardFromTable) {
+            // the defender beats the last attack card
+            assert(!mTableCards.attackCards().empty());
+            mDecision.type = DECISION_DEFEND;
+            mDecision.player = mDefender;
+            mDecision.opponent = mCurrentRoundAttackerId;
+            mDecision.attackCard = mTableCards.attackCards().back();
+            Rules::getDefendCards(mDecision.attackCard, mPlayersCards[mDefender->seat()], mDeck->trumpSuit(), mDecision.cards);
+            flushEvents();
+            publish();
+            return PROGRESS_DECISION;
+        }
+
         if (mTableCards.attackCards().size() == mMaxAttackCards) {
             // defender has no more cards - defend succeeded
             break;
         }
 
-        const Card* attackCardPtr;
+        CardSet& attackCards = mDecision.cards;
+        Rules::getAttackCards(mTableCards.ranks(), mPlayersCards[mCurrentRoundAttackerId->seat()], attackCards);
 
-        if (mPickAttackCardFromTable) {
-            assert(!mTableCards.attackCards().empty());
-            attackCardPtr = &*(mTableCards.attackCards().end() - 1);
-        } else {
-            CardSet attackCards = Rules::getAttackCards(mTableCards.all(), mPlayersCards[mCurrentRoundAttackerId]);
+        if (mTableCards.empty() && attackCards.empty()) {
+            // nothing to attack with - the attacker passes
+            if (!pass()) {
+                break;
+            }
+            continue;
+        }
 
-            Player& currentAttacker = *mPlayers[mCurrentRoundAttackerId];
+        // ask for pitch even with empty attackCards - expected NULL attack card pointer
+        mDecision.type = mTableCards.empty() ? DECISION_ATTACK : DECISION_PITCH;
+        mDecision.player = mCurrentRoundAttackerId;
+        mDecision.opponent = mDefender;
+        flushEvents();
+        publish();
+        return PROGRESS_DECISION;
+    }
 
-            if (mTableCards.empty()) {
-                attackCardPtr = attackCards.empty() ? NULL : &currentAttacker.attack(mDefender, attackCards);
-            } else {
-                // ask for pitch even with empty attackCards - expected NULL attack card pointer
-                attackCardPtr = currentAttacker.pitch(mDefender, attackCards);
-            }
+    return endRound();
+}
 
-            // check if quit requested and only after that transfer move to defender
-            CHECK_QUIT;
-
-            if (attackCards.empty() || !attackCardPtr) {
-                lock();
-                // player skipped the move - pick next attacker
-                mCurrentRoundAttackerId = Rules::pickNext(mAttackers, mCurrentRoundAttackerId, &mPlayersCards);
-                // if more than one attacker and we have first attacker again - reset pass counter
-                if (mAttackers.size() > 1 && mCurrentRoundAttackerId == mAttackers[0]) {
-                    mPassedCounter = 0;
-                }
-                mPassedCounter++;
-                unlock();
-
-                if (mPassedCounter == mAttackers.size()) {
-                    // all attackers "passed" - round ended
-                    break;
-                }
-                continue;
-            }
+void Engine::startRound()
+{
+    lock();
+    mCurrentRoundIndex = &mRoundIndex;
+    // prepare round data
+    // pick current player as first attacker
+    mAttackers.push_back(mCurrentPlayer);
+    const unsigned int currentPlayer = mCurrentPlayer->seat();
+    mAttackerSeats = static_cast<Rules::Seats>(1) << currentPlayer;
+    // if there was no deal yet (very first round) - do not consider cards while picking next players
+    const Rules::Seats allSeats = Rules::allSeats(mGeneratedIds.size());
+    const Rules::Seats seats = *mCurrentRoundIndex ? mSeatsWithCards : allSeats;
+    // pick next player as defender
+    unsigned int defender = Rules::nextSeat(seats, currentPlayer);
+    if (PlayerId::NO_SEAT == defender) {
+        // the rest players have no cards, but the deck has - the defender gets the cards in the deal
+        defender = Rules::nextSeat(allSeats, currentPlayer);
+    }
+    mDefender = mGeneratedIds[defender];
+    // gather rest players as additional attackers
+    // note: current player could have no cards (it gets the cards in the deal), so it could be skipped by nextSeat()
+    unsigned int attacker = defender;
+    while((attacker = Rules::nextSeat(seats, attacker)) != PlayerId::NO_SEAT && attacker != currentPlayer && attacker != defender) {
+        mAttackers.push_back(mGeneratedIds[attacker]);
+        mAttackerSeats |= static_cast<Rules::Seats>(1) << attacker;
+    }
+    mCurrentRoundAttackerId = mAttackers[0];
+    mPassedCounter = 0;
+    unlock();
+    std::for_each(mGameObservers.begin(), mGameObservers.end(), RoundStartNotification(mAttackers, mDefender, mRoundIndex));
+    post(EVENT_ROUND_STARTED, mDefender, mRoundIndex, 0);
+    for (std::vector<const PlayerId*>::const_iterator it = mAttackers.begin(); it != mAttackers.end(); ++it) {
+        post(EVENT_ATTACKER, *it, 0, 0);
+    }
+    // deal cards
+    dealCards();
+    lock();
+    // could be 0 if the deck was empty before the defender's turn in the deal - the round ends immediately
+    mMaxAttackCards = Rules::maxAttackCards(mPlayersCards[mDefender->seat()].size());
+    unlock();
+}
 
-            assert(attackCardPtr);
+bool Engine::playAttackCard(const Card* attackCardPtr, bool canPass)
+{
+    const CardSet& attackCards = mDecision.cards;
 
-            if(!findByPtr(attackCards, attackCardPtr)) {
-                // invalid card returned - the card is not from attackCards
-                assert(!attackCards.empty());
-                // take any card
-                attackCardPtr = &*attackCards.begin();
-            }
+    if (attackCards.empty() || (!attackCardPtr && canPass)) {
+        // player skipped the move - pick next attacker
+        journal(JOURNAL_DECISION, mCurrentRoundAttackerId->seat(), canPass ? DECISION_PITCH : DECISION_ATTACK, JournalRecord::NO_CARD);
+        return pass();
+    }
 
-            Card attackCard = *attackCardPtr;
+    if(!attackCards.contains(attackCardPtr)) {
+        // invalid card returned - the card is not from attackCards
+        // take any card
+        attackCardPtr = &*attackCards.begin();
+    }
 
-            lock();
-            mTableCards.addAttackCard(attackCard);
-            mPlayersCards[mCurrentRoundAttackerId].erase(attackCard);
-            unlock();
-            CHECK_QUIT;
-            std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsDroppedNotification(mCurrentRoundAttackerId, attackCard));
-            // the card is removed from the `attackCards` and is added to `mTableCards`, so update its pointer
-            attackCardPtr = &*std::find(mTableCards.attackCards().begin(), mTableCards.attackCards().end(), attackCard);
-        }
+    Card attackCard = *attackCardPtr;
+    journal(JOURNAL_DECISION, mCurrentRoundAttackerId->seat(), canPass ? DECISION_PITCH : DECISION_ATTACK, attackCard.index());
 
-        if (mDefendFailed) {
-            continue;
-        }
+    lock();
+    mTableCards.addAttackCard(attackCard);
+    mPlayersCards[mCurrentRoundAttackerId->seat()].erase(attackCard);
+    updateSeat(mCurrentRoundAttackerId->seat());
+    // the defender beats the card next, unless picks up the cards anyway
+    mPickAttackCardFromTable = !mDefendFailed;
+    unlock();
+    if (mQuit.get()) {
+        return true;
+    }
+    std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsDroppedNotification(mCurrentRoundAttackerId, attackCard));
+    post(EVENT_CARDS_DROPPED, mCurrentRoundAttackerId, 0, CardSet::cardMask(attackCard));
+    return true;
+}
 
-        CardSet defendCards = Rules::getDefendCards(*attackCardPtr, defenderCards, mDeck->trumpSuit());
+void Engine::playDefendCard(const Card* defendCardPtr)
+{
+    const CardSet& defendCards = mDecision.cards;
 
-        const Card* defendCardPtr = defender.defend(mCurrentRoundAttackerId, *attackCardPtr, defendCards);
+    bool noCardsToDefend = defendCards.empty();
+    bool userGrabbedCards = !defendCardPtr;
+    bool invalidDefendCard = !defendCards.contains(defendCardPtr);
 
-        bool noCardsToDefend = defendCards.empty();
-        bool userGrabbedCards = !defendCardPtr;
-        bool invalidDefendCard = !findByPtr(defendCards, defendCardPtr);
+    lock();
+    mPickAttackCardFromTable = false;
+    unlock();
 
+    if(noCardsToDefend || userGrabbedCards || invalidDefendCard) {
+        // defend failed
+        journal(JOURNAL_DECISION, mDefender->seat(), DECISION_DEFEND, JournalRecord::NO_CARD);
         lock();
-        mPickAttackCardFromTable = false;
+        mDefendFailed = true;
         unlock();
-
-        if(noCardsToDefend || userGrabbedCards || invalidDefendCard) {
-            // defend failed
-            lock();
-            mDefendFailed = true;
-            unlock();
-        } else {
-            lock();
-            mTableCards.addDefendCard(*defendCardPtr);
-            defenderCards.erase(*defendCardPtr);
-            unlock();
-            CHECK_QUIT;
-            std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsDroppedNotification(mDefender, *defendCardPtr));
+    } else {
+        journal(JOURNAL_DECISION, mDefender->seat(), DECISION_DEFEND, defendCardPtr->index());
+        lock();
+        mTableCards.addDefendCard(*defendCardPtr);
+        mPlayersCards[mDefender->seat()].erase(*defendCardPtr);
+        updateSeat(mDefender->seat());
+        unlock();
+        if (mQuit.get()) {
+            return;
         }
+        std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsDroppedNotification(mDefender, *defendCardPtr));
+        post(EVENT_CARDS_DROPPED, mDefender, 0, CardSet::cardMask(*defendCardPtr));
     }
+}
+
+bool Engine::pass()
+{
+    lock();
+    const unsigned int passed = mCurrentRoundAttackerId->seat();
+    unsigned int attacker = Rules::nextSeat(mAttackerSeats & mSeatsWithCards, passed);
+    mCurrentRoundAttackerId = PlayerId::NO_SEAT == attacker ? NULL : mGeneratedIds[attacker];
+    // if more than one attacker and we have first attacker with cards again - reset pass counter
+    if (mAttackers.size() > 1 && mCurrentRoundAttackerId == firstAttackerWithCards()) {
+        mPassedCounter = 0;
+    }
+    // attacker without cards could not pitch anyway - only the passes of the attackers with cards are counted
+    if (mSeatsWithCards & static_cast<Rules::Seats>(1) << passed) {
+        mPassedCounter++;
+    }
+    unlock();
+
+    // attackers without cards are skipped by nextSeat()
+    // all attackers with cards "passed" - round ended
+    return mCurrentRoundAttackerId && mPassedCounter < attackersWithCards();
+}
+
+Engine::Progress Engine::endRound()
+{
+#define CHECK_QUIT \
+if (mQuit.get()) { \
+    return PROGRESS_GAME_ENDED; \
+}
+
+    CardSet& defenderCards = mPlayersCards[mDefender->seat()];
 
     if (mDefendFailed) {
         lock();
-        defenderCards.insert(mTableCards.all().begin(), mTableCards.all().end());
-        defender.cardsUpdated(defenderCards);
+        defenderCards.addAll(mTableCards.all());
+        updateSeat(mDefender->seat());
+        mPlayers[mDefender->seat()]->cardsUpdated(defenderCards);
         unlock();
         CHECK_QUIT;
         std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsReceivedNotification(mDefender, mTableCards.all()));
+        post(EVENT_CARDS_PICKED_UP, mDefender, 0, mTableCards.all().mask());
     } else {
         std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsGoneNotification(mTableCards.all()));
+        post(EVENT_CARDS_GONE, NULL, 0, mTableCards.all().mask());
     }
 
     // cleanup
@@ -604,39 +1170,161 @@ if (mQuit.get()) { \
     CHECK_QUIT;
 
     std::for_each(mGameObservers.begin(), mGameObservers.end(), RoundEndNotification(mRoundIndex));
+    post(EVENT_ROUND_ENDED, NULL, mRoundIndex, 0);
+    flushEvents();
+
+    lock();
+    bool defended = !mDefendFailed;
+    mDefendFailed = false;
+    mRoundIndex++;
+
+    // if attack failed "next move" goes to defender
+    // or to next player after the defender otherwise
+    unsigned int currentPlayer = mDefender->seat();
+    if (!defended) {
+        currentPlayer = Rules::nextSeat(mSeatsWithCards, mDefender->seat());
+        if (PlayerId::NO_SEAT == currentPlayer) {
+            // the rest players have no cards, but the deck has - they get the cards in the next deal
+            currentPlayer = Rules::nextSeat(Rules::allSeats(mGeneratedIds.size()), mDefender->seat());
+        }
+    }
+    mCurrentPlayer = mGeneratedIds[currentPlayer];
+
+    // cleanup
+    mAttackers.clear();
+    mAttackerSeats = 0;
+    mDefender = NULL;
+    mTableCards.clear();
+
+    unlock();
+
+    publish();
+
+    return gameEnded() ? PROGRESS_GAME_ENDED : PROGRESS_ROUND_ENDED;
+#undef CHECK_QUIT
+}
 
-    return !mDefendFailed;
+unsigned int Engine::attackersWithCards() const
+{
+    return bitCount(mAttackerSeats & mSeatsWithCards);
+}
+
+const PlayerId* Engine::firstAttackerWithCards() const
+{
+    for (std::vector<const PlayerId*>::const_iterator it = mAttackers.begin(); it != mAttackers.end(); ++it) {
+        if (mSeatsWithCards & static_cast<Rules::Seats>(1) << (*it)->seat()) {
+            return *it;
+        }
+    }
+    return NULL;
+}
+
+void Engine::updateSeat(unsigned int seat)
+{
+    const Rules::Seats bit = static_cast<Rules::Seats>(1) << seat;
+    if (mPlayersCards[seat].empty()) {
+        mSeatsWithCards &= ~bit;
+    } else {
+        mSeatsWithCards |= bit;
+    }
 }
 
 void Engine::dealCards()
 {
     // deal order:
     // from current attacker
-    std::map<const PlayerId*, unsigned int> oldCardsAmount;
-    std::vector<CardSet*> cards;
+    mDealCards.clear();
 
-    const PlayerId* currentPlayer = mCurrentPlayer;
+    const unsigned int currentPlayer = mCurrentPlayer->seat();
+    for (unsigned int i = 0; i < mPlayersCards.size(); ++i) {
+        mDealCards.push_back(&mPlayersCards[(currentPlayer + i) % mPlayersCards.size()]);
+    }
 
-    do {
-        cards.push_back(&mPlayersCards[currentPlayer]);
-        oldCardsAmount[currentPlayer] = mPlayersCards[currentPlayer].size();
-        currentPlayer = Rules::pickNext(mGeneratedIds, currentPlayer);
-    } while (currentPlayer != mCurrentPlayer);
+    mDealCardsAmount.clear();
+    for (PlayerIds::const_iterator it = mGeneratedIds.begin(); it != mGeneratedIds.end(); ++it) {
+        mDealCardsAmount.push_back(mPlayersCards[(*it)->seat()].size());
+    }
 
     lock();
-    Rules::deal(*mDeck, cards);
+    Rules::deal(*mDeck, mDealCards);
+    for (unsigned int i = 0; i < mPlayersCards.size(); ++i) {
+        updateSeat(i);
+    }
     unlock();
 
-    for(std::map<const PlayerId*, unsigned int>::iterator it = oldCardsAmount.begin(); it != oldCardsAmount.end(); ++it) {
-        const PlayerId* id = it->first;
-        unsigned int cardsReceived = mPlayersCards[id].size() - it->second;
+    for (unsigned int i = 0; i < mGeneratedIds.size(); ++i) {
+        const PlayerId* id = mGeneratedIds[i];
+        unsigned int cardsReceived = mPlayersCards[i].size() - mDealCardsAmount[i];
         if (cardsReceived) {
-            mPlayers[id]->cardsUpdated(mPlayersCards[id]);
+            journal(JOURNAL_DEAL, i, DECISION_NONE, cardsReceived);
+            mPlayers[i]->cardsUpdated(mPlayersCards[i]);
             std::for_each(mGameObservers.begin(), mGameObservers.end(), CardsAmountReceivedNotification(id, cardsReceived));
+            post(EVENT_CARDS_DEALT, id, cardsReceived, 0);
         }
     }
 }
 
+void Engine::publish()
+{
+    mSpectatorVersion++;
+    if (!mThreadSafe) {
+        // built on request
+        return;
+    }
+    SpectatorState state;
+    fillSpectatorState(state);
+    mSpectatorState.store(state);
+}
+
+void Engine::fillSpectatorState(SpectatorState& state) const
+{
+    memset(&state, 0, sizeof(state));
+    state.version = mSpectatorVersion;
+    state.players = mPlayersCards.size();
+    for (unsigned int i = 0; i < mPlayersCards.size(); ++i) {
+        state.playersCards[i] = mPlayersCards[i].size();
+    }
+    state.deckCards = mDeck ? mDeck->size() : 0;
+    state.trumpSuit = mDeck ? mDeck->trumpSuit() : SUIT_LAST;
+    state.roundIndex = mRoundIndex;
+    state.attacker = mCurrentRoundIndex && mCurrentRoundAttackerId ? mCurrentRoundAttackerId->seat() : PlayerId::NO_SEAT;
+    state.defender = mCurrentRoundIndex && mDefender ? mDefender->seat() : PlayerId::NO_SEAT;
+    if (mCurrentRoundIndex) {
+        const std::vector<Card>& attackCards = mTableCards.attackCards();
+        const std::vector<Card>& defendCards = mTableCards.defendCards();
+        assert(attackCards.size() <= SpectatorState::MAX_TABLE_CARDS);
+        state.attackCardsAmount = attackCards.size();
+        for (unsigned int i = 0; i < attackCards.size(); ++i) {
+            state.attackCards[i] = attackCards[i].index();
+        }
+        state.defendCardsAmount = defendCards.size();
+        for (unsigned int i = 0; i < defendCards.size(); ++i) {
+            state.defendCards[i] = defendCards[i].index();
+        }
+    }
+    state.ended = mDeck && gameEnded();
+}
+
+void Engine::journal(JournalRecordType type, unsigned int seat, DecisionType action, unsigned int card)
+{
+    JournalRecord record;
+    record.type = type;
+    record.seat = seat;
+    record.action = action;
+    record.card = card;
+    if (mReplayPosition < mReplay.size()) {
+        // replay is running: the game should reproduce the recorded move
+        const JournalRecord& expected = mReplay[mReplayPosition++];
+        if (expected.type != record.type || expected.seat != record.seat || expected.action != record.action || expected.card != record.card) {
+            mReplayFailed = true;
+        }
+        return;
+    }
+    if (mJournal) {
+        mJournal->records().write(record);
+    }
+}
+
 Engine::CardsAmountReceivedNotification::CardsAmountReceivedNotification(const PlayerId *playerId, unsigned int cardsReceived)
     : mPlayerId(playerId)
     , mCardsReceived(cardsReceived)
@@ -2,6 +2,7 @@
 #include <cassert>
 
 #include "gameCardsTracker.h"
+#include "saveFormat.h"
 
 namespace decore
 {
@@ -19,23 +20,19 @@ void PlayerCards::addUnknownCards(unsigned int cardsAmount)
 
 void PlayerCards::addCards(const CardSet& cards)
 {
-    for(CardSet::const_iterator it = cards.begin(); it != cards.end(); ++it) {
-        bool inserted = mKnownCards.insert(*it).second;
-        assert(inserted);
-    }
+    bool inserted = mKnownCards.addAll(cards);
+    assert(inserted);
+    (void) inserted;
 }
 
 void PlayerCards::removeCards(const CardSet& cards)
 {
-    for(CardSet::const_iterator it = cards.begin(); it != cards.end(); ++it) {
-        if (mKnownCards.find(*it) != mKnownCards.end()) {
-            bool erased = mKnownCards.erase(*it);
-            assert(erased);
-        } else {
-            assert(mUnknownCards);
-            mUnknownCards--;
-        }
-    }
+    // known cards removed first, the rest are unknown
+    CardSet unknownCards(cards);
+    unknownCards.removeAll(mKnownCards);
+    mKnownCards.removeAll(cards);
+    assert(mUnknownCards >= unknownCards.size());
+    mUnknownCards -= unknownCards.size();
 }
 
 bool PlayerCards::empty() const
@@ -61,6 +58,7 @@ const CardSet& PlayerCards::knownCards() const
 GameCardsTracker::GameCardsTracker()
     : mDefender(NULL)
     , mLastRoundIndex(0)
+    , mSnapshotTaken(false)
 {
 
 }
@@ -71,12 +69,10 @@ void GameCardsTracker::gameStarted(const Suit &trumpSuit, const CardSet &cardSet
     mTrumpSuit = trumpSuit;
     mDeckCardsNumber = cardSet.size();
     mPlayerIds.insert(mPlayerIds.begin(), players.begin(), players.end());
-    for(std::vector<const PlayerId*>::const_iterator it = players.begin(); it != players.end(); ++it) {
-        mPlayersCards[*it] = PlayerCards();
-    }
+    mPlayersCards.resize(mPlayerIds.size());
 }
 
-void GameCardsTracker::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*> attackers, const PlayerId* defender)
+void GameCardsTracker::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender)
 {
     mAttackers = attackers;
     mDefender = defender;
@@ -95,8 +91,7 @@ void GameCardsTracker::roundEnded(unsigned int roundIndex)
 
 void GameCardsTracker::cardsPickedUp(const PlayerId* playerId, const CardSet &cards)
 {
-    assert(mPlayersCards.find(playerId) != mPlayersCards.end());
-    mPlayersCards[playerId].addCards(cards);
+    mPlayersCards[mPlayerIds.index(playerId)].addCards(cards);
     // the cardSet is picked up from table cards
     // ensure that proper cards removed
     assert(cards.size() == mAttackCards.size() + mDefendCards.size());
@@ -111,13 +106,14 @@ void GameCardsTracker::cardsPickedUp(const PlayerId* playerId, const CardSet &ca
 void GameCardsTracker::cardsDealed(const PlayerId* playerId, unsigned int cardsAmount)
 {
     mDeckCardsNumber -= cardsAmount;
-    assert(mPlayersCards.find(playerId) != mPlayersCards.end());
-    mPlayersCards[playerId].addUnknownCards(cardsAmount);
+    mPlayersCards[mPlayerIds.index(playerId)].addUnknownCards(cardsAmount);
 }
 
 void GameCardsTracker::cardsGone(const CardSet &cardSet)
 {
-    std::for_each(cardSet.begin(), cardSet.end(), CardRemover(mGameCards));
+    // all the cards should be in game
+    assert(CardSet(mGameCards.mask() & cardSet.mask()) == cardSet);
+    mGameCards.removeAll(cardSet);
     // the cardSet is left from table cards
     // ensure that proper cards removed
     assert(cardSet.size() == mAttackCards.size() + mDefendCards.size());
@@ -127,13 +123,12 @@ void GameCardsTracker::cardsGone(const CardSet &cardSet)
                 || std::find(mDefendCards.begin(), mDefendCards.end(), *it) != mDefendCards.end());
     }
 #endif // NDEBUG
-    mGoneCards.insert(cardSet.begin(), cardSet.end());
+    mGoneCards.addAll(cardSet);
 }
 
 void GameCardsTracker::cardsDropped(const PlayerId* playerId, const CardSet &cards)
 {
-    assert(mPlayersCards.find(playerId) != mPlayersCards.end());
-    mPlayersCards[playerId].removeCards(cards);
+    mPlayersCards[mPlayerIds.index(playerId)].removeCards(cards);
     std::vector<Card> * dst;
     if (playerId == mDefender) {
         dst = &mDefendCards;
@@ -143,58 +138,79 @@ void GameCardsTracker::cardsDropped(const PlayerId* playerId, const CardSet &car
     dst->insert(dst->end(), cards.begin(), cards.end());
 }
 
-void GameCardsTracker::save(DataWriter& writer)
+void GameCardsTracker::copyState(SavedState& state) const
 {
-    writer.write(mGameCards.begin(), mGameCards.end());
-    writer.write(mTrumpSuit);
+    state.mGameCards = mGameCards;
+    state.mTrumpSuit = mTrumpSuit;
+    state.mPlayersCards = mPlayersCards;
+    state.mGoneCards = mGoneCards;
+    state.mLastRoundIndex = mLastRoundIndex;
+    state.mAttackCards = mAttackCards;
+    state.mDefendCards = mDefendCards;
+}
 
-    unsigned int playersCount = mPlayersCards.size();
-    writer.write(playersCount);
-    for (std::map<const PlayerId*, PlayerCards>::iterator it = mPlayersCards.begin(); it != mPlayersCards.end(); ++it) {
-        writer.write(mPlayerIds.index(it->first));
-        PlayerCards& cards = it->second;
-        writer.write(cards.unknownCards());
-        writer.write(cards.knownCards().begin(), cards.knownCards().end());
+bool GameCardsTracker::snapshot()
+{
+    copyState(mSnapshot);
+    mSnapshotTaken = true;
+    return true;
+}
+
+void GameCardsTracker::save(DataWriter& writer)
+{
+    // saved not by the engine: the current data, mSnapshot stays untouched
+    SavedState current;
+    if (!mSnapshotTaken) {
+        copyState(current);
+    }
+    const SavedState& state = mSnapshotTaken ? mSnapshot : current;
+    mSnapshotTaken = false;
+
+    SaveFormat::writeCards(writer, state.mGameCards.begin(), state.mGameCards.end());
+    writer.writeUint8(state.mTrumpSuit);
+
+    unsigned int playersCount = state.mPlayersCards.size();
+    writer.writeUint32(playersCount);
+    for (unsigned int i = 0; i < playersCount; ++i) {
+        writer.writeUint32(i);
+        const PlayerCards& cards = state.mPlayersCards[i];
+        writer.writeUint32(cards.unknownCards());
+        SaveFormat::writeCards(writer, cards.knownCards().begin(), cards.knownCards().end());
     }
 
-    writer.write(mGoneCards.begin(), mGoneCards.end());
-    writer.write(mLastRoundIndex);
-    writer.write(mAttackCards.begin(), mAttackCards.end());
-    writer.write(mDefendCards.begin(), mDefendCards.end());
+    SaveFormat::writeCards(writer, state.mGoneCards.begin(), state.mGoneCards.end());
+    writer.writeUint32(state.mLastRoundIndex);
+    SaveFormat::writeCards(writer, state.mAttackCards.begin(), state.mAttackCards.end());
+    SaveFormat::writeCards(writer, state.mDefendCards.begin(), state.mDefendCards.end());
 }
 
 void GameCardsTracker::init(DataReader& reader)
 {
-    const Card defaultCard(SUIT_LAST, RANK_LAST);
-
-    reader.read(mGameCards, defaultCard);
-    reader.read(mTrumpSuit);
+    SaveFormat::readCards(reader, mGameCards);
+    mTrumpSuit = static_cast<Suit>(reader.readUint8());
 
-    unsigned int playersCount;
-    reader.read(playersCount);
+    unsigned int playersCount = reader.readUint32();
     while (playersCount--) {
-        unsigned int playerIndex;
-        reader.read(playerIndex);
-        unsigned int unknownCards;
-        reader.read(unknownCards);
+        unsigned int playerIndex = reader.readUint32();
+        unsigned int unknownCards = reader.readUint32();
         CardSet knownCards;
-        reader.read(knownCards, defaultCard);
+        SaveFormat::readCards(reader, knownCards);
         PlayerCards cards;
         cards.addCards(knownCards);
         cards.addUnknownCards(unknownCards);
         assert(mPlayerIds.size() > playerIndex);
-        mPlayersCards[mPlayerIds[playerIndex]] = cards;
+        mPlayersCards[playerIndex] = cards;
     }
 
-    reader.read(mGoneCards, defaultCard);
-    reader.read(mLastRoundIndex);
-    reader.read(mAttackCards, defaultCard);
-    reader.read(mDefendCards, defaultCard);
+    SaveFormat::readCards(reader, mGoneCards);
+    mLastRoundIndex = reader.readUint32();
+    SaveFormat::readCards(reader, mAttackCards);
+    SaveFormat::readCards(reader, mDefendCards);
 
     // check data consistency
 #ifndef NDEBUG
     for (std::map<const PlayerId*, unsigned int>::const_iterator it = mRestoredPlayerCards.begin(); it != mRestoredPlayerCards.end(); ++it) {
-        assert(mPlayersCards.at((*it).first).size() == (*it).second);
+        assert(mPlayersCards.at(mPlayerIds.index((*it).first)).size() == (*it).second);
     }
     assert(mRestoredAttackCards.size() == mAttackCards.size());
     assert(mRestoredDefendCards.size() == mDefendCards.size());
@@ -215,6 +231,7 @@ void GameCardsTracker::gameRestored(const std::vector<const PlayerId*>& playerId
         const std::vector<Card>& defendCards)
 {
     mPlayerIds.insert(mPlayerIds.begin(), playerIds.begin(), playerIds.end());
+    mPlayersCards.resize(mPlayerIds.size());
 #ifndef NDEBUG
     mRestoredPlayerCards = playersCards;
     mRestoredAttackCards = attackCards;
@@ -246,8 +263,7 @@ unsigned int GameCardsTracker::deckCards() const
 
 const PlayerCards& GameCardsTracker::playerCards(const PlayerId* playerId) const
 {
-    assert(mPlayersCards.find(playerId) != mPlayersCards.end());
-    return mPlayersCards.at(playerId);
+    return mPlayersCards.at(mPlayerIds.index(playerId));
 }
 
 const PlayerIds& GameCardsTracker::playerIds() const
@@ -275,15 +291,5 @@ const std::vector<Card>& GameCardsTracker::defendCards() const
     return mDefendCards;
 }
 
-GameCardsTracker::CardRemover::CardRemover(CardSet &cards)
-    : mCards(cards)
-{
-}
-
-void GameCardsTracker::CardRemover::operator()(const Card &card)
-{
-     assert(1 == mCards.erase(card));
-}
-
 }
 
@@ -0,0 +1,278 @@
+#ifndef ASYNCOBSERVER_H
+#define ASYNCOBSERVER_H
+
+#include <vector>
+#include <map>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "gameObserver.h"
+#include "eventObserver.h"
+#include "playerIds.h"
+#include "atomic.h"
+
+namespace decore
+{
+
+/**
+ * @brief Game observer adapter which notifies the observer from its own thread
+ *
+ * A slow observer (UI, logging) does not stall the game: notifications are queued as GameEvent groups
+ * (one group per notification, see GameEventType) into a bounded single producer/single consumer ring
+ * and the observer is notified by the adapter's thread in the same order.
+ *
+ * The ring is lock-free: the game thread and the adapter's thread take the lock only to wait
+ * (full ring in BACKPRESSURE_BLOCK mode, empty ring, save()).
+ * If the thread could not be started the observer is notified from the game thread.
+ *
+ * save() and init() are barriers: the adapter's thread notifies the observer about all queued events and pauses,
+ * the observer is saved or initialized from the caller's thread, then the thread continues.
+ * For save() of the engine the barrier is the position of snapshot(): the events queued after the engine's snapshot are not
+ * passed to the observer before it's saved.
+ *
+ * quit() is passed to the observer immediately.
+ *
+ * Usage example:
+ * @code
+ *     SpectatorObserver spectator;
+ *     AsyncObserver asyncSpectator(spectator, 256, AsyncObserver::BACKPRESSURE_COALESCE);
+ *     engine.addGameObserver(asyncSpectator);
+ * @endcode
+ */
+class AsyncObserver : public GameObserver
+{
+public:
+    /**
+     * @brief What to do with new notification if the ring is full
+     */
+    enum Backpressure
+    {
+        /**
+         * @brief Wait for the observer: no notifications lost
+         */
+        BACKPRESSURE_BLOCK,
+        /**
+         * @brief Drop the oldest queued notifications
+         */
+        BACKPRESSURE_DROP_OLDEST,
+        /**
+         * @brief Replace all queued notifications with GameObserver::gameRestored() of the current state
+         *
+         * The observer misses the details, but gets the actual game state: players' cards amounts, deck cards, trump, table
+         */
+        BACKPRESSURE_COALESCE
+    };
+
+private:
+    /**
+     * @brief mReading value while no group is being copied
+     */
+    static const uint64_t NOT_READING = ~static_cast<uint64_t>(0);
+
+    /**
+     * @brief Game state tracked from the notifications for BACKPRESSURE_COALESCE
+     */
+    class State
+    {
+    public:
+        State();
+        PlayerIds mPlayers;
+        std::map<const PlayerId*, unsigned int> mPlayersCards;
+        unsigned int mDeckCards;
+        Suit mTrumpSuit;
+        const PlayerId* mDefender;
+        std::vector<Card> mAttackCards;
+        std::vector<Card> mDefendCards;
+        /**
+         * @brief Updates the state with the event group
+         * @param events group
+         * @param amount group size
+         */
+        void update(const GameEvent* events, unsigned int amount);
+    };
+
+    /**
+     * @brief The observer
+     */
+    GameObserver& mObserver;
+    /**
+     * @brief Backpressure mode
+     */
+    const Backpressure mBackpressure;
+    /**
+     * @brief The ring, size is power of two
+     */
+    std::vector<GameEvent> mRing;
+    /**
+     * @brief Position of the first queued event, ring index is position modulo ring size
+     *
+     * Moved by the adapter's thread, and by the game thread when it drops the events
+     */
+    Atomic<uint64_t> mHead;
+    /**
+     * @brief Position after the last queued event, moved by the game thread
+     */
+    Atomic<uint64_t> mTail;
+    /**
+     * @brief Position of the group being copied by the adapter's thread, NOT_READING if none
+     *
+     * The game thread which dropped the events does not overwrite their slots till the copy is done
+     */
+    Atomic<uint64_t> mReading;
+    /**
+     * @brief Amount of dropped events
+     */
+    Atomic<uint64_t> mDropped;
+    /**
+     * @brief Amount of threads waiting for mSignal
+     */
+    Atomic<int> mWaiters;
+    /**
+     * @brief True if save() or init() waits for the adapter's thread
+     */
+    Atomic<bool> mPause;
+    /**
+     * @brief Position the adapter's thread should reach before pause, guarded by mLock
+     */
+    uint64_t mPauseTarget;
+    /**
+     * @brief True if the adapter's thread paused, guarded by mLock
+     */
+    bool mPaused;
+    /**
+     * @brief True if the thread should finish, guarded by mLock
+     */
+    bool mStop;
+    /**
+     * @brief Wait lock
+     */
+    pthread_mutex_t mLock;
+    /**
+     * @brief Wait signal
+     */
+    pthread_cond_t mSignal;
+    /**
+     * @brief The adapter's thread
+     */
+    pthread_t mThread;
+    /**
+     * @brief True if mThread is started
+     */
+    bool mThreadStarted;
+    /**
+     * @brief Notification being queued, game thread only
+     */
+    std::vector<GameEvent> mGroup;
+    /**
+     * @brief Game state, game thread only
+     */
+    State mState;
+    /**
+     * @brief Notification being dispatched, the adapter's thread only
+     */
+    std::vector<GameEvent> mDispatchGroup;
+    /**
+     * @brief Queue position at snapshot(), saving thread only
+     */
+    uint64_t mSnapshotTail;
+    /**
+     * @brief True if snapshot() is taken for the next save(), saving thread only
+     */
+    bool mSnapshotTaken;
+
+public:
+    /**
+     * @brief Ctor, starts the thread
+     * @param observer observer to notify
+     * @param capacity ring size in events, rounded up to power of two, at least the largest notification group:
+     * 128 events for Rules::MAX_SEATS players and the table cards
+     * @param backpressure full ring mode
+     */
+    AsyncObserver(GameObserver& observer, unsigned int capacity = 1024, Backpressure backpressure = BACKPRESSURE_BLOCK);
+    /**
+     * @brief Dtor, notifies the observer about queued events and stops the thread
+     */
+    ~AsyncObserver();
+    /**
+     * @brief Waits till the observer is notified about all queued events
+     */
+    void flush();
+    /**
+     * @brief Returns amount of dropped events
+     *
+     * BACKPRESSURE_DROP_OLDEST and BACKPRESSURE_COALESCE only
+     * @return events amount
+     */
+    uint64_t dropped() const;
+
+    void gameStarted(const Suit& trumpSuit, const CardSet& cardSet, const std::vector<const PlayerId*>& players);
+    void gameRestored(const std::vector<const PlayerId*>& playerIds,
+        const std::map<const PlayerId*, unsigned int>& playersCards,
+        unsigned int deckCards,
+        const Suit& trumpSuit,
+        const std::vector<Card>& attackCards,
+        const std::vector<Card>& defendCards);
+    void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender);
+    void roundEnded(unsigned int roundIndex);
+    void cardsPickedUp(const PlayerId* playerId, const CardSet& cardSet);
+    void cardsDealed(const PlayerId* playerId, unsigned int cardsAmount);
+    void cardsGone(const CardSet& cardSet);
+    void cardsDropped(const PlayerId* playerId, const CardSet& cardSet);
+    bool snapshot();
+    void save(DataWriter& writer);
+    void init(DataReader& reader);
+    void quit();
+
+private:
+    /**
+     * @brief Appends event to mGroup
+     */
+    void add(GameEventType type, const PlayerId* player, unsigned int value, CardSet::Mask cards);
+    /**
+     * @brief Queues mGroup, game thread only
+     */
+    void push();
+    /**
+     * @brief Returns size of the event group at the position
+     * @param position position of the group
+     * @param tail end of the queued events
+     * @return group size
+     */
+    unsigned int groupSize(uint64_t position, uint64_t tail) const;
+    /**
+     * @brief Checks if the event continues the group
+     */
+    static bool continuation(const GameEvent& event);
+    /**
+     * @brief Wakes waiting threads if any
+     */
+    void wake();
+    /**
+     * @brief Stops the adapter's thread at the position, waits till it's paused
+     * @param target position the adapter's thread reaches before pause, at most mTail
+     */
+    void pause(uint64_t target);
+    /**
+     * @brief Continues the adapter's thread
+     */
+    void resume();
+    /**
+     * @brief Thread function
+     * @param data AsyncObserver
+     */
+    static void* thread(void* data);
+    /**
+     * @brief The adapter's thread loop
+     */
+    void run();
+    /**
+     * @brief Notifies the observer about the event group
+     * @param events group
+     * @param amount group size
+     */
+    void dispatch(const GameEvent* events, unsigned int amount);
+};
+
+}
+
+#endif /* ASYNCOBSERVER_H */
@@ -3,27 +3,41 @@
 
 #include <pthread.h>
 
+// the builtins are available since GCC 4.7 and in Clang
+#if !defined(__ATOMIC_SEQ_CST) && !defined(DECORE_ATOMIC_MUTEX)
+#define DECORE_ATOMIC_MUTEX
+#endif
+
 namespace decore
 {
 
 /**
  * @brief Some kind of std::atomic from C++11
+ *
+ * Lock-free with GCC/Clang atomic builtins, T should be trivially copyable (bool, integers, pointers).
+ * Other compilers get the mutex based implementation.
  */
 template <typename T>
 class Atomic
 {
+#ifdef DECORE_ATOMIC_MUTEX
     mutable pthread_mutex_t mLock;
+#endif
     T mData;
 
 public:
     explicit Atomic(T initialValue)
         : mData(initialValue)
     {
+#ifdef DECORE_ATOMIC_MUTEX
         pthread_mutex_init(&mLock, NULL);
+#endif
     }
     virtual ~Atomic()
     {
+#ifdef DECORE_ATOMIC_MUTEX
         pthread_mutex_destroy(&mLock);
+#endif
     }
 
     /**
@@ -35,10 +49,60 @@ public:
     T setAndGet(const T& data)
     {
         T res;
+#ifdef DECORE_ATOMIC_MUTEX
         lock();
         res = mData;
         mData = data;
         unlock();
+#else
+        T value = data;
+        __atomic_exchange(&mData, &value, &res, __ATOMIC_SEQ_CST);
+#endif
+        return res;
+    }
+
+    /**
+     * @brief Synchronously adds the value
+     *
+     * Integral types only
+     * @param value value to add
+     * @return previous value
+     */
+    T getAndAdd(const T& value)
+    {
+        T res;
+#ifdef DECORE_ATOMIC_MUTEX
+        lock();
+        res = mData;
+        mData = mData + value;
+        unlock();
+#else
+        res = __atomic_fetch_add(&mData, value, __ATOMIC_SEQ_CST);
+#endif
+        return res;
+    }
+
+    /**
+     * @brief Synchronously sets new value if current value is `expected`
+     * @param expected expected current value
+     * @param data value to set
+     * @return true if set
+     */
+    bool compareAndSet(const T& expected, const T& data)
+    {
+        bool res;
+#ifdef DECORE_ATOMIC_MUTEX
+        lock();
+        res = mData == expected;
+        if (res) {
+            mData = data;
+        }
+        unlock();
+#else
+        T current = expected;
+        T value = data;
+        res = __atomic_compare_exchange(&mData, &current, &value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
         return res;
     }
 
@@ -49,11 +113,16 @@ public:
     T get() const
     {
         T res;
+#ifdef DECORE_ATOMIC_MUTEX
         lock();
         res = mData;
         unlock();
+#else
+        __atomic_load(&mData, &res, __ATOMIC_SEQ_CST);
+#endif
         return res;
     }
+#ifdef DECORE_ATOMIC_MUTEX
 private:
     /**
      * @brief Internal lock
@@ -69,6 +138,7 @@ private:
     {
         pthread_mutex_unlock(&mLock);
     }
+#endif
 
 };
 
@@ -0,0 +1,244 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <vector>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "rank.h"
+#include "suit.h"
+
+namespace decore
+{
+
+class Player;
+
+/**
+ * @brief Creates players for BatchRunner games
+ *
+ * Invoked from the runner's worker threads concurrently: implementation should not share unsynchronized state between the players.
+ */
+class PlayerFactory
+{
+public:
+    virtual ~PlayerFactory()
+    {}
+    /**
+     * @brief Creates player for the game
+     * @param seat player index in the game, 0 is the first attacker
+     * @param gameIndex index of the game, could be used to seed the player
+     * @return player instance
+     */
+    virtual Player* create(unsigned int seat, uint64_t gameIndex) = 0;
+    /**
+     * @brief Destroys player after the game
+     *
+     * Deletes the player by default
+     * @param player player created by create()
+     */
+    virtual void destroy(Player* player);
+};
+
+/**
+ * @brief Statistics of the games batch
+ */
+struct BatchResult
+{
+    BatchResult();
+    /**
+     * @brief Amount of played games
+     */
+    uint64_t games;
+    /**
+     * @brief Amount of games without loser
+     */
+    uint64_t draws;
+    /**
+     * @brief Amount of games stopped by the rounds limit, see BatchRunner::setMaxRounds()
+     */
+    uint64_t unfinished;
+    /**
+     * @brief Amount of lost games of each seat
+     */
+    std::vector<uint64_t> losses;
+    /**
+     * @brief Amount of rounds of all the games
+     */
+    uint64_t rounds;
+    /**
+     * @brief Amount of rounds of the shortest game
+     */
+    unsigned int minRounds;
+    /**
+     * @brief Amount of rounds of the longest game
+     */
+    unsigned int maxRounds;
+    /**
+     * @brief Adds other statistics
+     * @param other statistics to add
+     */
+    void add(const BatchResult& other);
+    bool operator==(const BatchResult& other) const;
+    bool operator!=(const BatchResult& other) const;
+};
+
+/**
+ * @brief Plays batches of independent games on several threads
+ *
+ * Game `i` of the batch is played with the deck Deck::generate(..., seed, i) by the players from PlayerFactory,
+ * so the result depends on the seed and the games range only: any amount of threads gives same result.
+ *
+ * Each thread owns a part of the games range and its own statistics.
+ * A thread which finished its part steals the half of the rest of other thread's part,
+ * statistics are summed up after all threads finished.
+ *
+ * Usage example:
+ * @code
+ *     YourPlayerFactory factory;
+ *     BatchRunner runner(factory, 3);
+ *     BatchResult result = runner.run(seed, 0, 100000, 8);
+ * @endcode
+ */
+class BatchRunner
+{
+    /**
+     * @brief Games range of one thread
+     */
+    class Worker
+    {
+        /**
+         * @brief Range lock
+         */
+        pthread_mutex_t mLock;
+        /**
+         * @brief Next game of the range
+         */
+        uint64_t mNext;
+        /**
+         * @brief End of the range
+         */
+        uint64_t mEnd;
+    public:
+        Worker();
+        ~Worker();
+        /**
+         * @brief Thread handle
+         */
+        pthread_t mThread;
+        /**
+         * @brief True if mThread is started and should be joined
+         */
+        bool mStarted;
+        /**
+         * @brief Runner
+         */
+        BatchRunner* mRunner;
+        /**
+         * @brief Worker index
+         */
+        unsigned int mIndex;
+        /**
+         * @brief Statistics of the games played by the worker
+         */
+        BatchResult mResult;
+        /**
+         * @brief Sets the range
+         * @param begin first game
+         * @param end end of the range
+         */
+        void assign(uint64_t begin, uint64_t end);
+        /**
+         * @brief Takes next game of the range
+         * @param game destination
+         * @return false if the range is empty
+         */
+        bool pop(uint64_t& game);
+        /**
+         * @brief Takes the upper half of the rest of the range
+         * @param begin destination for the first stolen game
+         * @param end destination for the end of stolen games
+         * @return false if the range is empty
+         */
+        bool steal(uint64_t& begin, uint64_t& end);
+    };
+
+    PlayerFactory& mFactory;
+    const unsigned int mPlayers;
+    std::vector<Rank> mRanks;
+    std::vector<Suit> mSuits;
+    bool mPinThreads;
+    unsigned int mMaxRounds;
+    uint64_t mSeed;
+    std::vector<Worker*> mWorkers;
+
+public:
+    /**
+     * @brief Ctor
+     *
+     * The games are played with full 36 cards deck by default, see setCards()
+     * @param factory players factory
+     * @param players amount of players in each game, at least 2
+     */
+    BatchRunner(PlayerFactory& factory, unsigned int players);
+    /**
+     * @brief Sets cards of the decks
+     * @param ranks card ranks
+     * @param ranksSize size of ranks
+     * @param suits card suits
+     * @param suitsSize size of suits
+     */
+    void setCards(const Rank* ranks, unsigned int ranksSize, const Suit* suits, unsigned int suitsSize);
+    /**
+     * @brief Enables pinning of worker threads to CPUs
+     *
+     * Worker `i` is pinned to CPU `i` modulo CPUs amount. Supported on Linux only, ignored otherwise.
+     * @param pin true to pin
+     */
+    void setPinThreads(bool pin);
+    /**
+     * @brief Sets max amount of rounds of a game
+     *
+     * Players could play a game forever once the deck is empty: the same cards go around.
+     * Such games are stopped after `maxRounds` rounds and counted as unfinished. 1000 rounds by default.
+     * @param maxRounds max rounds amount
+     */
+    void setMaxRounds(unsigned int maxRounds);
+    /**
+     * @brief Plays the games
+     *
+     * Not reentrant: one run() per instance at a time.
+     * @param seed run seed, see Deck::generate()
+     * @param firstGame index of the first game
+     * @param games amount of games
+     * @param threads amount of threads, the calling thread is one of them
+     * @return statistics of the games
+     */
+    BatchResult run(uint64_t seed, uint64_t firstGame, uint64_t games, unsigned int threads);
+
+private:
+    /**
+     * @brief Thread function
+     * @param data Worker
+     */
+    static void* workerThread(void* data);
+    /**
+     * @brief Plays worker's games and steals the games of others
+     * @param worker worker
+     */
+    void work(Worker& worker);
+    /**
+     * @brief Plays one game
+     * @param game index of the game
+     * @param result statistics destination
+     */
+    void play(uint64_t game, BatchResult& result);
+    /**
+     * @brief Pins the calling thread to the CPU
+     * @param index worker index
+     */
+    static void pin(unsigned int index);
+};
+
+}
+
+#endif /* BATCHRUNNER_H */
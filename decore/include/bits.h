@@ -0,0 +1,63 @@
+#ifndef BITS_H
+#define BITS_H
+
+#include <assert.h>
+#include <stdint.h>
+
+namespace decore
+{
+
+/**
+ * @brief Returns index of the lowest set bit, mask should not be 0
+ */
+inline unsigned int lowestBit(uint64_t mask)
+{
+    assert(mask);
+#ifdef __GNUC__
+    return __builtin_ctzll(mask);
+#else
+    unsigned int index = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief Returns index of the highest set bit, mask should not be 0
+ */
+inline unsigned int highestBit(uint64_t mask)
+{
+    assert(mask);
+#ifdef __GNUC__
+    return 63 - __builtin_clzll(mask);
+#else
+    unsigned int index = 0;
+    while (mask >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief Returns amount of set bits
+ */
+inline unsigned int bitCount(uint64_t mask)
+{
+#ifdef __GNUC__
+    return __builtin_popcountll(mask);
+#else
+    unsigned int count = 0;
+    for (; mask; mask &= mask - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+}
+
+#endif /* BITS_H */
@@ -0,0 +1,65 @@
+#ifndef BUFFERREADER_H
+#define BUFFERREADER_H
+
+#include "dataReader.h"
+
+namespace decore
+{
+
+/**
+ * @brief Reader of the bytes in memory, the bytes are not copied and should outlive the reader
+ *
+ * Reading past the end does not move the position, zero bytes are returned and failed() is set.
+ * @see BufferWriter
+ */
+class BufferReader : public DataReader
+{
+public:
+    using DataReader::read;
+
+    /**
+     * @brief Creates reader of the bytes
+     * @param data pointer to the first byte, `NULL` is the same as no bytes
+     * @param dataSizeBytes size of the data in bytes
+     */
+    BufferReader(const void* data, unsigned int dataSizeBytes);
+
+    /**
+     * @brief Returns size of the data
+     * @return size in bytes
+     */
+    unsigned int size() const;
+    /**
+     * @brief Returns true if the data ended before a read
+     * @return true if any read failed
+     */
+    bool failed() const;
+
+    const void* view(unsigned int dataSizeBytes);
+    unsigned int position() const;
+
+protected:
+    /**
+     * @brief Creates reader of no bytes
+     */
+    BufferReader();
+    /**
+     * @brief Starts reading of other bytes from the beginning
+     * @param data pointer to the first byte
+     * @param dataSizeBytes size of the data in bytes
+     */
+    void reset(const void* data, unsigned int dataSizeBytes);
+
+    void read(void* data, unsigned int dataSizeBytes);
+    void readArray(void* data, unsigned int elementSizeBytes, unsigned int elementsCount);
+
+private:
+    const unsigned char* mData;
+    unsigned int mSize;
+    unsigned int mPosition;
+    bool mFailed;
+};
+
+}
+
+#endif /* BUFFERREADER_H */
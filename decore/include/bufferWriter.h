@@ -0,0 +1,47 @@
+#ifndef BUFFERWRITER_H
+#define BUFFERWRITER_H
+
+#include <vector>
+
+#include "dataWriter.h"
+
+namespace decore
+{
+
+/**
+ * @brief Writer into the memory buffer
+ * @see BufferReader
+ */
+class BufferWriter : public DataWriter
+{
+public:
+    using DataWriter::write;
+
+    /**
+     * @brief Returns written bytes
+     * @return pointer to the first byte or `NULL` if nothing written
+     */
+    const unsigned char* data() const;
+    /**
+     * @brief Returns amount of written bytes
+     * @return size in bytes
+     */
+    unsigned int size() const;
+    /**
+     * @brief Drops written bytes, the memory is kept for the next writes
+     */
+    void clear();
+
+    unsigned int position() const;
+
+protected:
+    void write(const void* data, unsigned int dataSizeBytes);
+    void writeArray(const void* data, unsigned int elementSizeBytes, unsigned int elementsCount);
+
+private:
+    std::vector<unsigned char> mBytes;
+};
+
+}
+
+#endif /* BUFFERWRITER_H */
@@ -10,17 +10,34 @@ namespace decore {
  * @brief The card class
  *
  * Game card class.
+ *
+ * The card is one byte: index of the card `suit * RANK_LAST + rank`, suit and rank are derived from the index.
+ * Cards with SUIT_LAST or RANK_LAST share one index INVALID_INDEX, it's suit and rank are SUIT_LAST and RANK_LAST.
+ *
+ * There's static table of interned cards, one card object per index, see interned().
+ * CardSet iterators refer to the table, so a card from a CardSet could be identified by its address.
  */
 class Card
 {
+public:
+    /**
+     * @brief Index of not valid card, all valid card indexes are less
+     */
+    static const unsigned int INVALID_INDEX = SUIT_LAST * RANK_LAST;
+
+private:
     /**
-     * @brief Suit of the card
+     * @brief Index of the card
      */
-    Suit mSuit;
+    unsigned char mIndex;
     /**
-     * @brief Rank of the card
+     * @brief Suit of each index
      */
-    Rank mRank;
+    static const Suit SUITS[INVALID_INDEX + 1];
+    /**
+     * @brief Rank of each index
+     */
+    static const Rank RANKS[INVALID_INDEX + 1];
 
 public:
     /**
@@ -55,7 +72,70 @@ public:
      * @return suit of the card
      */
     const Suit& suit() const;
+    /**
+     * @brief Index getter
+     * @return index of the card, INVALID_INDEX for not valid card
+     */
+    unsigned int index() const;
+    /**
+     * @brief Returns index of the card with the suit and the rank
+     *
+     * Is a compile time constant for constant arguments.
+     * @param suit suit of the card
+     * @param rank rank of the card
+     * @return index
+     */
+    static unsigned int index(const Suit& suit, const Rank& rank);
+    /**
+     * @brief Returns interned card with the index
+     * @param index card index, less than INVALID_INDEX
+     * @return card from the static table
+     */
+    static const Card& interned(unsigned int index);
+    /**
+     * @brief Returns index of the interned card by its address
+     * @param card pointer to check
+     * @return index of the card or INVALID_INDEX if the `card` is not from the static table
+     */
+    static unsigned int internedIndex(const Card* card);
 };
 
+// the methods are trivial and used in tight loops, so they are defined here to be inlined
+
+inline Card::Card(const Suit& suit, const Rank& rank)
+    : mIndex(static_cast<unsigned char>(index(suit, rank)))
+{
+}
+
+inline bool Card::operator ==(const Card& other) const
+{
+    return mIndex == other.mIndex;
+}
+
+inline bool Card::operator <(const Card& other) const
+{
+    return mIndex < other.mIndex;
+}
+
+inline const Rank& Card::rank() const
+{
+    return RANKS[mIndex];
+}
+
+inline const Suit& Card::suit() const
+{
+    return SUITS[mIndex];
+}
+
+inline unsigned int Card::index() const
+{
+    return mIndex;
+}
+
+inline unsigned int Card::index(const Suit& suit, const Rank& rank)
+{
+    return suit < SUIT_LAST && rank < RANK_LAST ? suit * RANK_LAST + rank : INVALID_INDEX;
+}
+
 }
 #endif // CARD_H_INCLUDED
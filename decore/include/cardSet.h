@@ -1,9 +1,12 @@
 #ifndef CARDSET_H
 #define CARDSET_H
 
-#include <set>
 #include <map>
 #include <vector>
+#include <utility>
+#include <iterator>
+#include <cstddef>
+#include <stdint.h>
 
 #include "card.h"
 #include "playerId.h"
@@ -16,16 +19,150 @@ namespace decore
  *
  * - Initially created empty could be filled with cards, see generate()
  * - Any amount of cards could be added with add()
+ *
+ * The set is a bit mask: one bit per suit and rank, bit index is Card::index().
+ * So the set never allocates and union, difference, size and suit/rank filters are a few register operations.
+ * Interface follows std::set<Card>, iteration order is the same as Card::operator<.
  */
-class CardSet : public std::set<Card>
+class CardSet
 {
-
 public:
+    /**
+     * @brief Bit mask type
+     */
+    typedef uint64_t Mask;
+
+    typedef Card key_type;
+    typedef Card value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Card& reference;
+    typedef const Card& const_reference;
+    typedef const Card* pointer;
+    typedef const Card* const_pointer;
+
+    /**
+     * @brief Bidirectional iterator over the set cards
+     *
+     * Dereferenced iterator refers to the interned card, see Card::interned(),
+     * so the reference stays valid after the set is modified or destroyed.
+     */
+    class const_iterator
+    {
+        /**
+         * @brief Mask of the iterated set
+         */
+        const Mask* mMask;
+        /**
+         * @brief Current card index, CARDS for end()
+         */
+        unsigned int mIndex;
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef Card value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Card* pointer;
+        typedef const Card& reference;
+
+        const_iterator();
+        const_iterator(const Mask* mask, unsigned int index);
+
+        reference operator*() const;
+        pointer operator->() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        const_iterator& operator--();
+        const_iterator operator--(int);
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+    };
+    typedef const_iterator iterator;
+
+    /**
+     * @brief Amount of bits in use
+     */
+    static const unsigned int CARDS = SUIT_LAST * RANK_LAST;
+
     /**
      * @brief Constructs empty card set
      */
     CardSet();
-    virtual ~CardSet();
+    /**
+     * @brief Constructs card set from the mask
+     * @param mask cards mask
+     */
+    explicit CardSet(Mask mask);
+    ~CardSet();
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    bool empty() const;
+    size_type size() const;
+    /**
+     * @brief Adds the card
+     * @param card card to add
+     * @return iterator to the card and true if the card was not in the set
+     */
+    std::pair<iterator, bool> insert(const Card& card);
+    /**
+     * @brief Adds the card, `hint` is ignored
+     *
+     * Exists for std::inserter() and alike
+     * @param hint ignored
+     * @param card card to add
+     * @return iterator to the card
+     */
+    iterator insert(const_iterator hint, const Card& card);
+    /**
+     * @brief Adds cards from the range
+     * @param first first card
+     * @param last end of the range
+     */
+    template <typename InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first) {
+            mMask |= cardMask(*first);
+        }
+    }
+    /**
+     * @brief Removes the card
+     * @param card card to remove
+     * @return amount of removed cards
+     */
+    size_type erase(const Card& card);
+    /**
+     * @brief Removes the card at `position`
+     * @param position position of the card
+     */
+    void erase(const_iterator position);
+    /**
+     * @brief Finds the card
+     * @param card card to find
+     * @return iterator to the card or end()
+     */
+    const_iterator find(const Card& card) const;
+    /**
+     * @brief Returns 1 if the card in the set, 0 otherwise
+     * @param card card
+     * @return amount of the cards
+     */
+    size_type count(const Card& card) const;
+    /**
+     * @brief Checks if the card object is in the set
+     *
+     * Unlike find() the card is identified by its address: it should be the interned card (the one the set iterators refer to),
+     * so the check is a range check and a mask test.
+     * @param card card pointer, could be NULL
+     * @return true if the `card` is interned and it's value is in the set
+     */
+    bool contains(const Card* card) const;
+    /**
+     * @brief Removes all the cards
+     */
+    void clear();
+    bool operator==(const CardSet& other) const;
+    bool operator!=(const CardSet& other) const;
 
     /**
      * @brief Adds the cards to the card set
@@ -33,6 +170,17 @@ public:
      * @return true if all cards added
      */
     bool addAll(const std::vector<Card>& cards);
+    /**
+     * @brief Adds the cards to the card set
+     * @param cards cards to add
+     * @return true if all cards added, i.e. none of the `cards` was in the set
+     */
+    bool addAll(const CardSet& cards);
+    /**
+     * @brief Removes the cards from the card set
+     * @param cards cards to remove
+     */
+    void removeAll(const CardSet& cards);
     /**
      * @brief Appends all cards with the `rank` from the card set to `cards`
      * @param rank rank
@@ -45,6 +193,62 @@ public:
      * @param cards destination card set
      */
     void getCards(const Suit& suit, CardSet& cards) const;
+    /**
+     * @brief Returns the mask
+     * @return mask
+     */
+    Mask mask() const;
+    /**
+     * @brief Returns ranks of the cards
+     * @return mask of ranks, bit index is rank
+     */
+    unsigned int ranks() const;
+
+    /**
+     * @brief Returns mask with the card's bit
+     * @param card card
+     * @return mask
+     */
+    static Mask cardMask(const Card& card);
+    /**
+     * @brief Returns mask with all cards of the rank
+     * @param rank rank
+     * @return mask
+     */
+    static Mask rankMask(const Rank& rank);
+    /**
+     * @brief Returns mask with all cards of the suit
+     * @param suit suit
+     * @return mask
+     */
+    static Mask suitMask(const Suit& suit);
+    /**
+     * @brief Returns mask with all cards of the ranks
+     * @param ranks mask of ranks, bit index is rank, see ranks()
+     * @return mask
+     */
+    static Mask rankColumns(unsigned int ranks);
+
+private:
+    /**
+     * @brief The cards
+     */
+    Mask mMask;
+
+    /**
+     * @brief Returns index of the lowest set bit not lower than `from`
+     * @param mask mask
+     * @param from first index to check
+     * @return bit index or CARDS if no bits set
+     */
+    static unsigned int next(Mask mask, unsigned int from);
+    /**
+     * @brief Returns index of the highest set bit lower than `to`
+     * @param mask mask
+     * @param to index after the last index to check
+     * @return bit index or CARDS if no bits set
+     */
+    static unsigned int previous(Mask mask, unsigned int to);
 };
 
 }
@@ -1,6 +1,10 @@
 #ifndef DATAREADER_H
 #define DATAREADER_H
 
+#include <stdint.h>
+
+#include "typeTraits.h"
+
 namespace decore
 {
 
@@ -43,18 +47,60 @@ public:
         read(static_cast<void*>(&value), sizeof(value));
     }
 
+    /**
+     * @brief Reads elements written by DataWriter::write(T, T) to the end of the `container`
+     * @param container destination
+     * @param defaultValue value to construct the elements before read
+     */
     template <typename T, typename V>
     void read(T& container, const V& defaultValue)
     {
         unsigned int amount;
         read(amount);
-        while (amount--) {
-            V value(defaultValue);
-            read(value);
-            container.insert(container.end(), value);
-        }
+        readElements(container, amount, defaultValue);
     }
 
+    /**
+     * @brief Reads elements written by DataWriter::writeElements() to the end of the `container`
+     *
+     * Elements of std::vector (see IsContiguous) are read with single readArray(), others are read and inserted one by one.
+     * @param container destination
+     * @param amount amount of the elements
+     * @param defaultValue value to construct the elements before read
+     */
+    template <typename T, typename V>
+    void readElements(T& container, unsigned int amount, const V& defaultValue)
+    {
+        readElements(container, amount, defaultValue,
+            Bool<IsContiguous<typename T::iterator>::value && IsSame<typename T::value_type, V>::value>());
+    }
+
+    /**
+     * @brief Reads value written by DataWriter::writeUint8()
+     * @return value
+     */
+    uint8_t readUint8();
+    /**
+     * @brief Reads value written by DataWriter::writeUint32()
+     * @return value
+     */
+    uint32_t readUint32();
+    /**
+     * @brief Reads bytes written by DataWriter::writeBytes()
+     * @param data destination data pointer
+     * @param dataSizeBytes size of data to read in bytes
+     */
+    void readBytes(void* data, unsigned int dataSizeBytes);
+    /**
+     * @brief Returns next `dataSizeBytes` in place and skips them
+     *
+     * Readers of data in memory (see BufferReader, MappedFileReader) return the bytes with no copy,
+     * default implementation returns `NULL`: the bytes should be read with readBytes() then.
+     * @param dataSizeBytes size of data in bytes
+     * @return pointer to the first byte or `NULL` if not supported or not enough data
+     */
+    virtual const void* view(unsigned int dataSizeBytes);
+
     virtual unsigned int position() const = 0;
 protected:
     /**
@@ -63,6 +109,36 @@ protected:
      * @param dataSizeBytes size of data to read in bytes
      */
     virtual void read(void* data, unsigned int dataSizeBytes) = 0;
+    /**
+     * @brief Reads `elementsCount` elements of `elementSizeBytes` stored one by one
+     *
+     * Default implementation invokes read() for each element, see DataWriter::writeArray().
+     * @param data pointer to the first element
+     * @param elementSizeBytes size of the element in bytes
+     * @param elementsCount amount of the elements
+     */
+    virtual void readArray(void* data, unsigned int elementSizeBytes, unsigned int elementsCount);
+
+private:
+    template <typename T, typename V>
+    void readElements(T& container, unsigned int amount, const V& defaultValue, Bool<true>)
+    {
+        if (amount) {
+            typename T::size_type first = container.size();
+            container.resize(first + amount, defaultValue);
+            readArray(&container[first], sizeof(V), amount);
+        }
+    }
+
+    template <typename T, typename V>
+    void readElements(T& container, unsigned int amount, const V& defaultValue, Bool<false>)
+    {
+        while (amount--) {
+            V value(defaultValue);
+            read(value);
+            container.insert(container.end(), value);
+        }
+    }
 };
 
 }
@@ -2,6 +2,9 @@
 #define DATAWRITER_H
 
 #include <iterator>
+#include <stdint.h>
+
+#include "typeTraits.h"
 
 namespace decore
 {
@@ -28,16 +31,55 @@ public:
         write(static_cast<const void*>(&value), sizeof(value));
     }
 
+    /**
+     * @brief Writes amount of the elements and the elements
+     * @param begin first element
+     * @param end end of the elements
+     * @see DataReader::read(T&, const V&)
+     */
     template<typename T>
     void write(T begin, T end)
     {
         unsigned int elementsCount = std::distance(begin, end);
         write(elementsCount);
-        for (T it = begin; it != end; ++it) {
-            write(&*it, sizeof(*it));
-        }
+        writeElements(begin, end);
+    }
+
+    /**
+     * @brief Writes the elements, without amount
+     *
+     * Elements of contiguous range (see IsContiguous) are written with single writeArray(), others one by one.
+     * @param begin first element
+     * @param end end of the elements
+     */
+    template<typename T>
+    void writeElements(T begin, T end)
+    {
+        writeElements(begin, end, Bool<IsContiguous<T>::value>());
     }
 
+    /**
+     * @brief Writes `value` as one byte
+     * @param value value to write
+     * @see writeUint32()
+     */
+    void writeUint8(uint8_t value);
+    /**
+     * @brief Writes `value` as four bytes in little-endian order
+     *
+     * Unlike write() the written bytes do not depend on the platform's type sizes and byte order.
+     * @param value value to write
+     * @see DataReader::readUint32()
+     */
+    void writeUint32(uint32_t value);
+    /**
+     * @brief Writes the bytes as is, with single write
+     * @param data pointer to first data byte
+     * @param dataSizeBytes size of the data in bytes
+     * @see DataReader::readBytes()
+     */
+    void writeBytes(const void* data, unsigned int dataSizeBytes);
+
     /**
      * @brief Returns current position of internal pointer
      *
@@ -59,6 +101,33 @@ protected:
      * @param dataSizeBytes size of the data in bytes
      */
     virtual void write(const void* data, unsigned int dataSizeBytes) = 0;
+    /**
+     * @brief Writes `elementsCount` elements of `elementSizeBytes` stored one by one
+     *
+     * Default implementation invokes write() for each element, writers of memory or files could override it with single copy.
+     * The data should be readable both with DataReader::readArray() and with DataReader::read() of each element.
+     * @param data pointer to the first element
+     * @param elementSizeBytes size of the element in bytes
+     * @param elementsCount amount of the elements
+     */
+    virtual void writeArray(const void* data, unsigned int elementSizeBytes, unsigned int elementsCount);
+
+private:
+    template<typename T>
+    void writeElements(T begin, T end, Bool<true>)
+    {
+        if (begin != end) {
+            writeArray(&*begin, sizeof(*begin), std::distance(begin, end));
+        }
+    }
+
+    template<typename T>
+    void writeElements(T begin, T end, Bool<false>)
+    {
+        for (T it = begin; it != end; ++it) {
+            write(&*it, sizeof(*it));
+        }
+    }
 };
 
 }
@@ -0,0 +1,76 @@
+#ifndef DECISION_H
+#define DECISION_H
+
+#include "card.h"
+#include "cardSet.h"
+
+namespace decore
+{
+
+class PlayerId;
+class Player;
+
+/**
+ * @brief Type of the player's decision, see Decision
+ */
+enum DecisionType
+{
+    /**
+     * @brief No decision pending
+     */
+    DECISION_NONE,
+    /**
+     * @brief First attack card of the round, same as Player::attack()
+     */
+    DECISION_ATTACK,
+    /**
+     * @brief One more attack card or pass, same as Player::pitch()
+     */
+    DECISION_PITCH,
+    /**
+     * @brief Card to beat the attack card or pick up the table cards, same as Player::defend()
+     */
+    DECISION_DEFEND
+};
+
+/**
+ * @brief Decision of a player the game waits for, see Engine::step()
+ *
+ * Holds the arguments the engine passes to Player::attack(), Player::pitch() or Player::defend().
+ */
+struct Decision
+{
+    Decision();
+    /**
+     * @brief Decision type, see DecisionType
+     */
+    DecisionType type;
+    /**
+     * @brief Player who decides
+     */
+    const PlayerId* player;
+    /**
+     * @brief The defender for DECISION_ATTACK and DECISION_PITCH, the attacker for DECISION_DEFEND
+     */
+    const PlayerId* opponent;
+    /**
+     * @brief Card to beat, DECISION_DEFEND only
+     */
+    Card attackCard;
+    /**
+     * @brief Cards the player could play
+     */
+    CardSet cards;
+    /**
+     * @brief Asks the player for the decision as the engine does
+     *
+     * Invokes Player::attack(), Player::pitch() or Player::defend() with the decision's arguments.
+     * @param player the player
+     * @return the player's answer, NULL for DECISION_NONE
+     */
+    const Card* ask(Player& player) const;
+};
+
+}
+
+#endif /* DECISION_H */
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #include "cardSet.h"
 
@@ -12,12 +13,40 @@ class PlayerId;
 
 /**
  * @brief The deck
+ *
+ * Cards are dealt from the top (begin) of the deck, see deal().
+ * Dealt cards are not erased: the deck moves its top, so dealing is linear in dealt cards amount.
+ * All the methods refer to not dealt cards only.
  */
-class Deck : public std::vector<Card>
+class Deck
 {
+public:
+    typedef std::vector<Card>::value_type value_type;
+    typedef std::vector<Card>::size_type size_type;
+    typedef std::vector<Card>::iterator iterator;
+    typedef std::vector<Card>::const_iterator const_iterator;
+    typedef std::vector<Card>::reference reference;
+    typedef std::vector<Card>::const_reference const_reference;
+
+private:
+    /**
+     * @brief All the cards, dealt ones are before mTop
+     */
+    std::vector<Card> mCards;
     Suit mTrumpSuit;
+    /**
+     * @brief Amount of dealt cards, index of the top card
+     */
+    size_type mTop;
 
 public:
+    Deck();
+    /**
+     * @brief Copies not dealt cards of the deck
+     * @param other deck to copy
+     */
+    Deck(const Deck& other);
+    Deck& operator=(const Deck& other);
     /**
      * @brief Append card to the end of the deck
      *
@@ -25,6 +54,49 @@ public:
      * @param card card to append
      */
     void push_back(const Card& card);
+    /**
+     * @brief Removes all the cards
+     */
+    void clear();
+    /**
+     * @brief Resizes not dealt cards, see DataReader::readElements()
+     * @param size new amount of not dealt cards
+     * @param card value of the added cards
+     */
+    void resize(size_type size, const Card& card);
+    iterator begin();
+    const_iterator begin() const;
+    iterator end();
+    const_iterator end() const;
+    size_type size() const;
+    bool empty() const;
+    /**
+     * @brief Returns amount of cards the memory is allocated for, including dealt cards
+     * @return cards amount
+     */
+    size_type capacity() const;
+    reference operator[](size_type index);
+    const_reference operator[](size_type index) const;
+    reference at(size_type index);
+    const_reference at(size_type index) const;
+    reference front();
+    const_reference front() const;
+    reference back();
+    const_reference back() const;
+    /**
+     * @brief Compares not dealt cards of the decks
+     * @param other other deck
+     * @return true if the cards equal
+     */
+    bool operator==(const Deck& other) const;
+    bool operator!=(const Deck& other) const;
+    /**
+     * @brief Deals cards from the top of the deck
+     * @param cards card set to add the cards to
+     * @param amount amount of cards to deal
+     * @return amount of dealt cards, less than `amount` if the deck has not enough cards
+     */
+    unsigned int deal(CardSet& cards, unsigned int amount);
     /**
      * @brief Generates card set
      *
@@ -35,11 +107,46 @@ public:
      * @param suitsSize size of suits
      */
     void generate(const Rank *ranks, unsigned int ranksSize, const Suit *suits, unsigned int suitsSize);
+    /**
+     * @brief Generates shuffled card set
+     *
+     * The order is derived from `seed` and `gameIndex` only, see CounterRandom:
+     * any deck of a run could be generated in any thread in any order, and a game could be replayed from the two numbers.
+     * Trump suit is taken from the last card.
+     * @param ranks card ranks for generator
+     * @param ranksSize size of ranks
+     * @param suits card suits for generator
+     * @param suitsSize size of suits
+     * @param seed seed of the run
+     * @param gameIndex index of the game in the run
+     */
+    void generate(const Rank *ranks, unsigned int ranksSize, const Suit *suits, unsigned int suitsSize, uint64_t seed, uint64_t gameIndex);
     /**
      * @brief Shuffles cards in the set
+     *
+     * Seeds new Random generator with current time and shuffle counter, see shuffle(Generator&).
+     * For reproducible decks use shuffle(Generator&) with own seeded generator.
      * @return amount of not shuffled cards
      */
     unsigned int shuffle();
+    /**
+     * @brief Shuffles cards in place
+     *
+     * Fisher-Yates shuffle: linear, no allocations, the order depends only on the generator.
+     * Trump suit is taken from the last card.
+     * @param generator random generator, `generator(n)` returns uniformly distributed number in [0, n), see Random
+     */
+    template <typename Generator>
+    void shuffle(Generator& generator)
+    {
+        iterator cards = begin();
+        for (size_type i = size(); i > 1; --i) {
+            std::swap(cards[i - 1], cards[generator(static_cast<unsigned int>(i))]);
+        }
+        if (!empty()) {
+            mTrumpSuit = back().suit();
+        }
+    }
     /**
      * @brief Returns trump suit
      * @return trump suit
@@ -7,8 +7,14 @@
 #include "playerId.h"
 #include "cardSet.h"
 #include "gameObserver.h"
+#include "eventObserver.h"
 #include "playerIds.h"
+#include "rules.h"
 #include "atomic.h"
+#include "decision.h"
+#include "journal.h"
+#include "seqLock.h"
+#include "spectatorState.h"
 
 /**
  * @mainpage DeCore
@@ -75,6 +81,10 @@ class Deck;
 class DataReader;
 class DataWriter;
 
+namespace sim {
+struct GameState;
+}
+
 /**
  * @brief The game engine class
  *
@@ -91,6 +101,25 @@ class DataWriter;
  * Only methods to be used from other thread:
  * - save()
  * - quit()
+ * - spectatorState()
+ *
+ * Engine constructed with `threadSafe` false does not lock its state at all, for batch and self-play games:
+ * the methods above should be invoked from the thread of playRound() too (i.e. from players or observers, or between rounds).
+ *
+ * Alternatively the game could be driven by step() and submit() instead of playRound(): the engine never waits for a player then,
+ * so one thread could host many games which wait for remote or human players:
+ * @code
+ *     Decision decision;
+ *     while (engine.step(decision)) {
+ *         // ask decision.player, step() returns the same decision till the answer is submitted
+ *         engine.submit(answer);
+ *     }
+ * @endcode
+ * Player::attack(), Player::pitch() and Player::defend() are not invoked in this mode, the rest of the Player's
+ * and the observers' notifications are same.
+ *
+ * For crash recovery the moves could be appended to a write-ahead journal with periodic snapshots instead of save() after each move,
+ * see setJournal() and replay().
  */
 class Engine
 {
@@ -111,7 +140,12 @@ class Engine
          * @brief Attacker;s and defender cards all together
          */
         CardSet mAll;
+        /**
+         * @brief Ranks of the cards on the table, see CardSet::ranks()
+         */
+        unsigned int mRanks;
     public:
+        TableCards();
         /**
          * @brief Adds the `card` as attacker's
          * @param card card to add
@@ -127,6 +161,13 @@ class Engine
          * @return cards
          */
         const CardSet& all() const;
+        /**
+         * @brief Returns ranks of all cards
+         *
+         * Updated incrementally as the cards added
+         * @return mask of ranks, see CardSet::ranks()
+         */
+        unsigned int ranks() const;
         /**
          * @brief Checks if empty
          * @return true if empty
@@ -154,19 +195,31 @@ class Engine
      */
     PlayerIds mGeneratedIds;
     /**
-     * @brief Players added to the game
-     *
-     * Each player identified by unique id
+     * @brief Players added to the game, indexed by PlayerId::seat()
+     */
+    std::vector<Player*> mPlayers;
+    /**
+     * @brief Cards of each player, indexed by PlayerId::seat()
      */
-    std::map<const PlayerId*, Player*> mPlayers;
+    std::vector<CardSet> mPlayersCards;
     /**
-     * @brief Map of each player cards
+     * @brief Seats of the players which have cards, updated with mPlayersCards, see updateSeat()
      */
-    std::map<const PlayerId*, CardSet> mPlayersCards;
+    Rules::Seats mSeatsWithCards;
     /**
      * @brief Game flow observers
      */
     std::vector<GameObserver*> mGameObservers;
+    /**
+     * @brief Batched game flow observers
+     */
+    std::vector<EventObserver*> mEventObservers;
+    /**
+     * @brief Events not passed to mEventObservers yet
+     *
+     * Member to reuse its storage
+     */
+    std::vector<GameEvent> mEvents;
     /**
      * @brief Cards left in the deck.
      *
@@ -190,6 +243,13 @@ class Engine
      * @brief Current round state: list of attacker ids
      */
     std::vector<const PlayerId*> mAttackers;
+    /**
+     * @brief Current round state: seats of mAttackers
+     *
+     * The attackers follow in seat order starting from the first one, so rotation in the seat order
+     * is same as rotation in mAttackers order
+     */
+    Rules::Seats mAttackerSeats;
 
     /**
      * @brief Current round state: defender's id
@@ -205,6 +265,10 @@ class Engine
      * @brief Internal data synchronization lock
      */
     mutable pthread_mutex_t mLock;
+    /**
+     * @brief Serializes save(): observers keep one snapshot at a time
+     */
+    mutable pthread_mutex_t mSaveLock;
 #ifndef NDEBUG
     /**
      * @brief Lock flag for lock/unlock debug
@@ -215,6 +279,10 @@ class Engine
      * @brief Quit flag
      */
     Atomic<bool> mQuit;
+    /**
+     * @brief True if the state is locked for save() from other thread
+     */
+    const bool mThreadSafe;
 
     /**
      * @brief Current round state: current attacker
@@ -234,9 +302,9 @@ class Engine
      */
     bool mDefendFailed;
     /**
-     * @brief "Restored game" flag
+     * @brief Current round state: true if the defender should beat the last attack card
      *
-     * Actual for restored game when attacker dropped card and defender should beat it
+     * Restored from the table cards for restored game
      */
     bool mPickAttackCardFromTable;
 
@@ -246,11 +314,68 @@ class Engine
      * It is just pointer to mRoundIndex
      */
     unsigned int* mCurrentRoundIndex;
+    /**
+     * @brief Pending decision, DECISION_NONE if no decision pending
+     */
+    Decision mDecision;
+    /**
+     * @brief Submitted answer for mDecision, interned card or NULL
+     */
+    const Card* mAnswer;
+    /**
+     * @brief True if the answer for mDecision is submitted
+     */
+    bool mAnswered;
+
+    /**
+     * @brief Write-ahead journal, NULL if not set
+     */
+    Journal* mJournal;
+    /**
+     * @brief Snapshot period of the journal in rounds
+     */
+    unsigned int mSnapshotRounds;
+    /**
+     * @brief True if the journal needs snapshot before next round regardless of the period
+     */
+    bool mSnapshotPending;
+    /**
+     * @brief Records being replayed, see replay()
+     */
+    std::vector<JournalRecord> mReplay;
+    /**
+     * @brief Next record of mReplay to be reproduced by the game, replay is running while less than mReplay size
+     */
+    unsigned int mReplayPosition;
+    /**
+     * @brief True if the game did not reproduce a replayed record
+     */
+    bool mReplayFailed;
+
+    /**
+     * @brief Deal buffer: players' cards in deal order
+     *
+     * The deal buffers are members to reuse their storage between rounds
+     */
+    std::vector<CardSet*> mDealCards;
+    /**
+     * @brief Deal buffer: players' cards amount before the deal, in mGeneratedIds order
+     */
+    std::vector<unsigned int> mDealCardsAmount;
+    /**
+     * @brief Amount of state publications, see publish()
+     */
+    unsigned int mSpectatorVersion;
+    /**
+     * @brief State for spectator threads, published by the game thread of thread safe engine
+     */
+    SeqLock<SpectatorState> mSpectatorState;
 public:
     /**
      * @brief Ctor
+     * @param threadSafe false if save() and quit() are never invoked from other thread, no locks are taken then
      */
-    Engine();
+    explicit Engine(bool threadSafe = true);
     /**
      * @brief Dtor
      */
@@ -262,7 +387,7 @@ public:
      * Adds player to the game. Order of adding players defines moves order: i.e. first added player will make first move,
      * Adding same player more than once is allowed but game flow in the case will be unexpected.
      * @param player player instance to add
-     * @return id for the player or NULL if player not added (for example if game started already)
+     * @return id for the player or NULL if player not added (for example if game started already or Rules::MAX_SEATS players added)
      */
     PlayerId* add(Player& player);
     /**
@@ -272,6 +397,14 @@ public:
      * @param observer observer to add
      */
     void addGameObserver(GameObserver& observer);
+    /**
+     * @brief Adds batched game observer
+     *
+     * The events are buffered and passed to the observer before each Player::attack(), Player::pitch() and Player::defend()
+     * and at the end of each round. Observers of restored game should be added before init() or clone().
+     * @param observer observer to add
+     */
+    void addEventObserver(EventObserver& observer);
     /**
      * @brief Sets cards to the game
      *
@@ -290,6 +423,26 @@ public:
      * @return true if game is not ended and one more round could be played
      */
     bool playRound();
+    /**
+     * @brief Plays the game till a player's decision
+     *
+     * Non-blocking alternative of playRound(): instead of invoking Player::attack(), Player::pitch() or Player::defend()
+     * the engine returns the decision and waits for submit(). Next rounds are started as needed.
+     * Invoking step() again without submit() returns the same decision.
+     * @param decision destination for the pending decision
+     * @return true if the decision is pending, false if the game is ended or quit requested
+     */
+    bool step(Decision& decision);
+    /**
+     * @brief Submits answer for the decision of step()
+     *
+     * The card is identified by its value. A card not from Decision::cards is handled as an invalid answer of Player:
+     * it is replaced with any card of them for DECISION_ATTACK and picks up the table cards for DECISION_DEFEND.
+     * The game continues on next step().
+     * @param card the card, could be temporary; NULL to pass for DECISION_PITCH or to pick up the table cards for DECISION_DEFEND
+     * @return false if no decision is pending or it's answered already, the answer is ignored then
+     */
+    bool submit(const Card* card);
     /**
      * @brief Returns loser (only player with cards) or `NULL` in case of draw(no loser)
      *
@@ -301,9 +454,13 @@ public:
      * @brief Saves current state of the game into the `write`
      *
      * The feature could be used to save game state when application is being closed and to restore its state on next start.
-     * Note: make ensure that the data is used to restore the same version of the library, because next version of the library could add more data in the 'state'
+     * The data is same on any platform and is checked by init(): versioned header and checksum, see SaveFormat.
      *
      * The library provides same save/init flow for game observers (via GameObserver::save()) for the convenience
+     *
+     * The game is blocked only while the state is copied: the engine's state and GameObserver::snapshot() of each observer
+     * are taken under the lock, the copy and GameObserver::save() are written after it's released.
+     * Observers without snapshot() are saved under the lock. Concurrent calls are serialized.
      * @param writer writer to save state
      * @see init()
      */
@@ -312,14 +469,58 @@ public:
     /**
      * @brief Initializes the instance from the 'reader'
      *
-     * Note: DataReader does not denote reading errors, for example the library could read more or less data amount than available, implementation
+     * The data of other SaveFormat::VERSION, with checksum mismatch, for other players or observers count,
+     * with not valid indexes or cards is rejected before anything is restored.
+     * Note: DataReader does not denote reading errors, for example the library could read less data amount than available, implementation
      * of the interfaces should detect such errors and do not use invalid constructed engine.
+     *
+     * Readers of data in memory (DataReader::view(), e.g. MappedFileReader) are read with no copy of the saved data.
      * @param reader contains data saved
      * @param players players
      * @param observers game observers
+     * @return false if the data is rejected, the engine is not changed then
      * @see save()
      */
-    void init(DataReader& reader, const std::vector<Player*> players, const std::vector<GameObserver*>& observers);
+    bool init(DataReader& reader, const std::vector<Player*> players, const std::vector<GameObserver*>& observers);
+    /**
+     * @brief Initializes the instance as a copy of the `source` game
+     *
+     * In-memory alternative of save() and init(): cards, deck, table and round state are copied directly, no DataWriter/DataReader involved.
+     * The clone has its own player ids: the source's players are mapped to `players` by index, i.e. in the order they were added.
+     * Observers are notified as after init(), but nothing is restored into them - GameObserver::init() is not invoked.
+     * Could be invoked from the source's Player::attack(), Player::pitch() and Player::defend(): the clone continues from the same move,
+     * must not be invoked from Player::cardsUpdated() - the source is locked there.
+     * @param source game to copy, the deck should be set
+     * @param players players, same amount as in the `source`
+     * @param observers game observers
+     * @see init()
+     */
+    void clone(const Engine& source, const std::vector<Player*>& players, const std::vector<GameObserver*>& observers);
+    /**
+     * @brief Sets write-ahead journal of the moves
+     *
+     * Each move and each deal is appended to Journal::records() as JournalRecord, Journal::snapshot() is invoked
+     * before the first round started after the call and before each round with index divisible by `snapshotRounds`.
+     *
+     * Recovery: init() from the last snapshot, setJournal() with the same journal, then replay() with the records written after the snapshot.
+     * @param journal the journal, NULL to stop journaling
+     * @param snapshotRounds snapshot period in rounds, at least 1
+     */
+    void setJournal(Journal* journal, unsigned int snapshotRounds);
+    /**
+     * @brief Replays the journal records through the game
+     *
+     * The game should be restored from the snapshot the records were written after, see setJournal().
+     * The moves are played as by submit(): players and observers are notified the usual way, so they catch up with the game,
+     * the journal is not written and no snapshot is taken till the last record is reproduced.
+     * The game continues after the last record: the next decision is pending, see step().
+     *
+     * Note: as for init() the game should not be used if replay failed.
+     * @param reader the records
+     * @param records amount of complete records
+     * @return false if the game does not reproduce the records: the records are of other game or other snapshot
+     */
+    bool replay(DataReader& reader, unsigned int records);
     /**
      * @brief Requests quit
      *
@@ -328,6 +529,34 @@ public:
      * Basically this method should be invoked before all players stopped (returned from attack/pitch/defend)
      */
     void quit();
+    /**
+     * @brief Exports state of the current round into the simulation state
+     *
+     * Lets search bots branch from the running game: the state could be explored with sim::apply() and sim::undo().
+     * Seats are players in the order they were added. The deck in the state is the rest of the engine's deck.
+     * Could be invoked from Player::attack(), Player::pitch() and Player::defend(),
+     * must not be invoked from Player::cardsUpdated() - the engine is locked there.
+     * @param state the state to fill
+     * @return false if no round is being played or too many players for the simulation
+     */
+    bool exportState(sim::GameState& state) const;
+    /**
+     * @brief Returns public state of the game
+     *
+     * For monitoring and spectator threads: the state is published by the game thread before each player's decision
+     * and at the end of each round, the call never blocks the game and could be invoked at high frequency.
+     * For engine constructed with `threadSafe` false the state is built on the call, from the game thread only.
+     * @param state destination
+     */
+    void spectatorState(SpectatorState& state) const;
+    /**
+     * @brief Returns approximate amount of memory used by the game
+     *
+     * The instance, its buffers, the deck and the player ids; players and observers are not counted.
+     * Could be invoked between the moves only.
+     * @return amount of bytes
+     */
+    size_t memoryUsage() const;
 
 private:
 
@@ -338,14 +567,19 @@ private:
      */
     class PlayerIdImplementation: public PlayerId
     {
+    public:
         /**
-         * Id index
+         * @brief Ctor
+         * @param seat index of the player in mGeneratedIds
          */
-        const unsigned int mId;
-    public:
-        PlayerIdImplementation(unsigned int id);
+        PlayerIdImplementation(unsigned int seat);
     };
 
+    /**
+     * @brief Copy of the game state written by save()
+     */
+    class SavedGame;
+
     /**
      * @brief Function for std::for_each
      */
@@ -452,20 +686,130 @@ private:
         void operator()(GameObserver* observer);
     };
 
+    /**
+     * @brief Sets the deck and notifies the observers about the game start
+     * @param deck cards of the game, could be empty for restored game
+     */
+    void startGame(const Deck& deck);
+    /**
+     * @brief Notifies the observers about the game start with the cards of mDeck
+     */
+    void notifyGameStarted();
     /**
      * @brief Checks if the game is ended
      * @return true if ended
      */
     bool gameEnded() const;
     /**
-     * @brief Plays current round
-     * @return true if defended
+     * @brief Result of advance()
      */
-    bool playCurrentRound();
+    enum Progress
+    {
+        /**
+         * @brief mDecision is pending
+         */
+        PROGRESS_DECISION,
+        /**
+         * @brief The round ended, the game continues
+         */
+        PROGRESS_ROUND_ENDED,
+        /**
+         * @brief The game ended, could not be started or quit requested
+         */
+        PROGRESS_GAME_ENDED
+    };
+    /**
+     * @brief Plays the game till the player's decision or the end of the round
+     *
+     * The round state machine: applies submitted answer if any, then plays till the next decision.
+     * @return progress
+     */
+    Progress advance();
+    /**
+     * @brief Picks attackers and defender of new round and deals cards
+     */
+    void startRound();
+    /**
+     * @brief Plays answer of DECISION_ATTACK or DECISION_PITCH
+     * @param attackCardPtr the answer
+     * @param canPass true for DECISION_PITCH, NULL answer of DECISION_ATTACK is an invalid card
+     * @return false if the round ended
+     */
+    bool playAttackCard(const Card* attackCardPtr, bool canPass);
+    /**
+     * @brief Plays answer of DECISION_DEFEND
+     * @param defendCardPtr the answer
+     */
+    void playDefendCard(const Card* defendCardPtr);
+    /**
+     * @brief Passes the move to the next attacker
+     * @return false if all the attackers passed - the round ended
+     */
+    bool pass();
+    /**
+     * @brief Ends the round: table cards are picked up or gone, next round's player is picked
+     * @return PROGRESS_ROUND_ENDED or PROGRESS_GAME_ENDED
+     */
+    Progress endRound();
     /**
      * @brief Deals cards before playing round
      */
     void dealCards();
+    /**
+     * @brief Publishes the state for spectatorState(), game thread only
+     */
+    void publish();
+    /**
+     * @brief Fills the spectator state from the game state, game thread only
+     * @param state destination
+     */
+    void fillSpectatorState(SpectatorState& state) const;
+    /**
+     * @brief Appends the record to the journal, or checks it against the replayed record if replay is running
+     * @param type record type
+     * @param seat seat of the player
+     * @param action decision type for JOURNAL_DECISION
+     * @param card card index or amount, see JournalRecordType
+     */
+    void journal(JournalRecordType type, unsigned int seat, DecisionType action, unsigned int card);
+    /**
+     * @brief Returns amount of current round attackers which have cards
+     * @return amount of attackers
+     */
+    unsigned int attackersWithCards() const;
+    /**
+     * @brief Returns first of current round attackers which has cards
+     * @return attacker or `NULL` if no attacker has cards
+     */
+    const PlayerId* firstAttackerWithCards() const;
+    /**
+     * @brief Updates mSeatsWithCards after the player's cards changed
+     * @param seat seat of the player
+     */
+    void updateSeat(unsigned int seat);
+    /**
+     * @brief Buffers the event for event observers
+     * @param type event type
+     * @param player player of the event
+     * @param value round index or amount
+     * @param cards cards of the event
+     */
+    void post(GameEventType type, const PlayerId* player, unsigned int value, CardSet::Mask cards);
+    /**
+     * @brief Buffers the events of the game start or restore, see GameEventType
+     * @param type EVENT_GAME_STARTED or EVENT_GAME_RESTORED
+     * @param cards game cards for EVENT_GAME_STARTED
+     */
+    void postGameEvents(GameEventType type, const CardSet& cards);
+    /**
+     * @brief Passes buffered events to event observers
+     */
+    void flushEvents();
+    /**
+     * @brief Appends observers of the restored game and notifies all observers about the restored game
+     * @param observers game observers to add
+     */
+    void restored(const std::vector<GameObserver*>& observers);
     /**
      * @brief Locks the instance
      */
@@ -474,13 +818,6 @@ private:
      * @brief Unlocks the instance
      */
     void unlock() const;
-    /**
-     * @brief Finds card by pointer in the `cards`
-     * @param cards array to search
-     * @param card card to find
-     * @return true if the `card` in un the array
-     */
-    bool findByPtr(const CardSet& cards, const Card* card);
 };
 
 }
@@ -0,0 +1,123 @@
+#ifndef EVENTOBSERVER_H
+#define EVENTOBSERVER_H
+
+#include "cardSet.h"
+
+namespace decore
+{
+
+class PlayerId;
+
+/**
+ * @brief Type of the game event, see GameEvent
+ *
+ * Each type lists meaningful fields of the event, the rest fields are zero.
+ * Events with lists (players, attackers, table cards) are followed by one event per item.
+ */
+enum GameEventType
+{
+    /**
+     * @brief GameObserver::gameStarted(): `cards` - game cards, `suit` - trump suit, followed by EVENT_PLAYER per player
+     */
+    EVENT_GAME_STARTED,
+    /**
+     * @brief GameObserver::gameRestored(): `value` - deck cards amount, `suit` - trump suit,
+     * followed by EVENT_PLAYER per player, EVENT_TABLE_ATTACK_CARD and EVENT_TABLE_DEFEND_CARD per table card
+     */
+    EVENT_GAME_RESTORED,
+    /**
+     * @brief Player of the game: `player`, `value` - cards amount of the player (restored game only)
+     */
+    EVENT_PLAYER,
+    /**
+     * @brief Attack card on the table of restored game: `cards` - the card, in attack order
+     */
+    EVENT_TABLE_ATTACK_CARD,
+    /**
+     * @brief Defend card on the table of restored game: `cards` - the card, in defend order
+     */
+    EVENT_TABLE_DEFEND_CARD,
+    /**
+     * @brief GameObserver::roundStarted(): `value` - round index, `player` - defender, followed by EVENT_ATTACKER per attacker
+     */
+    EVENT_ROUND_STARTED,
+    /**
+     * @brief Attacker of the round: `player`
+     */
+    EVENT_ATTACKER,
+    /**
+     * @brief GameObserver::roundEnded(): `value` - round index
+     */
+    EVENT_ROUND_ENDED,
+    /**
+     * @brief GameObserver::cardsPickedUp(): `player`, `cards`
+     */
+    EVENT_CARDS_PICKED_UP,
+    /**
+     * @brief GameObserver::cardsDealed(): `player`, `value` - cards amount
+     */
+    EVENT_CARDS_DEALT,
+    /**
+     * @brief GameObserver::cardsGone(): `cards`
+     */
+    EVENT_CARDS_GONE,
+    /**
+     * @brief GameObserver::cardsDropped(): `player`, `cards`
+     */
+    EVENT_CARDS_DROPPED
+};
+
+/**
+ * @brief The game event
+ *
+ * Plain data, see GameEventType for the meaning of the fields.
+ */
+struct GameEvent
+{
+    /**
+     * @brief Cards of the event
+     */
+    CardSet::Mask cards;
+    /**
+     * @brief Player of the event
+     */
+    const PlayerId* player;
+    /**
+     * @brief Round index or amount
+     */
+    unsigned int value;
+    /**
+     * @brief Event type, see GameEventType
+     */
+    unsigned char type;
+    /**
+     * @brief Trump suit
+     */
+    unsigned char suit;
+};
+
+/**
+ * @brief Game flow observer which receives the events in batches
+ *
+ * Alternative of GameObserver for analytics and logging: same information, but one virtual call for many events.
+ * The engine buffers the events and passes them before each player's move and at the end of each round,
+ * see Engine::addEventObserver().
+ *
+ * Invoked from the thread of Engine::playRound().
+ */
+class EventObserver
+{
+public:
+    virtual ~EventObserver()
+    {}
+    /**
+     * @brief Game events since the previous invocation
+     * @param events events in the order they happened, valid during the call only
+     * @param amount amount of the events, not 0
+     */
+    virtual void events(const GameEvent* events, unsigned int amount) = 0;
+};
+
+}
+
+#endif /* EVENTOBSERVER_H */
@@ -95,10 +95,10 @@ class GameCardsTracker : public GameObserver
      */
     unsigned int mDeckCardsNumber;
     /**
-     * @brief Cards which player's have
+     * @brief Cards which player's have, in mPlayerIds order
      * @see playerCards()
      */
-    std::map<const PlayerId*, PlayerCards> mPlayersCards;
+    std::vector<PlayerCards> mPlayersCards;
     /**
      * @brief Table cards
      */
@@ -141,16 +141,45 @@ class GameCardsTracker : public GameObserver
      */
     std::vector<Card> mRestoredDefendCards;
 #endif // NDEBUG
+    /**
+     * @brief Copy of the saved data
+     */
+    class SavedState
+    {
+    public:
+        CardSet mGameCards;
+        Suit mTrumpSuit;
+        std::vector<PlayerCards> mPlayersCards;
+        CardSet mGoneCards;
+        unsigned int mLastRoundIndex;
+        std::vector<Card> mAttackCards;
+        std::vector<Card> mDefendCards;
+    };
+    /**
+     * @brief Data for the next save(), see snapshot()
+     */
+    SavedState mSnapshot;
+    /**
+     * @brief True if mSnapshot is taken for the next save()
+     */
+    bool mSnapshotTaken;
+
+    /**
+     * @brief Copies the tracked data
+     * @param state destination
+     */
+    void copyState(SavedState& state) const;
 public:
     GameCardsTracker();
 
     void gameStarted(const Suit &trumpSuit, const CardSet &cardSet, const std::vector<const PlayerId *>& players);
-    void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId *> attackers, const PlayerId *defender);
+    void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId *defender);
     void roundEnded(unsigned int roundIndex);
     void cardsPickedUp(const PlayerId *playerId, const CardSet &cardSet);
     void cardsDealed(const PlayerId *playerId, unsigned int cardsAmount);
     void cardsGone(const CardSet &cardSet);
     void cardsDropped(const PlayerId *playerId, const CardSet &cardSet);
+    bool snapshot();
     void save(DataWriter& writer);
     void init(DataReader& reader);
     void gameRestored(const std::vector<const PlayerId*>& playerIds,
@@ -212,17 +241,6 @@ public:
      * @return cards
      */
     const std::vector<Card>& defendCards() const;
-private:
-    /**
-     * @brief Function for std::for_each
-     */
-    class CardRemover
-    {
-        CardSet& mCards;
-    public:
-        CardRemover(CardSet& cards);
-        void operator()(const Card& card);
-    };
 };
 
 }
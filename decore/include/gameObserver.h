@@ -63,7 +63,7 @@ public:
      * @param attackers list of attackers' ids
      * @param defender defender's id
      */
-    virtual void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*> attackers, const PlayerId* defender) = 0;
+    virtual void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender) = 0;
     /**
      * @brief Current round ended
      * @param roundIndex index of the ended round
@@ -92,11 +92,26 @@ public:
      * @param cardSet cards
      */
     virtual void cardsDropped(const PlayerId* playerId, const CardSet& cardSet) = 0;
+    /**
+     * @brief Implementation can copy the internal data to be written by the next save()
+     *
+     * Invoked by Engine::save() under the engine's lock, right after the engine copied its own state, so the copy matches the game state.
+     * Should be cheap: the game waits for it. If the data is copied, save() is invoked after the lock is released and should
+     * write the copy: the game could go on meanwhile.
+     * Default implementation copies nothing: save() is invoked under the lock then.
+     * Invoked from other thread, Engine::save() calls do not overlap.
+     * @return true if the data is copied
+     * @see save()
+     */
+    virtual bool snapshot()
+    {
+        return false;
+    }
     /**
      * @brief Implementation can save its internal data to the `writer`
      *
      * Data written to the `writer` will be provided to init() with `reader` parameter.
-     * Invoked from other thread.
+     * Invoked from other thread, after snapshot(): under the engine's lock if snapshot() returned false.
      * @param writer data destination
      * @see init()
      */
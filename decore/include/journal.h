@@ -0,0 +1,103 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "dataWriter.h"
+
+namespace decore
+{
+
+class Engine;
+
+/**
+ * @brief Type of the journal record, see JournalRecord
+ */
+enum JournalRecordType
+{
+    /**
+     * @brief Player's move: `seat` - the player, `action` - DecisionType, `card` - index of the played card
+     * or JournalRecord::NO_CARD if the attacker passed or the defender picks up the table cards
+     */
+    JOURNAL_DECISION,
+    /**
+     * @brief Deal: `seat` - the player, `card` - amount of the dealt cards
+     */
+    JOURNAL_DEAL
+};
+
+/**
+ * @brief Record of the write-ahead journal
+ *
+ * Plain data of four bytes, written with DataWriter::write() as is.
+ */
+struct JournalRecord
+{
+    /**
+     * @brief `card` of JOURNAL_DECISION without card
+     */
+    static const unsigned char NO_CARD = 0xff;
+    /**
+     * @brief Record type, see JournalRecordType
+     */
+    unsigned char type;
+    /**
+     * @brief Seat of the player, see PlayerId::seat()
+     */
+    unsigned char seat;
+    /**
+     * @brief Decision type of JOURNAL_DECISION, see DecisionType
+     */
+    unsigned char action;
+    /**
+     * @brief Card index or amount, see JournalRecordType
+     */
+    unsigned char card;
+};
+
+/**
+ * @brief Storage of the write-ahead journal, see Engine::setJournal()
+ *
+ * The engine appends a few bytes per move and per deal to records() and takes full snapshot each N rounds,
+ * so crash safety costs are proportional to the moves, not to the game size.
+ * The game is recovered from the last snapshot with Engine::init() and the records after it with Engine::replay().
+ *
+ * Invoked from the thread of Engine::playRound() or Engine::step().
+ *
+ * Implementation example:
+ * @code
+ *     DataWriter& records()
+ *     {
+ *         return mJournalFile;
+ *     }
+ *     void snapshot(const Engine& engine)
+ *     {
+ *         engine.save(mSnapshotFile); // to the temporary file, renamed after flush
+ *         mJournalFile.truncate();
+ *     }
+ * @endcode
+ */
+class Journal
+{
+public:
+    virtual ~Journal()
+    {}
+    /**
+     * @brief Returns writer of the records, JournalRecord by JournalRecord
+     *
+     * The records are appended after the last snapshot. A torn last record (crash while writing)
+     * is dropped by recovery: only complete records are passed to Engine::replay().
+     * @return writer
+     */
+    virtual DataWriter& records() = 0;
+    /**
+     * @brief Saves the snapshot of the game between rounds and discards the records
+     *
+     * Invoked before the round with index divisible by the snapshot period starts. The snapshot should be written
+     * with Engine::save(), the records written before are not needed for recovery after that.
+     * @param engine the game
+     */
+    virtual void snapshot(const Engine& engine) = 0;
+};
+
+}
+
+#endif /* JOURNAL_H */
@@ -0,0 +1,50 @@
+#ifndef MAPPEDFILEREADER_H
+#define MAPPEDFILEREADER_H
+
+#include "bufferReader.h"
+
+namespace decore
+{
+
+/**
+ * @brief Reader of the file mapped into memory
+ *
+ * The file is not read into a buffer: pages are loaded by the OS on access, view() returns the bytes in place,
+ * so Engine::init() checks the saved game and restores observers with no copy of the data.
+ *
+ * Example:
+ * @code
+ *     MappedFileReader reader;
+ *     if (!reader.open(path) || !engine.init(reader, players, observers)) {
+ *         // no saved game or it's corrupted
+ *     }
+ * @endcode
+ */
+class MappedFileReader : public BufferReader
+{
+public:
+    MappedFileReader();
+    ~MappedFileReader();
+
+    /**
+     * @brief Maps the file and starts reading from its beginning, the file mapped before is unmapped
+     * @param path file path
+     * @return false if the file could not be opened or mapped
+     */
+    bool open(const char* path);
+    /**
+     * @brief Unmaps the file, the bytes returned by view() are not valid after that
+     */
+    void close();
+
+private:
+    MappedFileReader(const MappedFileReader&);
+    MappedFileReader& operator=(const MappedFileReader&);
+
+    void* mMapping;
+    unsigned int mMappingSize;
+};
+
+}
+
+#endif /* MAPPEDFILEREADER_H */
@@ -18,6 +18,10 @@ class Card;
  * To track the cards:
  * - remember list of the cards in Player::cardsUpdated()
  * - remove cards from the list in Player::attack(), Player::pitch() and Player::defend()
+ *
+ * Returned card should be the object from the `cardSet` (a reference obtained from the set's iterator), not a copy:
+ * the engine validates the move by the card address, see CardSet::contains().
+ * The set's cards are interned, see Card::interned(), so the pointers stay valid between the calls and could be cached.
  */
 class Player: public GameObserver
 {
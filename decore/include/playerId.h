@@ -11,6 +11,37 @@ namespace decore {
  */
 class PlayerId
 {
+    /**
+     * @brief Seat of the player
+     */
+    const unsigned int mSeat;
+public:
+    /**
+     * @brief Value of seat() of ids which are not generated by the Engine
+     */
+    static const unsigned int NO_SEAT = ~0u;
+    /**
+     * @brief Returns seat of the player
+     *
+     * The seat is index of the player in the game, in order players were added to the Engine:
+     * the engine and the observers use it to keep per player data in arrays.
+     * @return seat or NO_SEAT
+     */
+    unsigned int seat() const
+    {
+        return mSeat;
+    }
+protected:
+    PlayerId()
+        : mSeat(NO_SEAT)
+    {}
+    /**
+     * @brief Ctor
+     * @param seat seat of the player
+     */
+    explicit PlayerId(unsigned int seat)
+        : mSeat(seat)
+    {}
 };
 
 }
@@ -16,6 +16,8 @@ class PlayerIds : public std::vector<const PlayerId*>
 public:
     /**
      * @brief Returns index of the player id in the array
+     *
+     * O(1) if the id is at index PlayerId::seat(), as in arrays of all the players of the game
      * @param id player id
      * @return index
      */
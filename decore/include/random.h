@@ -0,0 +1,134 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+namespace decore
+{
+
+/**
+ * @brief The pseudo random generator
+ *
+ * xoshiro256** generator: 256 bits of state, a few register operations per number, no global state.
+ * So each thread could own its generator and same seed gives same sequence on any platform.
+ *
+ * For independent streams from one seed copy the generator and call jump() on the copy:
+ * the copy's sequence starts 2^128 numbers ahead, so the streams never overlap in practice.
+ *
+ * The generator is the generator for Deck::shuffle(Generator&).
+ */
+class Random
+{
+    /**
+     * @brief Generator state
+     */
+    uint64_t mState[4];
+
+public:
+    /**
+     * @brief Constructs the generator
+     * @param seed any value, the state is expanded from the seed with splitmix64
+     */
+    explicit Random(uint64_t seed);
+    /**
+     * @brief Returns next random number
+     * @return uniformly distributed 64 bit number
+     */
+    uint64_t next();
+    /**
+     * @brief Returns next random number in the range [0, bound)
+     *
+     * The number is unbiased, see Lemire's "Fast Random Integer Generation in an Interval"
+     * @param bound upper bound, not 0
+     * @return uniformly distributed number less than `bound`
+     */
+    unsigned int next(unsigned int bound);
+    /**
+     * @brief Returns next random number in the range [0, bound)
+     *
+     * Same as next(unsigned int), makes the generator usable as RandomNumberGenerator of std::random_shuffle()
+     * @param bound upper bound, not 0
+     * @return uniformly distributed number less than `bound`
+     */
+    unsigned int operator()(unsigned int bound);
+    /**
+     * @brief Advances the generator by 2^128 numbers
+     */
+    void jump();
+    /**
+     * @brief Advances the generator by 2^192 numbers
+     *
+     * The streams made with jump() from the long jumped generators do not overlap
+     */
+    void longJump();
+
+    /**
+     * @brief One step of splitmix64 generator
+     *
+     * Good 64 bit mixing function: distinct inputs give well distributed outputs.
+     * @param state generator state, is advanced
+     * @return random number
+     */
+    static uint64_t splitMix(uint64_t& state);
+
+private:
+    /**
+     * @brief Advances the generator with the jump polynomial
+     * @param polynomial jump polynomial
+     */
+    void jump(const uint64_t* polynomial);
+};
+
+/**
+ * @brief The counter based pseudo random generator
+ *
+ * N-th number is a keyed hash of N: no sequential state, any number of any stream is computed directly, see at().
+ * The key is derived from the seed and the stream, e.g. run seed and game index,
+ * so the numbers of a stream do not depend on the order the streams are processed in.
+ */
+class CounterRandom
+{
+    /**
+     * @brief Key of the stream
+     */
+    uint64_t mKey;
+    /**
+     * @brief Index of the next number
+     */
+    uint64_t mCounter;
+
+public:
+    /**
+     * @brief Constructs the generator
+     * @param seed any value
+     * @param stream any value, distinct streams of the seed give distinct sequences
+     */
+    CounterRandom(uint64_t seed, uint64_t stream);
+    /**
+     * @brief Returns the number with the index
+     * @param counter index of the number
+     * @return uniformly distributed 64 bit number
+     */
+    uint64_t at(uint64_t counter) const;
+    /**
+     * @brief Returns next random number, i.e. at() of the next index
+     * @return uniformly distributed 64 bit number
+     */
+    uint64_t next();
+    /**
+     * @brief Returns next random number in the range [0, bound)
+     * @param bound upper bound, not 0
+     * @return uniformly distributed number less than `bound`
+     */
+    unsigned int next(unsigned int bound);
+    /**
+     * @brief Returns next random number in the range [0, bound), same as next(unsigned int)
+     * @param bound upper bound, not 0
+     * @return uniformly distributed number less than `bound`
+     */
+    unsigned int operator()(unsigned int bound);
+};
+
+}
+
+#endif // RANDOM_H
@@ -5,10 +5,10 @@
 #include <map>
 
 #include "card.h"
+#include "cardSet.h"
 
 namespace decore {
 
-class CardSet;
 class PlayerId;
 class Deck;
 
@@ -17,12 +17,25 @@ class Deck;
  *
  * To avoid populating game rules all over namespace's classes this class is designed as a game rules global junk.
  * Game rules is not intended to change so static reference looks OK.
+ *
+ * None of the methods allocate: CardSet is a mask, so it is cheap to return by value or to pass as result parameter.
  */
 class Rules {
 
+public:
+    /**
+     * @brief Set of seats, bit `i` stands for PlayerId::seat() `i`
+     */
+    typedef uint64_t Seats;
+    /**
+     * @brief Max amount of seats in Seats
+     */
+    static const unsigned int MAX_SEATS = 64;
+    /**
+     * @brief Amount of cards the players are dealt up to, see deal()
+     */
     static const unsigned int MAX_PLAYER_CARDS;
 
-public:
     /**
      * @brief Returns possible cards for attack move
      *
@@ -32,6 +45,24 @@ public:
      * @return possible cards
      */
     static CardSet getAttackCards(const CardSet& tableCards, const CardSet& playerCards);
+    /**
+     * @brief Returns possible cards for attack move
+     *
+     * Return all playerCards if tableRanks is 0
+     * @param tableRanks ranks of the cards on the game table, see CardSet::ranks()
+     * @param playerCards attacker's cards
+     * @return possible cards
+     */
+    static CardSet getAttackCards(unsigned int tableRanks, const CardSet& playerCards);
+    /**
+     * @brief Writes possible cards for attack move to `attackCards`
+     *
+     * Writes all playerCards if tableRanks is 0, previous content of `attackCards` is replaced
+     * @param tableRanks ranks of the cards on the game table, see CardSet::ranks()
+     * @param playerCards attacker's cards
+     * @param attackCards possible cards
+     */
+    static void getAttackCards(unsigned int tableRanks, const CardSet& playerCards, CardSet& attackCards);
     /**
      * @brief Returns possible cards for defend move
      * @param card card to beat
@@ -40,6 +71,25 @@ public:
      * @return possible cards
      */
     static CardSet getDefendCards(const Card& card, const CardSet& playerCards, const Suit& trumpSuit);
+    /**
+     * @brief Writes possible cards for defend move to `defendCards`
+     *
+     * Previous content of `defendCards` is replaced
+     * @param card card to beat
+     * @param playerCards defender's cards
+     * @param trumpSuit trump suit
+     * @param defendCards possible cards
+     */
+    static void getDefendCards(const Card& card, const CardSet& playerCards, const Suit& trumpSuit, CardSet& defendCards);
+    /**
+     * @brief Returns mask of all cards which beat the `card`
+     *
+     * The masks are precomputed once, so possible defend cards are `beats(card, trumpSuit) & playerCards.mask()`
+     * @param card card to beat
+     * @param trumpSuit trump suit, SUIT_LAST if there's no trump
+     * @return mask of the cards
+     */
+    static CardSet::Mask beats(const Card& card, const Suit& trumpSuit);
     /**
      * @brief Returns next player in the player queue after the player
      * @param playersList list of the player
@@ -48,6 +98,29 @@ public:
      * @return next player id
      */
     static const PlayerId *pickNext(const std::vector<const PlayerId *> &playersList, const PlayerId *after, const std::map<const PlayerId*, CardSet>* playersCards = NULL);
+    /**
+     * @brief Returns next player in the player queue after the player
+     * @param playersList list of the player
+     * @param after defines player id
+     * @param seatsCards player cards indexed by PlayerId::seat(), all players are picked if NULL
+     * @return next player id
+     */
+    static const PlayerId *pickNext(const std::vector<const PlayerId *> &playersList, const PlayerId *after, const std::vector<CardSet>* seatsCards);
+    /**
+     * @brief Returns next seat of the set after the seat, in seat order
+     *
+     * Same as pickNext() for the list of all players in seat order, but a few bit operations
+     * @param seats set of seats to pick from
+     * @param after the seat, could be out of the set, never picked itself
+     * @return next seat or PlayerId::NO_SEAT if the set has no other seats
+     */
+    static unsigned int nextSeat(Seats seats, unsigned int after);
+    /**
+     * @brief Returns set of the seats with `seats` amount of players
+     * @param seats amount of players, up to MAX_SEATS
+     * @return set of the seats
+     */
+    static Seats allSeats(unsigned int seats);
     /**
      * @brief Deals cards from the set to the players up to MAX_PLAYER_CARDS
      *
@@ -67,29 +140,14 @@ public:
 
 private:
     /**
-     * @brief Function for std::for_each
-     */
-    class DefendCardFilter
-    {
-        const Card& mCardToBeat;
-        const Suit& mTrump;
-        CardSet& mResult;
-
-    public:
-        DefendCardFilter(const Card& cardToBeat, const Suit& trump, CardSet& result);
-        void operator()(const Card& playerCard);
-    };
-
-    /**
-     * @brief Function for std::for_each
+     * @brief Masks of the cards which beat a card, see beats()
      */
-    class AttackCardFilter
+    class BeatsTable
     {
-        const CardSet& mPlayerCards;
-        CardSet& mResult;
+        CardSet::Mask mBeats[SUIT_LAST + 1][CardSet::CARDS];
     public:
-        AttackCardFilter(const CardSet& playerCards, CardSet& result);
-        void operator()(const Card& tableCard);
+        BeatsTable();
+        CardSet::Mask beats(const Card& card, const Suit& trumpSuit) const;
     };
 };
 
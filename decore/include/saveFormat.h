@@ -0,0 +1,85 @@
+#ifndef SAVEFORMAT_H
+#define SAVEFORMAT_H
+
+#include <stdint.h>
+
+#include "card.h"
+#include "dataWriter.h"
+#include "dataReader.h"
+
+namespace decore
+{
+
+/**
+ * @brief Layout of the data written by Engine::save()
+ *
+ * The data is same on any platform: numbers are little-endian four bytes (DataWriter::writeUint32()),
+ * flags, suits and cards (Card::index()) are one byte.
+ *
+ *      header:     MAGIC, VERSION, payload size, CRC-32 of the payload
+ *      payload:    engine section size, engine section
+ *                  observers count, for each observer: section size, GameObserver::save() data
+ *
+ * Engine::init() rejects data of other version or with checksum mismatch, the sizes of the sections
+ * let readers to skip the data they do not need.
+ */
+class SaveFormat
+{
+public:
+    /**
+     * @brief First four bytes of the saved game, "DCSV"
+     */
+    static const uint32_t MAGIC = 0x56534344;
+    /**
+     * @brief Version of the layout, incremented on any change
+     */
+    static const uint32_t VERSION = 1;
+    /**
+     * @brief Size of the header in bytes
+     */
+    static const unsigned int HEADER_SIZE = 16;
+    /**
+     * @brief Max size of the payload in bytes
+     *
+     * The size in the header is not covered by the checksum: larger sizes are rejected before the payload is read.
+     */
+    static const uint32_t MAX_PAYLOAD_SIZE = 16 * 1024 * 1024;
+
+    /**
+     * @brief Calculates CRC-32 (IEEE 802.3) of the data
+     * @param data pointer to the first byte
+     * @param dataSizeBytes size of the data in bytes
+     * @return checksum
+     */
+    static uint32_t crc32(const void* data, unsigned int dataSizeBytes);
+
+    /**
+     * @brief Writes cards: amount and the card indexes
+     *
+     * The card is its index byte, so the cards of Deck or std::vector are written with single copy.
+     * @param writer destination
+     * @param begin first card
+     * @param end end of the cards
+     */
+    template<typename T>
+    static void writeCards(DataWriter& writer, T begin, T end)
+    {
+        writer.writeUint32(std::distance(begin, end));
+        writer.writeElements(begin, end);
+    }
+
+    /**
+     * @brief Reads cards written by writeCards() to the end of the `container`
+     * @param reader source
+     * @param container destination
+     */
+    template<typename T>
+    static void readCards(DataReader& reader, T& container)
+    {
+        reader.readElements(container, reader.readUint32(), Card(SUIT_LAST, RANK_LAST));
+    }
+};
+
+}
+
+#endif /* SAVEFORMAT_H */
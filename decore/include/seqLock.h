@@ -0,0 +1,124 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <string.h>
+#include <stdint.h>
+
+#include "atomic.h"
+
+namespace decore
+{
+
+/**
+ * @brief Value published by one writer thread to any amount of reader threads
+ *
+ * Sequence lock: the writer never waits for the readers, the readers never block the writer
+ * and retry the read if the value was being stored meanwhile. Suits small values updated often and polled often.
+ *
+ * Lock-free with GCC/Clang atomic builtins, T should be trivially copyable.
+ * Other compilers get the mutex based implementation, see Atomic.
+ */
+template <typename T>
+class SeqLock
+{
+#ifdef DECORE_ATOMIC_MUTEX
+    mutable pthread_mutex_t mLock;
+    T mData;
+#else
+    /**
+     * @brief Size of the value in words
+     */
+    static const unsigned int WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    /**
+     * @brief Odd while the value is being stored
+     */
+    uint64_t mSequence;
+    /**
+     * @brief The value, accessed word by word with atomic builtins
+     */
+    uint64_t mWords[WORDS];
+#endif
+
+public:
+    explicit SeqLock(const T& initialValue)
+    {
+#ifdef DECORE_ATOMIC_MUTEX
+        pthread_mutex_init(&mLock, NULL);
+        mData = initialValue;
+#else
+        mSequence = 0;
+        memset(mWords, 0, sizeof(mWords));
+        memcpy(mWords, &initialValue, sizeof(T));
+#endif
+    }
+    ~SeqLock()
+    {
+#ifdef DECORE_ATOMIC_MUTEX
+        pthread_mutex_destroy(&mLock);
+#endif
+    }
+
+    /**
+     * @brief Stores the value, one writer thread at a time
+     * @param value value to store
+     */
+    void store(const T& value)
+    {
+#ifdef DECORE_ATOMIC_MUTEX
+        pthread_mutex_lock(&mLock);
+        mData = value;
+        pthread_mutex_unlock(&mLock);
+#else
+        uint64_t words[WORDS];
+        words[WORDS - 1] = 0;
+        memcpy(words, &value, sizeof(T));
+        const uint64_t sequence = __atomic_load_n(&mSequence, __ATOMIC_RELAXED);
+        __atomic_store_n(&mSequence, sequence + 1, __ATOMIC_RELAXED);
+        // the odd sequence is visible before any word
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        for (unsigned int i = 0; i < WORDS; ++i) {
+            __atomic_store_n(&mWords[i], words[i], __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&mSequence, sequence + 2, __ATOMIC_RELEASE);
+#endif
+    }
+
+    /**
+     * @brief Loads the value, from any thread
+     * @param value destination
+     */
+    void load(T& value) const
+    {
+#ifdef DECORE_ATOMIC_MUTEX
+        pthread_mutex_lock(&mLock);
+        value = mData;
+        pthread_mutex_unlock(&mLock);
+#else
+        uint64_t words[WORDS];
+        for (;;) {
+            const uint64_t sequence = __atomic_load_n(&mSequence, __ATOMIC_ACQUIRE);
+            if (sequence & 1) {
+                // being stored
+                continue;
+            }
+            for (unsigned int i = 0; i < WORDS; ++i) {
+                words[i] = __atomic_load_n(&mWords[i], __ATOMIC_RELAXED);
+            }
+            // the words are read before the sequence is checked again
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&mSequence, __ATOMIC_RELAXED) == sequence) {
+                break;
+            }
+        }
+        memcpy(&value, words, sizeof(T));
+#endif
+    }
+
+private:
+    SeqLock(const SeqLock&);
+    SeqLock& operator=(const SeqLock&);
+};
+
+}
+
+#endif /* SEQLOCK_H */
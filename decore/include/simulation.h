@@ -0,0 +1,314 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "cardSet.h"
+
+namespace decore {
+
+class Deck;
+
+/**
+ * @brief Headless game core for self-play and search
+ *
+ * Game is a plain value: GameState is POD, players are seats (indexes), moves are small values.
+ * No players callbacks, no observers, no locks, no allocations: legalMoves() lists the moves of the player
+ * to move and apply() makes the move.
+ *
+ * The rules are the rules of Engine::playRound(): same roles picking, deal order, attack and defend cards and
+ * round end conditions. A game played with same deck and same decisions ends identically in both.
+ *
+ * Usage example:
+ * @code
+ *     sim::GameState state;
+ *     sim::init(state, deck, 3);
+ *     sim::Move moves[sim::MAX_MOVES];
+ *     while (!sim::ended(state)) {
+ *         unsigned int movesAmount = sim::legalMoves(state, moves);
+ *         sim::apply(state, moves[pickMove(state, moves, movesAmount)]);
+ *     }
+ *     unsigned int loser = sim::loser(state);
+ * @endcode
+ */
+namespace sim {
+
+/**
+ * @brief Max amount of players
+ */
+static const unsigned int MAX_PLAYERS = 6;
+/**
+ * @brief Max amount of attack cards in the round
+ */
+static const unsigned int MAX_TABLE_CARDS = 6;
+/**
+ * @brief Max amount of legal moves: card moves and pass or take
+ */
+static const unsigned int MAX_MOVES = CardSet::CARDS + 1;
+/**
+ * @brief Not valid seat
+ */
+static const unsigned char NO_SEAT = 0xff;
+
+/**
+ * @brief The phase of the game
+ */
+enum Phase
+{
+    /**
+     * @brief Attacker's move: attack card or pass
+     */
+    PHASE_ATTACK,
+    /**
+     * @brief Defender's move: defend card or take
+     */
+    PHASE_DEFEND,
+    /**
+     * @brief Game ended
+     */
+    PHASE_ENDED
+};
+
+/**
+ * @brief The move type
+ */
+enum MoveType
+{
+    /**
+     * @brief Attack or defend with the card
+     */
+    MOVE_CARD,
+    /**
+     * @brief Attacker ends its attack, Player::pitch() returned NULL
+     */
+    MOVE_PASS,
+    /**
+     * @brief Defender takes the table cards, Player::defend() returned NULL
+     */
+    MOVE_TAKE
+};
+
+/**
+ * @brief The move
+ */
+struct Move
+{
+    /**
+     * @brief Move type, see MoveType
+     */
+    unsigned char type;
+    /**
+     * @brief Card index for MOVE_CARD, see Card::index()
+     */
+    unsigned char card;
+};
+
+/**
+ * @brief The game state
+ *
+ * Plain data: could be copied with memcpy, compared with memcmp, stored in arrays.
+ * Cards are CardSet masks and card indexes, see Card::index().
+ */
+struct GameState
+{
+    /**
+     * @brief Cards of each seat
+     */
+    CardSet::Mask hands[MAX_PLAYERS];
+    /**
+     * @brief Cards on the table, attack and defend
+     */
+    CardSet::Mask table;
+    /**
+     * @brief Deck cards, top card is deck[deckTop]
+     */
+    unsigned char deck[CardSet::CARDS];
+    /**
+     * @brief Amount of cards in deck[]
+     */
+    unsigned char deckSize;
+    /**
+     * @brief Index of the top card in deck[]
+     */
+    unsigned char deckTop;
+    /**
+     * @brief Trump suit
+     */
+    unsigned char trumpSuit;
+    /**
+     * @brief Amount of players
+     */
+    unsigned char players;
+    /**
+     * @brief Game phase, see Phase
+     */
+    unsigned char phase;
+    /**
+     * @brief First attacker of the round, is the first in the deal order
+     */
+    unsigned char currentPlayer;
+    /**
+     * @brief Defender seat
+     */
+    unsigned char defender;
+    /**
+     * @brief Attackers of the round, the first is currentPlayer
+     */
+    unsigned char attackers[MAX_PLAYERS];
+    /**
+     * @brief Amount of attackers
+     */
+    unsigned char attackersAmount;
+    /**
+     * @brief Seat of the attacker to move
+     */
+    unsigned char attacker;
+    /**
+     * @brief Passes counter, see Engine::playCurrentRound()
+     */
+    unsigned char passed;
+    /**
+     * @brief Max amount of attack cards in the round
+     */
+    unsigned char maxAttackCards;
+    /**
+     * @brief Attack cards of the round in the order of the moves
+     */
+    unsigned char attackCards[MAX_TABLE_CARDS];
+    /**
+     * @brief Defend cards of the round in the order of the moves
+     */
+    unsigned char defendCards[MAX_TABLE_CARDS];
+    /**
+     * @brief Amount of attack cards
+     */
+    unsigned char attackCardsAmount;
+    /**
+     * @brief Amount of defend cards
+     */
+    unsigned char defendCardsAmount;
+    /**
+     * @brief Table ranks, see CardSet::ranks()
+     */
+    unsigned short tableRanks;
+    /**
+     * @brief True if the defender takes the cards, attackers may pitch the rest of the attack cards
+     */
+    bool defendFailed;
+    /**
+     * @brief Round index, same as Engine's
+     */
+    unsigned int roundIndex;
+};
+
+/**
+ * @brief Undo record of a move, see apply(GameState&, const Move&, Undo&)
+ *
+ * Keeps only the state parts the move could change besides the hands: the hands are restored from the deck
+ * and the table, so a record is a few dozen bytes.
+ */
+struct Undo
+{
+    /**
+     * @brief Table cards before the move
+     */
+    CardSet::Mask table;
+    /**
+     * @brief Round index before the move
+     */
+    unsigned int roundIndex;
+    /**
+     * @brief The move
+     */
+    Move move;
+    // GameState fields before the move
+    unsigned char phase;
+    unsigned char deckTop;
+    unsigned char currentPlayer;
+    unsigned char defender;
+    unsigned char attacker;
+    unsigned char passed;
+    unsigned char maxAttackCards;
+    unsigned char attackersAmount;
+    unsigned char attackCardsAmount;
+    unsigned char defendCardsAmount;
+    bool defendFailed;
+    unsigned short tableRanks;
+    unsigned char attackers[MAX_PLAYERS];
+    unsigned char attackCards[MAX_TABLE_CARDS];
+    unsigned char defendCards[MAX_TABLE_CARDS];
+};
+
+/**
+ * @brief Starts the game
+ *
+ * Seat 0 is the first attacker, as the first player added to the Engine. The first round is started: roles picked, cards dealt.
+ * @param state state to initialize
+ * @param deck game cards, at most CardSet::CARDS cards; deck's trump suit is the game trump suit
+ * @param players amount of players, from 2 to MAX_PLAYERS
+ */
+void init(GameState& state, const Deck& deck, unsigned int players);
+/**
+ * @brief Lists legal moves of the player to move, see toMove()
+ *
+ * Card moves are in Card::operator< order, pass or take is the last one.
+ * - attack: attack cards, pass is legal if the table is not empty or there's no attack cards
+ * - defend: defend cards and take
+ * @param state game state
+ * @param moves destination, at least MAX_MOVES items
+ * @return amount of the moves, 0 if the game ended
+ */
+unsigned int legalMoves(const GameState& state, Move* moves);
+/**
+ * @brief Makes the move
+ *
+ * The move should be legal, see legalMoves(). Round ends, deals and next round starts are applied with the move.
+ * @param state game state
+ * @param move move to make
+ */
+void apply(GameState& state, const Move& move);
+/**
+ * @brief Makes the move and fills the undo record
+ *
+ * Make/unmake for tree search: try a move, look deeper and take it back with undo(), no allocations.
+ * @param state game state
+ * @param move move to make
+ * @param record undo record of the move
+ */
+void apply(GameState& state, const Move& move, Undo& record);
+/**
+ * @brief Takes back the move
+ *
+ * Moves should be taken back in reverse order: the state should be the one the record's move led to.
+ * @param state game state
+ * @param record undo record of the last move
+ */
+void undo(GameState& state, const Undo& record);
+/**
+ * @brief Returns the seat to move
+ * @param state game state
+ * @return attacker or defender seat, NO_SEAT if the game ended
+ */
+unsigned int toMove(const GameState& state);
+/**
+ * @brief Checks if the game ended
+ * @param state game state
+ * @return true if ended
+ */
+bool ended(const GameState& state);
+/**
+ * @brief Returns the loser, see Engine::getLoser()
+ * @param state game state
+ * @return the only seat with cards, NO_SEAT otherwise
+ */
+unsigned int loser(const GameState& state);
+/**
+ * @brief Returns amount of the deck cards
+ * @param state game state
+ * @return amount of cards
+ */
+unsigned int deckCards(const GameState& state);
+
+}
+
+}
+
+#endif // SIMULATION_H
@@ -0,0 +1,78 @@
+#ifndef SPECTATORSTATE_H
+#define SPECTATORSTATE_H
+
+#include "suit.h"
+#include "rules.h"
+
+namespace decore
+{
+
+/**
+ * @brief Public state of the game for spectators and monitoring, see Engine::spectatorState()
+ *
+ * Plain data: what any spectator of the table sees. Players are identified by PlayerId::seat(),
+ * cards by Card::index(), see Card::interned().
+ */
+struct SpectatorState
+{
+    /**
+     * @brief Max amount of attack cards on the table, see Rules::maxAttackCards()
+     */
+    static const unsigned int MAX_TABLE_CARDS = 6;
+    /**
+     * @brief Incremented each time the state is published
+     */
+    unsigned int version;
+    /**
+     * @brief Amount of players
+     */
+    unsigned int players;
+    /**
+     * @brief Cards amount of each player by seat
+     */
+    unsigned char playersCards[Rules::MAX_SEATS];
+    /**
+     * @brief Cards amount in the deck
+     */
+    unsigned int deckCards;
+    /**
+     * @brief Trump suit
+     */
+    Suit trumpSuit;
+    /**
+     * @brief Current or next round index
+     */
+    unsigned int roundIndex;
+    /**
+     * @brief Seat of the current attacker, PlayerId::NO_SEAT if no round is being played
+     */
+    unsigned int attacker;
+    /**
+     * @brief Seat of the defender, PlayerId::NO_SEAT if no round is being played
+     */
+    unsigned int defender;
+    /**
+     * @brief Amount of the attack cards on the table
+     */
+    unsigned int attackCardsAmount;
+    /**
+     * @brief Amount of the defend cards on the table, the defend card beats the attack card with the same index
+     */
+    unsigned int defendCardsAmount;
+    /**
+     * @brief Attack cards on the table, in attack order
+     */
+    unsigned char attackCards[MAX_TABLE_CARDS];
+    /**
+     * @brief Defend cards on the table, in defend order
+     */
+    unsigned char defendCards[MAX_TABLE_CARDS];
+    /**
+     * @brief True if the game ended
+     */
+    bool ended;
+};
+
+}
+
+#endif /* SPECTATORSTATE_H */
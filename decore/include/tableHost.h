@@ -0,0 +1,295 @@
+#ifndef TABLEHOST_H
+#define TABLEHOST_H
+
+#include <vector>
+#include <deque>
+#include <pthread.h>
+#include <stdint.h>
+
+#include "engine.h"
+#include "decision.h"
+#include "rules.h"
+
+namespace decore
+{
+
+class Player;
+class Deck;
+
+/**
+ * @brief Receives decisions and results of TableHost games
+ *
+ * Invoked from the host's worker threads concurrently, without the host's lock:
+ * TableHost::submit() could be invoked right from the callback.
+ */
+class TableListener
+{
+public:
+    virtual ~TableListener()
+    {}
+    /**
+     * @brief The table waits for the decision of the external player
+     * @param table table id
+     * @param decision the decision, its player is one of the table's external seats
+     */
+    virtual void decisionPending(unsigned int table, const Decision& decision) = 0;
+    /**
+     * @brief The game of the table ended
+     * @param table table id
+     * @param loser loser or NULL in case of draw
+     */
+    virtual void tableEnded(unsigned int table, const PlayerId* loser) = 0;
+};
+
+/**
+ * @brief Hosts many games on a pool of threads
+ *
+ * Each table is an Engine driven by Engine::step(). Decisions of the bots - in-process players - are asked from the worker threads,
+ * decisions of the external seats (remote or human players) park the table till TableHost::submit() is invoked with the answer:
+ * no thread waits for them.
+ *
+ * Scheduling is fair: ready tables are queued in FIFO order and a worker plays up to the quantum of bot decisions
+ * of a table before it is queued again, see setQuantum().
+ *
+ * Each table is played by one worker at a time, so its players and observers are invoked from one thread at a time,
+ * but not always from the same thread.
+ *
+ * Usage example:
+ * @code
+ *     TableHost host(listener, 8);
+ *     unsigned int table = host.addTable(players, 1 << humanSeat, deck);
+ *     ...
+ *     // from the listener or the network thread
+ *     host.submit(table, &card);
+ * @endcode
+ */
+class TableHost
+{
+    /**
+     * @brief State of a table
+     */
+    enum TableState
+    {
+        /**
+         * @brief Queued for a worker
+         */
+        TABLE_QUEUED,
+        /**
+         * @brief Played by a worker
+         */
+        TABLE_RUNNING,
+        /**
+         * @brief Waits for the external player
+         */
+        TABLE_PARKED,
+        /**
+         * @brief The game ended
+         */
+        TABLE_ENDED
+    };
+
+    /**
+     * @brief A game of the host
+     */
+    class Table
+    {
+    public:
+        Table(unsigned int id, const std::vector<Player*>& players, Rules::Seats externalSeats);
+        /**
+         * @brief Table id
+         */
+        const unsigned int mId;
+        /**
+         * @brief The game, not locked: the host guarantees single thread access
+         */
+        Engine mEngine;
+        /**
+         * @brief Players by seat
+         */
+        std::vector<Player*> mPlayers;
+        /**
+         * @brief Seats of the external players
+         */
+        const Rules::Seats mExternalSeats;
+        /**
+         * @brief Table state, guarded by the host's lock
+         */
+        TableState mState;
+        /**
+         * @brief Pending decision of the external player, guarded by the host's lock
+         */
+        Decision mDecision;
+        /**
+         * @brief Approximate memory usage, updated by the worker, guarded by the host's lock
+         */
+        size_t mMemory;
+        /**
+         * @brief Amount of listener callbacks running for the table, guarded by the host's lock
+         */
+        unsigned int mNotifying;
+        /**
+         * @brief True if removed while the listener is notified: deleted after the callback, guarded by the host's lock
+         */
+        bool mRemoved;
+    };
+
+    TableListener& mListener;
+    /**
+     * @brief Tables by id, NULL for removed tables, guarded by mLock
+     */
+    std::vector<Table*> mTables;
+    /**
+     * @brief Tables ready for the workers, guarded by mLock
+     */
+    std::deque<Table*> mQueue;
+    /**
+     * @brief Amount of tables queued, running or being notified to the listener, guarded by mLock
+     */
+    unsigned int mActive;
+    /**
+     * @brief Memory usage of all the tables, guarded by mLock
+     */
+    size_t mMemory;
+    /**
+     * @brief Max amount of bot decisions per table in a row, guarded by mLock
+     */
+    unsigned int mQuantum;
+    /**
+     * @brief True if the workers should finish, guarded by mLock
+     */
+    bool mStop;
+    mutable pthread_mutex_t mLock;
+    /**
+     * @brief Signaled when a table is queued
+     */
+    pthread_cond_t mQueued;
+    /**
+     * @brief Signaled when no table is queued or running
+     */
+    pthread_cond_t mIdle;
+    /**
+     * @brief Started workers
+     */
+    std::vector<pthread_t> mThreads;
+
+public:
+    /**
+     * @brief Ctor, starts the workers
+     * @param listener listener of the tables
+     * @param threads amount of worker threads, at least one
+     * @see threads()
+     */
+    TableHost(TableListener& listener, unsigned int threads);
+    /**
+     * @brief Dtor, stops the workers and deletes the tables
+     *
+     * Tables being played are finished with the current quantum.
+     */
+    ~TableHost();
+    /**
+     * @brief Sets max amount of bot decisions a table plays before other queued tables
+     *
+     * Smaller quantum gives fair latency to all the tables, bigger one gives less scheduling overhead. 1 by default.
+     * @param quantum decisions amount, at least 1
+     */
+    void setQuantum(unsigned int quantum);
+    /**
+     * @brief Returns amount of started workers
+     *
+     * Less than requested if the system could not start the threads, the tables are not played if none started.
+     * @return amount of threads
+     */
+    unsigned int threads() const;
+    /**
+     * @brief Adds the table and queues it
+     * @param players players by seat, at least two, should outlive the table
+     * @param externalSeats seats of the external players, the rest of the players are bots
+     * @param deck deck of the game
+     * @return table id
+     */
+    unsigned int addTable(const std::vector<Player*>& players, Rules::Seats externalSeats, const Deck& deck);
+    /**
+     * @brief Submits the external player's answer and queues the table
+     *
+     * Thread safe.
+     * @param table table id
+     * @param card the answer, see Engine::submit()
+     * @return false if the table does not wait for the external player
+     */
+    bool submit(unsigned int table, const Card* card);
+    /**
+     * @brief Returns pending decision of the external player
+     *
+     * Thread safe.
+     * @param table table id
+     * @param decision destination
+     * @return false if the table does not wait for the external player
+     */
+    bool pending(unsigned int table, Decision& decision) const;
+    /**
+     * @brief Checks if the game of the table ended
+     *
+     * Thread safe.
+     * @param table table id
+     * @return true if ended
+     */
+    bool ended(unsigned int table) const;
+    /**
+     * @brief Deletes the table
+     *
+     * Only parked and ended tables could be removed. Thread safe.
+     * The table could be removed from the listener's callback: it's deleted when the callback returns,
+     * so the PlayerId pointers passed to the callback stay valid during the call.
+     * @param table table id
+     * @return false if the table is queued or being played
+     */
+    bool removeTable(unsigned int table);
+    /**
+     * @brief Returns approximate memory usage of the table, see Engine::memoryUsage()
+     *
+     * Updated when the table is parked or queued. Thread safe.
+     * @param table table id
+     * @return amount of bytes
+     */
+    size_t tableMemory(unsigned int table) const;
+    /**
+     * @brief Returns approximate memory usage of all the tables
+     *
+     * Sum of tableMemory() of all the tables. Thread safe.
+     * @return amount of bytes
+     */
+    size_t memory() const;
+    /**
+     * @brief Waits till no table is queued or being played: all the tables are parked or ended and the listener is notified
+     */
+    void wait();
+
+private:
+    /**
+     * @brief Thread function
+     * @param data TableHost
+     */
+    static void* workerThread(void* data);
+    /**
+     * @brief Worker loop
+     */
+    void work();
+    /**
+     * @brief Plays bot decisions of the table up to the quantum
+     * @param table the table
+     * @param quantum max amount of decisions
+     * @param decision destination for the external player's decision
+     * @return new state of the table
+     */
+    static TableState play(Table& table, unsigned int quantum, Decision& decision);
+    /**
+     * @brief Returns the table
+     * @param table table id
+     * @return the table, NULL if removed
+     */
+    Table* find(unsigned int table) const;
+};
+
+}
+
+#endif /* TABLEHOST_H */
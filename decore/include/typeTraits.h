@@ -0,0 +1,51 @@
+#ifndef TYPETRAITS_H
+#define TYPETRAITS_H
+
+#include <iterator>
+#include <vector>
+
+namespace decore
+{
+
+/**
+ * @brief Some kind of std::integral_constant<bool> from C++11, used to choose overload at compile time
+ */
+template <bool B>
+struct Bool
+{
+    static const bool value = B;
+};
+
+/**
+ * @brief Some kind of std::is_same from C++11
+ */
+template <typename A, typename B>
+struct IsSame : Bool<false>
+{
+};
+
+template <typename A>
+struct IsSame<A, A> : Bool<true>
+{
+};
+
+/**
+ * @brief True if the iterator refers to the elements stored one by one in memory: pointers and std::vector iterators
+ *
+ * std::vector<bool> stores bits, it's not contiguous.
+ */
+template <typename I>
+struct IsContiguous
+{
+    typedef typename std::iterator_traits<I>::value_type Value;
+
+    static const bool value = !IsSame<Value, bool>::value
+        && (IsSame<I, Value*>::value
+            || IsSame<I, const Value*>::value
+            || IsSame<I, typename std::vector<Value>::iterator>::value
+            || IsSame<I, typename std::vector<Value>::const_iterator>::value);
+};
+
+}
+
+#endif /* TYPETRAITS_H */
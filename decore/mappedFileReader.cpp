@@ -0,0 +1,58 @@
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mappedFileReader.h"
+
+namespace decore {
+
+MappedFileReader::MappedFileReader()
+    : mMapping(NULL)
+    , mMappingSize(0)
+{
+}
+
+MappedFileReader::~MappedFileReader()
+{
+    close();
+}
+
+bool MappedFileReader::open(const char* path)
+{
+    close();
+
+    int file = ::open(path, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    bool opened = !fstat(file, &fileStat) && static_cast<unsigned long long>(fileStat.st_size) <= static_cast<unsigned int>(-1);
+    if (opened && fileStat.st_size) {
+        void* mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            opened = false;
+        } else {
+            mMapping = mapping;
+            mMappingSize = fileStat.st_size;
+        }
+    }
+    // the mapping stays valid after the file is closed
+    ::close(file);
+
+    reset(mMapping, mMappingSize);
+    return opened;
+}
+
+void MappedFileReader::close()
+{
+    if (mMapping) {
+        munmap(mMapping, mMappingSize);
+        mMapping = NULL;
+        mMappingSize = 0;
+    }
+    reset(NULL, 0);
+}
+
+}
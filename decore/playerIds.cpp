@@ -2,13 +2,18 @@
 #include <cassert>
 
 #include "playerIds.h"
-
+#include "playerId.h"
 
 namespace decore
 {
 
 unsigned int PlayerIds::index(const PlayerId* id) const
 {
+    // ids of all the players of the game are stored in seat order
+    unsigned int seat = id->seat();
+    if (seat < size() && (*this)[seat] == id) {
+        return seat;
+    }
     std::vector<const PlayerId*>::const_iterator it = std::find(begin(), end(), id);
     assert(it != end());
     return it - begin();
@@ -17,4 +22,3 @@ unsigned int PlayerIds::index(const PlayerId* id) const
 
 }
 
-
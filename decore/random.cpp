@@ -0,0 +1,141 @@
+#include <cassert>
+
+#include "random.h"
+
+namespace decore {
+
+/**
+ * @brief Rotates the value left
+ */
+static inline uint64_t rotateLeft(uint64_t value, unsigned int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * @brief Returns uniformly distributed number in the range [0, bound) from the generator's numbers
+ *
+ * 32 bit random number multiplied by `bound`, high 32 bits are the result, biased results are rejected
+ */
+template <typename Generator>
+static unsigned int bounded(Generator& generator, unsigned int bound)
+{
+    assert(bound);
+    uint64_t product = (generator.next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+        while (low < threshold) {
+            product = (generator.next() >> 32) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<unsigned int>(product >> 32);
+}
+
+Random::Random(uint64_t seed)
+{
+    for (unsigned int i = 0; i < 4; ++i) {
+        mState[i] = splitMix(seed);
+    }
+}
+
+uint64_t Random::next()
+{
+    const uint64_t result = rotateLeft(mState[1] * 5, 7) * 9;
+    const uint64_t t = mState[1] << 17;
+
+    mState[2] ^= mState[0];
+    mState[3] ^= mState[1];
+    mState[1] ^= mState[2];
+    mState[0] ^= mState[3];
+
+    mState[2] ^= t;
+    mState[3] = rotateLeft(mState[3], 45);
+
+    return result;
+}
+
+unsigned int Random::next(unsigned int bound)
+{
+    return bounded(*this, bound);
+}
+
+unsigned int Random::operator()(unsigned int bound)
+{
+    return next(bound);
+}
+
+void Random::jump()
+{
+    static const uint64_t JUMP[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    jump(JUMP);
+}
+
+void Random::longJump()
+{
+    static const uint64_t LONG_JUMP[] = {
+        0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL
+    };
+    jump(LONG_JUMP);
+}
+
+uint64_t Random::splitMix(uint64_t& state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void Random::jump(const uint64_t* polynomial)
+{
+    uint64_t state[4] = {0, 0, 0, 0};
+    for (unsigned int i = 0; i < 4; ++i) {
+        for (unsigned int bit = 0; bit < 64; ++bit) {
+            if (polynomial[i] & static_cast<uint64_t>(1) << bit) {
+                for (unsigned int j = 0; j < 4; ++j) {
+                    state[j] ^= mState[j];
+                }
+            }
+            next();
+        }
+    }
+    for (unsigned int i = 0; i < 4; ++i) {
+        mState[i] = state[i];
+    }
+}
+
+CounterRandom::CounterRandom(uint64_t seed, uint64_t stream)
+    : mCounter(0)
+{
+    // splitmix is a bijection, so distinct streams give distinct keys
+    uint64_t state = Random::splitMix(seed) + stream;
+    mKey = Random::splitMix(state);
+}
+
+uint64_t CounterRandom::at(uint64_t counter) const
+{
+    // splitmix64 started at the key: the number is the hash of key + counter * gamma
+    uint64_t state = mKey + counter * 0x9e3779b97f4a7c15ULL;
+    return Random::splitMix(state);
+}
+
+uint64_t CounterRandom::next()
+{
+    return at(mCounter++);
+}
+
+unsigned int CounterRandom::next(unsigned int bound)
+{
+    return bounded(*this, bound);
+}
+
+unsigned int CounterRandom::operator()(unsigned int bound)
+{
+    return next(bound);
+}
+
+}
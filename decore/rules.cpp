@@ -4,61 +4,118 @@
 #include "rules.h"
 #include "cardSet.h"
 #include "deck.h"
+#include "playerId.h"
+#include "bits.h"
 
 namespace decore {
 
 const unsigned int Rules::MAX_PLAYER_CARDS = 6;
 
-Rules::AttackCardFilter::AttackCardFilter(const CardSet& playerCards, CardSet& result)
-    : mPlayerCards(playerCards)
-    , mResult(result)
-{}
-
-void Rules::AttackCardFilter::operator()(const Card& tableCard)
+CardSet Rules::getAttackCards(const CardSet& tableCards, const CardSet& playerCards)
 {
-    mPlayerCards.getCards(tableCard.rank(), mResult);
+    return getAttackCards(tableCards.ranks(), playerCards);
 }
 
-CardSet Rules::getAttackCards(const CardSet& tableCards, const CardSet& playerCards)
+CardSet Rules::getAttackCards(unsigned int tableRanks, const CardSet& playerCards)
 {
-    if (tableCards.empty()) {
-        return playerCards;
-    }
-
     CardSet result;
-    std::for_each(tableCards.begin(), tableCards.end(), AttackCardFilter(playerCards, result));
+    getAttackCards(tableRanks, playerCards, result);
     return result;
 }
 
-Rules::DefendCardFilter::DefendCardFilter(const Card& cardToBeat, const Suit& trump, CardSet& result)
-    : mCardToBeat(cardToBeat)
-    , mTrump(trump)
-    , mResult(result)
-{}
+void Rules::getAttackCards(unsigned int tableRanks, const CardSet& playerCards, CardSet& attackCards)
+{
+    if (!tableRanks) {
+        attackCards = playerCards;
+    } else {
+        attackCards = CardSet(playerCards.mask() & CardSet::rankColumns(tableRanks));
+    }
+}
 
-void Rules::DefendCardFilter::operator()(const Card& playerCard)
+Rules::BeatsTable::BeatsTable()
 {
-    if (mCardToBeat.suit() == playerCard.suit()) {
-        // if suits are equal - take highest card
-        if (mCardToBeat.rank() < playerCard.rank()) {
-            mResult.insert(playerCard);
+    std::vector<Card> cards;
+    for (unsigned int suit = 0; suit < SUIT_LAST; ++suit) {
+        for (unsigned int rank = 0; rank < RANK_LAST; ++rank) {
+            cards.push_back(Card(static_cast<Suit>(suit), static_cast<Rank>(rank)));
+        }
+    }
+
+    for (unsigned int trump = 0; trump <= SUIT_LAST; ++trump) {
+        for (std::vector<Card>::const_iterator cardToBeat = cards.begin(); cardToBeat != cards.end(); ++cardToBeat) {
+            CardSet::Mask& beats = mBeats[trump][cardToBeat->index()];
+            beats = 0;
+            for (std::vector<Card>::const_iterator playerCard = cards.begin(); playerCard != cards.end(); ++playerCard) {
+                if (cardToBeat->suit() == playerCard->suit()) {
+                    // if suits are equal - take highest card
+                    if (cardToBeat->rank() < playerCard->rank()) {
+                        beats |= CardSet::cardMask(*playerCard);
+                    }
+                } else if (playerCard->suit() == static_cast<Suit>(trump)) {
+                    // if player card is a trump - take it
+                    beats |= CardSet::cardMask(*playerCard);
+                }
+            }
         }
-    } else if (playerCard.suit() == mTrump) {
-        // if player card is a trump - take it
-        mResult.insert(playerCard);
     }
 }
 
+CardSet::Mask Rules::BeatsTable::beats(const Card& card, const Suit& trumpSuit) const
+{
+    assert(card.index() < CardSet::CARDS);
+    assert(trumpSuit <= SUIT_LAST);
+    return mBeats[trumpSuit][card.index()];
+}
+
+CardSet::Mask Rules::beats(const Card& card, const Suit& trumpSuit)
+{
+    static const BeatsTable table;
+    return table.beats(card, trumpSuit);
+}
+
 CardSet Rules::getDefendCards(const Card &card, const CardSet &playerCards, const Suit &trumpSuit)
 {
     CardSet result;
-    std::for_each(playerCards.begin(), playerCards.end(), DefendCardFilter(card, trumpSuit, result));
+    getDefendCards(card, playerCards, trumpSuit, result);
     return result;
 }
 
-const PlayerId *Rules::pickNext(const std::vector<const PlayerId*>& playersList, const PlayerId* after, const std::map<const PlayerId*, CardSet>* playersCards)
+void Rules::getDefendCards(const Card& card, const CardSet& playerCards, const Suit& trumpSuit, CardSet& defendCards)
+{
+    defendCards = CardSet(beats(card, trumpSuit) & playerCards.mask());
+}
+
+/**
+ * @brief Checks if the player has no cards in the map
+ */
+static bool hasNoCards(const std::map<const PlayerId*, CardSet>& playersCards, const PlayerId* id)
 {
-    std::vector<const PlayerId*>::const_iterator current = std::find(playersList.begin(), playersList.end(), after);
+    assert(playersCards.find(id) != playersCards.end());
+    return playersCards.at(id).empty();
+}
+
+/**
+ * @brief Checks if the player has no cards in the array indexed by seat
+ */
+static bool hasNoCards(const std::vector<CardSet>& seatsCards, const PlayerId* id)
+{
+    assert(id->seat() < seatsCards.size());
+    return seatsCards[id->seat()].empty();
+}
+
+/**
+ * @brief Implementation of Rules::pickNext() for both kinds of cards lookup
+ */
+template <typename PlayersCards>
+static const PlayerId* pickNext(const std::vector<const PlayerId*>& playersList, const PlayerId* after, const PlayersCards* playersCards)
+{
+    std::vector<const PlayerId*>::const_iterator current;
+    if (after && after->seat() < playersList.size() && playersList[after->seat()] == after) {
+        // list of all the players is in seat order
+        current = playersList.begin() + after->seat();
+    } else {
+        current = std::find(playersList.begin(), playersList.end(), after);
+    }
 
     if (playersList.end() == current) {
         return NULL;
@@ -76,16 +133,21 @@ const PlayerId *Rules::pickNext(const std::vector<const PlayerId*>& playersList,
             // no player found
             return NULL;
         }
-        if (playersCards) {
-            assert(playersCards->find(*next) != playersCards->end());
-            playerHasNoCards = playersCards->at(*next).empty();
-        } else {
-            playerHasNoCards = false;
-        }
+        playerHasNoCards = playersCards && hasNoCards(*playersCards, *next);
     } while (playerHasNoCards);
     return *next;
 }
 
+const PlayerId *Rules::pickNext(const std::vector<const PlayerId*>& playersList, const PlayerId* after, const std::map<const PlayerId*, CardSet>* playersCards)
+{
+    return decore::pickNext(playersList, after, playersCards);
+}
+
+const PlayerId *Rules::pickNext(const std::vector<const PlayerId*>& playersList, const PlayerId* after, const std::vector<CardSet>* seatsCards)
+{
+    return decore::pickNext(playersList, after, seatsCards);
+}
+
 bool Rules::deal(Deck& deck, const std::vector<CardSet*> &cards)
 {
     unsigned int cardsAmount = deck.size();
@@ -98,9 +160,7 @@ bool Rules::deal(Deck& deck, const std::vector<CardSet*> &cards)
                 playersToDeal--;
                 continue;
             }
-            Card card = *deck.begin();
-            playerCards.insert(card);
-            deck.erase(deck.begin());
+            deck.deal(playerCards, 1);
             if (deck.empty()) {
                 break;
             }
@@ -113,6 +173,24 @@ bool Rules::deal(Deck& deck, const std::vector<CardSet*> &cards)
     return cardsAmount != deck.size();
 }
 
+unsigned int Rules::nextSeat(Seats seats, unsigned int after)
+{
+    assert(after < MAX_SEATS);
+    // seats after the seat go first, then the seats before it
+    Seats next = after + 1 < MAX_SEATS ? seats >> (after + 1) << (after + 1) : 0;
+    if (next) {
+        return lowestBit(next);
+    }
+    Seats before = seats & ((static_cast<Seats>(1) << after) - 1);
+    return before ? lowestBit(before) : PlayerId::NO_SEAT;
+}
+
+Rules::Seats Rules::allSeats(unsigned int seats)
+{
+    assert(seats <= MAX_SEATS);
+    return seats < MAX_SEATS ? (static_cast<Seats>(1) << seats) - 1 : ~static_cast<Seats>(0);
+}
+
 unsigned int Rules::maxAttackCards(unsigned int defenderCardsAmount)
 {
     return std::min(defenderCardsAmount, MAX_PLAYER_CARDS);
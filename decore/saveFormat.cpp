@@ -0,0 +1,22 @@
+#include "saveFormat.h"
+
+namespace decore {
+
+uint32_t SaveFormat::crc32(const void* data, unsigned int dataSizeBytes)
+{
+    // reflected polynomial 0xEDB88320 by half bytes: 16 entries instead of 256
+    static const uint32_t TABLE[] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t crc = 0xffffffff;
+    while (dataSizeBytes--) {
+        crc ^= *bytes++;
+        crc = TABLE[crc & 0x0f] ^ (crc >> 4);
+        crc = TABLE[crc & 0x0f] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+}
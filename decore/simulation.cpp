@@ -0,0 +1,431 @@
+#include <cassert>
+#include <cstring>
+
+#include "simulation.h"
+#include "rules.h"
+#include "deck.h"
+
+namespace decore {
+namespace sim {
+
+/**
+ * @brief All the seats in the seat order, is the players list for pickNext()
+ */
+static const unsigned char SEATS[MAX_PLAYERS] = {0, 1, 2, 3, 4, 5};
+
+/**
+ * @brief Returns mask of the card with the index
+ */
+static CardSet::Mask cardMask(unsigned int card)
+{
+    return static_cast<CardSet::Mask>(1) << card;
+}
+
+/**
+ * @brief Returns amount of the seat's cards
+ */
+static unsigned int handSize(const GameState& state, unsigned int seat)
+{
+    return CardSet(state.hands[seat]).size();
+}
+
+/**
+ * @brief Picks next seat, same as Rules::pickNext()
+ * @param seats seats list
+ * @param seatsAmount amount of the seats
+ * @param after the seat to start after
+ * @param hands seats cards, the seats without cards are skipped; NULL to not skip
+ * @return next seat or NO_SEAT
+ */
+static unsigned int pickNext(const unsigned char* seats, unsigned int seatsAmount, unsigned int after, const CardSet::Mask* hands)
+{
+    unsigned int current = 0;
+    while (current < seatsAmount && seats[current] != after) {
+        ++current;
+    }
+    if (current == seatsAmount) {
+        return NO_SEAT;
+    }
+
+    unsigned int next = current;
+    do {
+        if (++next == seatsAmount) {
+            next = 0;
+        }
+        if (next == current) {
+            // no seat found
+            return NO_SEAT;
+        }
+    } while (hands && !hands[seats[next]]);
+    return seats[next];
+}
+
+/**
+ * @brief Deals the deck cards, same order as Engine::dealCards() with Rules::deal()
+ */
+static void deal(GameState& state)
+{
+    while (state.deckTop < state.deckSize) {
+        unsigned int playersToDeal = state.players;
+        // round-robin from current player
+        for (unsigned int i = 0; i < state.players && state.deckTop < state.deckSize; ++i) {
+            unsigned int seat = (state.currentPlayer + i) % state.players;
+            if (handSize(state, seat) >= Rules::MAX_PLAYER_CARDS) {
+                playersToDeal--;
+                continue;
+            }
+            state.hands[seat] |= cardMask(state.deck[state.deckTop++]);
+        }
+        if (!playersToDeal) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Returns true if the game ended, same as Engine::gameEnded()
+ */
+static bool gameEnded(const GameState& state)
+{
+    if (state.deckTop < state.deckSize) {
+        return false;
+    }
+    unsigned int playersWithCards = 0;
+    for (unsigned int seat = 0; seat < state.players; ++seat) {
+        if (state.hands[seat]) {
+            playersWithCards++;
+        }
+    }
+    return playersWithCards < 2;
+}
+
+/**
+ * @brief Returns amount of the round attackers which have cards, same as Engine::attackersWithCards()
+ */
+static unsigned int attackersWithCards(const GameState& state)
+{
+    unsigned int res = 0;
+    for (unsigned int i = 0; i < state.attackersAmount; ++i) {
+        if (state.hands[state.attackers[i]]) {
+            res++;
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Returns first of the round attackers which has cards, same as Engine::firstAttackerWithCards()
+ */
+static unsigned int firstAttackerWithCards(const GameState& state)
+{
+    for (unsigned int i = 0; i < state.attackersAmount; ++i) {
+        if (state.hands[state.attackers[i]]) {
+            return state.attackers[i];
+        }
+    }
+    return NO_SEAT;
+}
+
+/**
+ * @brief Picks the round roles and deals the cards, see Engine::playCurrentRound()
+ */
+static void startRound(GameState& state)
+{
+    // if there was no deal yet (very first round) - do not consider cards while picking next players
+    const CardSet::Mask* hands = state.roundIndex ? state.hands : NULL;
+
+    state.attackers[0] = state.currentPlayer;
+    state.attackersAmount = 1;
+    state.defender = pickNext(SEATS, state.players, state.currentPlayer, hands);
+    if (state.defender == NO_SEAT) {
+        state.defender = pickNext(SEATS, state.players, state.currentPlayer, NULL);
+    }
+    unsigned int attacker = state.defender;
+    while ((attacker = pickNext(SEATS, state.players, attacker, hands)) != NO_SEAT
+           && attacker != state.currentPlayer
+           && attacker != state.defender) {
+        state.attackers[state.attackersAmount++] = attacker;
+    }
+
+    deal(state);
+
+    state.maxAttackCards = Rules::maxAttackCards(handSize(state, state.defender));
+    state.attacker = state.attackers[0];
+    state.passed = 0;
+    state.phase = PHASE_ATTACK;
+}
+
+/**
+ * @brief Ends the round and starts next one, see Engine::playRound()
+ */
+static void endRound(GameState& state)
+{
+    bool defended = !state.defendFailed;
+    if (!defended) {
+        state.hands[state.defender] |= state.table;
+    }
+
+    state.defendFailed = false;
+    state.roundIndex++;
+
+    // if attack failed "next move" goes to defender
+    // or to next player after the defender otherwise
+    state.currentPlayer = defended ? state.defender : pickNext(SEATS, state.players, state.defender, state.hands);
+    if (state.currentPlayer == NO_SEAT) {
+        state.currentPlayer = pickNext(SEATS, state.players, state.defender, NULL);
+    }
+
+    state.table = 0;
+    state.tableRanks = 0;
+    state.attackCardsAmount = 0;
+    state.defendCardsAmount = 0;
+
+    if (gameEnded(state)) {
+        state.phase = PHASE_ENDED;
+        state.attacker = NO_SEAT;
+        return;
+    }
+
+    startRound(state);
+}
+
+/**
+ * @brief Ends the rounds with max amount of attack cards, see the loop of Engine::playCurrentRound()
+ */
+static void checkTable(GameState& state)
+{
+    while (state.phase == PHASE_ATTACK && state.attackCardsAmount == state.maxAttackCards) {
+        endRound(state);
+    }
+}
+
+/**
+ * @brief Puts the card on the table
+ */
+static void putCard(GameState& state, unsigned int seat, unsigned int card)
+{
+    assert(state.hands[seat] & cardMask(card));
+    state.hands[seat] &= ~cardMask(card);
+    state.table |= cardMask(card);
+    state.tableRanks |= 1 << Card::interned(card).rank();
+}
+
+/**
+ * @brief Returns cards for the move of the player to move
+ * @param canSkip set to true if pass or take is legal
+ * @return cards
+ */
+static CardSet moveCards(const GameState& state, bool& canSkip)
+{
+    CardSet cards;
+    switch (state.phase) {
+    case PHASE_ATTACK:
+        Rules::getAttackCards(state.tableRanks, CardSet(state.hands[state.attacker]), cards);
+        // first attack is mandatory
+        canSkip = state.attackCardsAmount || cards.empty();
+        break;
+    case PHASE_DEFEND:
+        Rules::getDefendCards(Card::interned(state.attackCards[state.attackCardsAmount - 1]),
+            CardSet(state.hands[state.defender]), static_cast<Suit>(state.trumpSuit), cards);
+        canSkip = true;
+        break;
+    default:
+        canSkip = false;
+        break;
+    }
+    return cards;
+}
+
+void init(GameState& state, const Deck& deck, unsigned int players)
+{
+    assert(players >= 2 && players <= MAX_PLAYERS);
+    assert(!deck.empty() && deck.size() <= CardSet::CARDS);
+
+    std::memset(&state, 0, sizeof(state));
+    state.players = players;
+    state.deckSize = deck.size();
+    for (unsigned int i = 0; i < deck.size(); ++i) {
+        state.deck[i] = deck[i].index();
+    }
+    state.trumpSuit = deck.trumpSuit();
+    // first added player moves first
+    state.currentPlayer = 0;
+
+    startRound(state);
+    checkTable(state);
+}
+
+unsigned int legalMoves(const GameState& state, Move* moves)
+{
+    bool canSkip;
+    CardSet cards = moveCards(state, canSkip);
+
+    unsigned int amount = 0;
+    for (CardSet::const_iterator it = cards.begin(); it != cards.end(); ++it) {
+        moves[amount].type = MOVE_CARD;
+        moves[amount].card = it->index();
+        amount++;
+    }
+    if (canSkip) {
+        moves[amount].type = state.phase == PHASE_ATTACK ? MOVE_PASS : MOVE_TAKE;
+        moves[amount].card = Card::INVALID_INDEX;
+        amount++;
+    }
+    return amount;
+}
+
+void apply(GameState& state, const Move& move)
+{
+    assert(state.phase != PHASE_ENDED);
+#ifndef NDEBUG
+    bool canSkip;
+    CardSet cards = moveCards(state, canSkip);
+    assert(move.type == MOVE_CARD ? cards.mask() & cardMask(move.card) : canSkip);
+#endif
+
+    if (state.phase == PHASE_ATTACK) {
+        if (move.type == MOVE_PASS) {
+            // player skipped the move - pick next attacker
+            unsigned int next = pickNext(state.attackers, state.attackersAmount, state.attacker, state.hands);
+            // if more than one attacker and we have first attacker with cards again - reset pass counter
+            if (state.attackersAmount > 1 && next == firstAttackerWithCards(state)) {
+                state.passed = 0;
+            }
+            // attacker without cards could not pitch anyway - only the passes of the attackers with cards are counted
+            if (state.hands[state.attacker]) {
+                state.passed++;
+            }
+            state.attacker = next;
+            // attackers without cards are skipped by pickNext()
+            if (next == NO_SEAT || state.passed >= attackersWithCards(state)) {
+                // all attackers with cards "passed" - round ended
+                endRound(state);
+            }
+        } else {
+            assert(move.type == MOVE_CARD);
+            putCard(state, state.attacker, move.card);
+            state.attackCards[state.attackCardsAmount++] = move.card;
+            if (!state.defendFailed) {
+                state.phase = PHASE_DEFEND;
+                return;
+            }
+        }
+    } else {
+        if (move.type == MOVE_TAKE) {
+            state.defendFailed = true;
+        } else {
+            assert(move.type == MOVE_CARD);
+            putCard(state, state.defender, move.card);
+            state.defendCards[state.defendCardsAmount++] = move.card;
+        }
+        state.phase = PHASE_ATTACK;
+    }
+
+    checkTable(state);
+}
+
+void apply(GameState& state, const Move& move, Undo& record)
+{
+    record.table = state.table;
+    record.roundIndex = state.roundIndex;
+    record.move = move;
+    record.phase = state.phase;
+    record.deckTop = state.deckTop;
+    record.currentPlayer = state.currentPlayer;
+    record.defender = state.defender;
+    record.attacker = state.attacker;
+    record.passed = state.passed;
+    record.maxAttackCards = state.maxAttackCards;
+    record.attackersAmount = state.attackersAmount;
+    record.attackCardsAmount = state.attackCardsAmount;
+    record.defendCardsAmount = state.defendCardsAmount;
+    record.defendFailed = state.defendFailed;
+    record.tableRanks = state.tableRanks;
+    std::memcpy(record.attackers, state.attackers, sizeof(record.attackers));
+    std::memcpy(record.attackCards, state.attackCards, sizeof(record.attackCards));
+    std::memcpy(record.defendCards, state.defendCards, sizeof(record.defendCards));
+
+    apply(state, move);
+}
+
+void undo(GameState& state, const Undo& record)
+{
+    // dealt cards were in the deck - remove them from the hands
+    CardSet::Mask dealt = 0;
+    for (unsigned int i = record.deckTop; i < state.deckTop; ++i) {
+        dealt |= cardMask(state.deck[i]);
+    }
+    if (dealt) {
+        for (unsigned int seat = 0; seat < state.players; ++seat) {
+            state.hands[seat] &= ~dealt;
+        }
+    }
+
+    CardSet::Mask moveCard = record.move.type == MOVE_CARD ? cardMask(record.move.card) : 0;
+
+    // the round ended with the move and the defender took the table cards
+    if (state.roundIndex != record.roundIndex && (record.defendFailed || record.move.type == MOVE_TAKE)) {
+        state.hands[record.defender] &= ~(record.table | moveCard);
+    }
+
+    if (moveCard) {
+        state.hands[record.phase == PHASE_ATTACK ? record.attacker : record.defender] |= moveCard;
+    }
+
+    state.table = record.table;
+    state.roundIndex = record.roundIndex;
+    state.phase = record.phase;
+    state.deckTop = record.deckTop;
+    state.currentPlayer = record.currentPlayer;
+    state.defender = record.defender;
+    state.attacker = record.attacker;
+    state.passed = record.passed;
+    state.maxAttackCards = record.maxAttackCards;
+    state.attackersAmount = record.attackersAmount;
+    state.attackCardsAmount = record.attackCardsAmount;
+    state.defendCardsAmount = record.defendCardsAmount;
+    state.defendFailed = record.defendFailed;
+    state.tableRanks = record.tableRanks;
+    std::memcpy(state.attackers, record.attackers, sizeof(state.attackers));
+    std::memcpy(state.attackCards, record.attackCards, sizeof(state.attackCards));
+    std::memcpy(state.defendCards, record.defendCards, sizeof(state.defendCards));
+}
+
+unsigned int toMove(const GameState& state)
+{
+    switch (state.phase) {
+    case PHASE_ATTACK:
+        return state.attacker;
+    case PHASE_DEFEND:
+        return state.defender;
+    default:
+        return NO_SEAT;
+    }
+}
+
+bool ended(const GameState& state)
+{
+    return state.phase == PHASE_ENDED;
+}
+
+unsigned int loser(const GameState& state)
+{
+    unsigned int res = NO_SEAT;
+    for (unsigned int seat = 0; seat < state.players; ++seat) {
+        if (state.hands[seat]) {
+            if (res != NO_SEAT) {
+                return NO_SEAT;
+            }
+            res = seat;
+        }
+    }
+    return res;
+}
+
+unsigned int deckCards(const GameState& state)
+{
+    return state.deckSize - state.deckTop;
+}
+
+}
+}
@@ -0,0 +1,271 @@
+#include <cassert>
+
+#include "tableHost.h"
+#include "player.h"
+#include "deck.h"
+
+namespace decore {
+
+TableHost::Table::Table(unsigned int id, const std::vector<Player*>& players, Rules::Seats externalSeats)
+    : mId(id)
+    , mEngine(false)
+    , mPlayers(players)
+    , mExternalSeats(externalSeats)
+    , mState(TABLE_QUEUED)
+    , mMemory(0)
+    , mNotifying(0)
+    , mRemoved(false)
+{
+}
+
+TableHost::TableHost(TableListener& listener, unsigned int threads)
+    : mListener(listener)
+    , mActive(0)
+    , mMemory(0)
+    , mQuantum(1)
+    , mStop(false)
+{
+    pthread_mutex_init(&mLock, NULL);
+    pthread_cond_init(&mQueued, NULL);
+    pthread_cond_init(&mIdle, NULL);
+    if (!threads) {
+        threads = 1;
+    }
+    mThreads.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i) {
+        pthread_t thread;
+        if (!pthread_create(&thread, NULL, workerThread, this)) {
+            mThreads.push_back(thread);
+        }
+    }
+}
+
+TableHost::~TableHost()
+{
+    pthread_mutex_lock(&mLock);
+    mStop = true;
+    pthread_cond_broadcast(&mQueued);
+    pthread_mutex_unlock(&mLock);
+    for (std::vector<pthread_t>::iterator it = mThreads.begin(); it != mThreads.end(); ++it) {
+        pthread_join(*it, NULL);
+    }
+    for (std::vector<Table*>::iterator it = mTables.begin(); it != mTables.end(); ++it) {
+        delete *it;
+    }
+    pthread_cond_destroy(&mIdle);
+    pthread_cond_destroy(&mQueued);
+    pthread_mutex_destroy(&mLock);
+}
+
+void TableHost::setQuantum(unsigned int quantum)
+{
+    assert(quantum);
+    pthread_mutex_lock(&mLock);
+    mQuantum = quantum;
+    pthread_mutex_unlock(&mLock);
+}
+
+unsigned int TableHost::threads() const
+{
+    return mThreads.size();
+}
+
+unsigned int TableHost::addTable(const std::vector<Player*>& players, Rules::Seats externalSeats, const Deck& deck)
+{
+    assert(players.size() >= 2);
+
+    pthread_mutex_lock(&mLock);
+    unsigned int id = mTables.size();
+    mTables.push_back(NULL);
+    pthread_mutex_unlock(&mLock);
+
+    // the table is not visible to the workers till it's queued
+    Table* table = new Table(id, players, externalSeats);
+    for (std::vector<Player*>::const_iterator it = players.begin(); it != players.end(); ++it) {
+        table->mEngine.add(**it);
+    }
+    table->mEngine.setDeck(deck);
+    table->mMemory = sizeof(Table) + table->mEngine.memoryUsage();
+
+    pthread_mutex_lock(&mLock);
+    mTables[id] = table;
+    mMemory += table->mMemory;
+    mQueue.push_back(table);
+    mActive++;
+    pthread_cond_signal(&mQueued);
+    pthread_mutex_unlock(&mLock);
+
+    return id;
+}
+
+bool TableHost::submit(unsigned int table, const Card* card)
+{
+    pthread_mutex_lock(&mLock);
+    Table* res = find(table);
+    bool parked = res && TABLE_PARKED == res->mState;
+    if (parked) {
+        // no worker plays the parked table
+        res->mEngine.submit(card);
+        res->mDecision.type = DECISION_NONE;
+        res->mState = TABLE_QUEUED;
+        mQueue.push_back(res);
+        mActive++;
+        pthread_cond_signal(&mQueued);
+    }
+    pthread_mutex_unlock(&mLock);
+    return parked;
+}
+
+bool TableHost::pending(unsigned int table, Decision& decision) const
+{
+    pthread_mutex_lock(&mLock);
+    Table* res = find(table);
+    bool parked = res && TABLE_PARKED == res->mState;
+    if (parked) {
+        decision = res->mDecision;
+    }
+    pthread_mutex_unlock(&mLock);
+    return parked;
+}
+
+bool TableHost::ended(unsigned int table) const
+{
+    pthread_mutex_lock(&mLock);
+    Table* res = find(table);
+    bool ended = res && TABLE_ENDED == res->mState;
+    pthread_mutex_unlock(&mLock);
+    return ended;
+}
+
+bool TableHost::removeTable(unsigned int table)
+{
+    pthread_mutex_lock(&mLock);
+    Table* res = find(table);
+    bool removed = res && (TABLE_PARKED == res->mState || TABLE_ENDED == res->mState);
+    bool deferred = false;
+    if (removed) {
+        mTables[table] = NULL;
+        mMemory -= res->mMemory;
+        // the listener could still use the players of the table, the worker deletes it
+        deferred = res->mNotifying;
+        res->mRemoved = deferred;
+    }
+    pthread_mutex_unlock(&mLock);
+    if (removed && !deferred) {
+        delete res;
+    }
+    return removed;
+}
+
+size_t TableHost::tableMemory(unsigned int table) const
+{
+    pthread_mutex_lock(&mLock);
+    Table* res = find(table);
+    size_t memory = res ? res->mMemory : 0;
+    pthread_mutex_unlock(&mLock);
+    return memory;
+}
+
+size_t TableHost::memory() const
+{
+    pthread_mutex_lock(&mLock);
+    size_t memory = mMemory;
+    pthread_mutex_unlock(&mLock);
+    return memory;
+}
+
+void TableHost::wait()
+{
+    pthread_mutex_lock(&mLock);
+    while (mActive) {
+        pthread_cond_wait(&mIdle, &mLock);
+    }
+    pthread_mutex_unlock(&mLock);
+}
+
+void* TableHost::workerThread(void* data)
+{
+    static_cast<TableHost*>(data)->work();
+    return NULL;
+}
+
+void TableHost::work()
+{
+    pthread_mutex_lock(&mLock);
+    for (;;) {
+        while (mQueue.empty() && !mStop) {
+            pthread_cond_wait(&mQueued, &mLock);
+        }
+        if (mStop) {
+            break;
+        }
+        Table& table = *mQueue.front();
+        mQueue.pop_front();
+        table.mState = TABLE_RUNNING;
+        unsigned int quantum = mQuantum;
+        pthread_mutex_unlock(&mLock);
+
+        Decision decision;
+        TableState state = play(table, quantum, decision);
+        size_t memory = sizeof(Table) + table.mEngine.memoryUsage();
+        const PlayerId* loser = TABLE_ENDED == state ? table.mEngine.getLoser() : NULL;
+
+        pthread_mutex_lock(&mLock);
+        mMemory += memory - table.mMemory;
+        table.mMemory = memory;
+        table.mState = state;
+        if (TABLE_QUEUED == state) {
+            // to the end of the queue - the rest of the tables go first
+            mQueue.push_back(&table);
+            continue;
+        }
+        if (TABLE_PARKED == state) {
+            table.mDecision = decision;
+        }
+        // the table could be submitted to as soon as the lock is released, removed table is kept till the callback returns
+        table.mNotifying++;
+        unsigned int id = table.mId;
+        pthread_mutex_unlock(&mLock);
+
+        if (TABLE_PARKED == state) {
+            mListener.decisionPending(id, decision);
+        } else {
+            mListener.tableEnded(id, loser);
+        }
+
+        pthread_mutex_lock(&mLock);
+        if (!--table.mNotifying && table.mRemoved) {
+            delete &table;
+        }
+        // idle only after the listener is notified
+        if (!--mActive) {
+            pthread_cond_broadcast(&mIdle);
+        }
+    }
+    pthread_mutex_unlock(&mLock);
+}
+
+TableHost::TableState TableHost::play(Table& table, unsigned int quantum, Decision& decision)
+{
+    for (unsigned int decisions = 0; ; ++decisions) {
+        if (!table.mEngine.step(decision)) {
+            return TABLE_ENDED;
+        }
+        unsigned int seat = decision.player->seat();
+        if (table.mExternalSeats & (static_cast<Rules::Seats>(1) << seat)) {
+            return TABLE_PARKED;
+        }
+        if (decisions == quantum) {
+            // the decision is asked next time
+            return TABLE_QUEUED;
+        }
+        table.mEngine.submit(decision.ask(*table.mPlayers[seat]));
+    }
+}
+
+TableHost::Table* TableHost::find(unsigned int table) const
+{
+    return table < mTables.size() ? mTables[table] : NULL;
+}
+
+}
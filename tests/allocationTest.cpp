@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+
+#include "allocationTest.h"
+#include "engine.h"
+#include "deck.h"
+#include "rules.h"
+#include "gameCardsTracker.h"
+#include "defines.h"
+#include "atomic.h"
+
+using namespace decore;
+
+/**
+ * @brief Amount of allocations made by the test binary, other suites allocate from their threads too
+ */
+static Atomic<unsigned int> allocations(0);
+
+#if __cplusplus >= 201103L
+#define THROW_BAD_ALLOC
+#define THROW_NOTHING noexcept
+#else
+#define THROW_BAD_ALLOC throw(std::bad_alloc)
+#define THROW_NOTHING throw()
+#endif
+
+void* operator new(std::size_t size) THROW_BAD_ALLOC
+{
+    allocations.getAndAdd(1);
+    void* res = std::malloc(size ? size : 1);
+    if (!res) {
+        throw std::bad_alloc();
+    }
+    return res;
+}
+
+void operator delete(void* data) THROW_NOTHING
+{
+    std::free(data);
+}
+
+const Card& AllocationTest::FirstCardPlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    (void) playerId;
+    return *cardSet.begin();
+}
+
+const Card* AllocationTest::FirstCardPlayer::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    (void) playerId;
+    return cardSet.empty() ? NULL : &*cardSet.begin();
+}
+
+const Card* AllocationTest::FirstCardPlayer::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    (void) playerId;
+    (void) attackCard;
+    return cardSet.empty() ? NULL : &*cardSet.begin();
+}
+
+void AllocationTest::FirstCardPlayer::cardsUpdated(const CardSet& cardSet)
+{
+    (void) cardSet;
+}
+
+unsigned int AllocationTest::playGame(unsigned int players, unsigned int& rounds, unsigned int& firstRoundAllocations)
+{
+    Engine engine;
+    std::vector<FirstCardPlayer> gamePlayers(players);
+    for (std::vector<FirstCardPlayer>::iterator it = gamePlayers.begin(); it != gamePlayers.end(); ++it) {
+        engine.add(*it);
+    }
+    GameCardsTracker tracker;
+    engine.addGameObserver(tracker);
+
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    Deck deck;
+    deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits));
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+
+    unsigned int allocationsBefore = allocations.get();
+    rounds = 1;
+    bool played = engine.playRound();
+    firstRoundAllocations = allocations.get() - allocationsBefore;
+    allocationsBefore = allocations.get();
+    while (played && engine.playRound()) {
+        rounds++;
+    }
+    return allocations.get() - allocationsBefore;
+}
+
+void AllocationTest::testLegalMoves()
+{
+    CardSet playerCards;
+    playerCards.insert(Card(SUIT_CLUBS, RANK_6));
+    playerCards.insert(Card(SUIT_CLUBS, RANK_9));
+    playerCards.insert(Card(SUIT_SPADES, RANK_9));
+
+    CardSet tableCards;
+    tableCards.insert(Card(SUIT_HEARTS, RANK_9));
+
+    CardSet attackCards, defendCards;
+
+    unsigned int allocationsBefore = allocations.get();
+    Rules::getAttackCards(0, playerCards, attackCards);
+    CPPUNIT_ASSERT(attackCards == playerCards);
+    Rules::getAttackCards(tableCards.ranks(), playerCards, attackCards);
+    CPPUNIT_ASSERT(2 == attackCards.size());
+    Rules::getDefendCards(Card(SUIT_CLUBS, RANK_7), playerCards, SUIT_SPADES, defendCards);
+    CPPUNIT_ASSERT(2 == defendCards.size());
+    CPPUNIT_ASSERT(Rules::getDefendCards(Card(SUIT_CLUBS, RANK_7), playerCards, SUIT_SPADES) == defendCards);
+    CPPUNIT_ASSERT(allocationsBefore == allocations.get());
+}
+
+void AllocationTest::testGame()
+{
+    // the engine and the tracker reuse their buffers, so first round allocates the buffers
+    // and the rest rounds could only grow table cards buffers
+    const unsigned int MAX_FIRST_ROUND_ALLOCATIONS = 32;
+    const unsigned int MAX_ALLOCATIONS = 8;
+
+    for (unsigned int players = 2; players <= 4; ++players) {
+        unsigned int rounds, firstRoundAllocations;
+        unsigned int gameAllocations = playGame(players, rounds, firstRoundAllocations);
+        char buf[128];
+        snprintf(buf, sizeof(buf), "players %u, rounds %u, first round allocations %u, allocations %u", players, rounds, firstRoundAllocations, gameAllocations);
+        CPPUNIT_ASSERT_MESSAGE(buf, rounds > 1);
+        CPPUNIT_ASSERT_MESSAGE(buf, firstRoundAllocations <= MAX_FIRST_ROUND_ALLOCATIONS);
+        CPPUNIT_ASSERT_MESSAGE(buf, gameAllocations <= MAX_ALLOCATIONS);
+    }
+}
@@ -0,0 +1,265 @@
+#include "asyncObserverTest.h"
+#include "engine.h"
+#include "deck.h"
+#include "rules.h"
+#include "defines.h"
+
+using namespace decore;
+
+/**
+ * @brief Writer to memory
+ */
+class MemoryWriter : public DataWriter
+{
+public:
+    using DataWriter::write;
+    std::vector<unsigned char> mBytes;
+protected:
+    void write(const void* data, unsigned int dataSizeBytes)
+    {
+        mBytes.insert(mBytes.end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + dataSizeBytes);
+    }
+    unsigned int position() const
+    {
+        return mBytes.size();
+    }
+};
+
+AsyncObserverTest::SavePlayer::SavePlayer(EventRecorder& recorder, AsyncObserver& asyncObserver)
+    : mRecorder(recorder)
+    , mAsyncObserver(asyncObserver)
+    , mSaves(0)
+{
+}
+
+const Card& AsyncObserverTest::SavePlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    check();
+    return BasePlayer::attack(playerId, cardSet);
+}
+
+const Card* AsyncObserverTest::SavePlayer::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    check();
+    return BasePlayer::pitch(playerId, cardSet);
+}
+
+const Card* AsyncObserverTest::SavePlayer::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    check();
+    return BasePlayer::defend(playerId, attackCard, cardSet);
+}
+
+void AsyncObserverTest::SavePlayer::check()
+{
+    // the async observer is saved with all the events so far
+    MemoryWriter writer;
+    MemoryWriter asyncWriter;
+    mRecorder.save(writer);
+    mAsyncObserver.save(asyncWriter);
+    CPPUNIT_ASSERT(writer.mBytes == asyncWriter.mBytes);
+    mSaves++;
+}
+
+void AsyncObserverTest::generate(Deck& deck, uint64_t seed, uint64_t gameIndex)
+{
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), seed, gameIndex);
+}
+
+void AsyncObserverTest::playGame(const std::vector<GameObserver*>& observers, uint64_t seed, unsigned int players)
+{
+    Deck deck;
+    generate(deck, seed, 0);
+
+    Engine engine;
+    std::vector<BasePlayer> gamePlayers(players);
+    for (unsigned int i = 0; i < players; ++i) {
+        engine.add(gamePlayers[i]);
+    }
+    for (std::vector<GameObserver*>::const_iterator it = observers.begin(); it != observers.end(); ++it) {
+        engine.addGameObserver(**it);
+    }
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+    unsigned int rounds = 0;
+    while (engine.playRound() && ++rounds < 100);
+}
+
+std::map<const PlayerId*, unsigned int> AsyncObserverTest::playersCards(const std::vector<GameEvent>& events)
+{
+    std::map<const PlayerId*, unsigned int> res;
+    for (std::vector<GameEvent>::const_iterator it = events.begin(); it != events.end(); ++it) {
+        switch (it->type) {
+        case EVENT_GAME_STARTED:
+        case EVENT_GAME_RESTORED:
+            res.clear();
+            break;
+        case EVENT_PLAYER:
+            res[it->player] = it->value;
+            break;
+        case EVENT_CARDS_DEALT:
+            res[it->player] += it->value;
+            break;
+        case EVENT_CARDS_DROPPED:
+            res[it->player] -= CardSet(it->cards).size();
+            break;
+        case EVENT_CARDS_PICKED_UP:
+            res[it->player] += CardSet(it->cards).size();
+            break;
+        default:
+            break;
+        }
+    }
+    return res;
+}
+
+bool AsyncObserverTest::equal(const GameEvent& first, const GameEvent& second)
+{
+    return first.type == second.type
+        && first.player == second.player
+        && first.value == second.value
+        && first.cards == second.cards
+        && first.suit == second.suit;
+}
+
+void AsyncObserverTest::testBlock()
+{
+    EventRecorder recorder;
+    EventRecorder slowRecorder(20);
+    std::vector<GameEvent> events;
+    {
+        AsyncObserver asyncObserver(slowRecorder, 64, AsyncObserver::BACKPRESSURE_BLOCK);
+        std::vector<GameObserver*> observers;
+        observers.push_back(&recorder);
+        observers.push_back(&asyncObserver);
+        playGame(observers, 1);
+
+        asyncObserver.flush();
+        CPPUNIT_ASSERT(!asyncObserver.dropped());
+        events = slowRecorder.mEvents;
+    }
+    // nothing lost, same order
+    CPPUNIT_ASSERT(recorder.mEvents.size() > 128);
+    CPPUNIT_ASSERT(recorder.mEvents.size() == events.size());
+    for (unsigned int i = 0; i < events.size(); ++i) {
+        CPPUNIT_ASSERT(equal(recorder.mEvents[i], events[i]));
+    }
+}
+
+void AsyncObserverTest::testDropOldest()
+{
+    EventRecorder recorder;
+    EventRecorder slowRecorder(200);
+    AsyncObserver asyncObserver(slowRecorder, 64, AsyncObserver::BACKPRESSURE_DROP_OLDEST);
+    std::vector<GameObserver*> observers;
+    observers.push_back(&recorder);
+    observers.push_back(&asyncObserver);
+    playGame(observers, 2);
+    asyncObserver.flush();
+
+    // the received events are the recorded events without the dropped ones
+    const std::vector<GameEvent>& events = slowRecorder.mEvents;
+    CPPUNIT_ASSERT(asyncObserver.dropped());
+    CPPUNIT_ASSERT(events.size() + asyncObserver.dropped() == recorder.mEvents.size());
+    unsigned int index = 0;
+    for (std::vector<GameEvent>::const_iterator it = recorder.mEvents.begin(); it != recorder.mEvents.end() && index < events.size(); ++it) {
+        if (equal(*it, events[index])) {
+            index++;
+        }
+    }
+    CPPUNIT_ASSERT(index == events.size());
+    // the latest events are delivered
+    CPPUNIT_ASSERT(equal(recorder.mEvents.back(), events.back()));
+}
+
+void AsyncObserverTest::testCoalesce()
+{
+    EventRecorder recorder;
+    EventRecorder slowRecorder(200);
+    AsyncObserver asyncObserver(slowRecorder, 64, AsyncObserver::BACKPRESSURE_COALESCE);
+    std::vector<GameObserver*> observers;
+    observers.push_back(&recorder);
+    observers.push_back(&asyncObserver);
+    playGame(observers, 3);
+    asyncObserver.flush();
+
+    const std::vector<GameEvent>& events = slowRecorder.mEvents;
+    CPPUNIT_ASSERT(asyncObserver.dropped());
+    CPPUNIT_ASSERT(events.size() < recorder.mEvents.size());
+
+    // the state is restored instead of the dropped events
+    bool restored = false;
+    for (std::vector<GameEvent>::const_iterator it = events.begin(); it != events.end(); ++it) {
+        restored = restored || EVENT_GAME_RESTORED == it->type;
+    }
+    CPPUNIT_ASSERT(restored);
+    CPPUNIT_ASSERT(playersCards(recorder.mEvents) == playersCards(events));
+    CPPUNIT_ASSERT(equal(recorder.mEvents.back(), events.back()));
+}
+
+void AsyncObserverTest::testMaxSeats()
+{
+    // the notification group of the game with all the seats fits the smallest ring
+    AsyncObserver::Backpressure modes[] = {
+        AsyncObserver::BACKPRESSURE_BLOCK,
+        AsyncObserver::BACKPRESSURE_DROP_OLDEST,
+        AsyncObserver::BACKPRESSURE_COALESCE,
+    };
+    for (unsigned int i = 0; i < ARRAY_SIZE(modes); ++i) {
+        EventRecorder recorder;
+        EventRecorder slowRecorder(20);
+        AsyncObserver asyncObserver(slowRecorder, 1, modes[i]);
+        std::vector<GameObserver*> observers;
+        observers.push_back(&recorder);
+        observers.push_back(&asyncObserver);
+        playGame(observers, 4, Rules::MAX_SEATS);
+        asyncObserver.flush();
+
+        CPPUNIT_ASSERT(!slowRecorder.mEvents.empty());
+        // dropped events are not restored
+        CPPUNIT_ASSERT(AsyncObserver::BACKPRESSURE_DROP_OLDEST == modes[i]
+            || playersCards(recorder.mEvents) == playersCards(slowRecorder.mEvents));
+        CPPUNIT_ASSERT(equal(recorder.mEvents.back(), slowRecorder.mEvents.back()));
+    }
+}
+
+void AsyncObserverTest::testSave()
+{
+    Deck deck;
+    generate(deck, 4, 0);
+
+    EventRecorder recorder;
+    EventRecorder slowRecorder(20);
+    AsyncObserver asyncObserver(slowRecorder);
+    SavePlayer player0(recorder, asyncObserver);
+    SavePlayer player1(recorder, asyncObserver);
+
+    Engine engine;
+    engine.add(player0);
+    engine.add(player1);
+    engine.addGameObserver(recorder);
+    engine.addGameObserver(asyncObserver);
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+    unsigned int rounds = 0;
+    while (engine.playRound() && ++rounds < 100);
+
+    CPPUNIT_ASSERT(player0.mSaves && player1.mSaves);
+}
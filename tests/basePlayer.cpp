@@ -63,7 +63,7 @@ void BasePlayer::gameStarted(const Suit& trumpSuit, const CardSet& cardSet, cons
     (void) players;
 }
 
-void BasePlayer::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*> attackers, const PlayerId* defender)
+void BasePlayer::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender)
 {
     (void) roundIndex;
     (void) attackers;
@@ -0,0 +1,130 @@
+#include <algorithm>
+
+#include "batchRunnerTest.h"
+#include "engine.h"
+#include "deck.h"
+#include "defines.h"
+
+using namespace decore;
+
+BatchRunnerTest::Factory::Factory()
+    : mCreated(0)
+    , mDestroyed(0)
+{
+}
+
+Player* BatchRunnerTest::Factory::create(unsigned int seat, uint64_t gameIndex)
+{
+    (void) seat;
+    (void) gameIndex;
+    mCreated.getAndAdd(1);
+    return new BasePlayer();
+}
+
+void BatchRunnerTest::Factory::destroy(Player* player)
+{
+    mDestroyed.getAndAdd(1);
+    PlayerFactory::destroy(player);
+}
+
+void BatchRunnerTest::testGames()
+{
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    // play the games one by one
+    const unsigned int players = 3;
+    BatchResult expected;
+    expected.losses.resize(players);
+    for (uint64_t game = 0; game < 20; ++game) {
+        Deck deck;
+        deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), 7, game);
+
+        Engine engine;
+        BasePlayer gamePlayers[players];
+        std::vector<const PlayerId*> ids;
+        for (unsigned int i = 0; i < players; ++i) {
+            ids.push_back(engine.add(gamePlayers[i]));
+        }
+        engine.setDeck(deck);
+        unsigned int rounds = 0;
+        bool next = true;
+        while (next && rounds < 100) {
+            next = engine.playRound();
+            rounds++;
+        }
+
+        BatchResult result;
+        result.games = 1;
+        result.rounds = rounds;
+        result.minRounds = rounds;
+        result.maxRounds = rounds;
+        result.losses.resize(players);
+        const PlayerId* loser = engine.getLoser();
+        if (next) {
+            result.unfinished++;
+        } else if (loser) {
+            result.losses[std::find(ids.begin(), ids.end(), loser) - ids.begin()]++;
+        } else {
+            result.draws++;
+        }
+        expected.add(result);
+    }
+
+    Factory factory;
+    BatchRunner runner(factory, players);
+    runner.setMaxRounds(100);
+    BatchResult result = runner.run(7, 0, 20, 4);
+    CPPUNIT_ASSERT(result == expected);
+    CPPUNIT_ASSERT(20 == result.games);
+    // the players are the same each game, some games never end
+    CPPUNIT_ASSERT(result.unfinished);
+    CPPUNIT_ASSERT(result.minRounds <= result.maxRounds);
+    CPPUNIT_ASSERT(result.minRounds * result.games <= result.rounds);
+}
+
+void BatchRunnerTest::testThreads()
+{
+    const unsigned int games = 300;
+    const unsigned int players = 4;
+    Factory factory;
+    BatchRunner runner(factory, players);
+    BatchResult result = runner.run(3, 0, games, 1);
+
+    CPPUNIT_ASSERT(games == result.games);
+    CPPUNIT_ASSERT(players == result.losses.size());
+    uint64_t ended = result.draws + result.unfinished;
+    for (unsigned int i = 0; i < players; ++i) {
+        ended += result.losses[i];
+    }
+    CPPUNIT_ASSERT(games == ended);
+
+    // any amount of threads, more threads than games
+    unsigned int threads[] = {2, 3, 8, games + 5};
+    for (unsigned int i = 0; i < ARRAY_SIZE(threads); ++i) {
+        CPPUNIT_ASSERT(result == runner.run(3, 0, games, threads[i]));
+    }
+    runner.setPinThreads(true);
+    CPPUNIT_ASSERT(result == runner.run(3, 0, games, 4));
+    // other seed - other games
+    CPPUNIT_ASSERT(result != runner.run(4, 0, games, 4));
+
+    CPPUNIT_ASSERT(players * games * (ARRAY_SIZE(threads) + 3) == factory.mCreated.get());
+    CPPUNIT_ASSERT(factory.mCreated.get() == factory.mDestroyed.get());
+}
@@ -2,6 +2,7 @@
 #include "cardSet.h"
 #include "card.h"
 #include "deck.h"
+#include "random.h"
 #include "defines.h"
 
 #define GENERATE(x, y) \
@@ -25,6 +26,31 @@ void CardTest::testCreate()
     CPPUNIT_ASSERT(set.empty());
 }
 
+void CardTest::testCard()
+{
+    using namespace decore;
+
+    CPPUNIT_ASSERT(1 == sizeof(Card));
+
+    for (unsigned int suit = 0; suit < SUIT_LAST; ++suit) {
+        for (unsigned int rank = 0; rank < RANK_LAST; ++rank) {
+            Card card(static_cast<Suit>(suit), static_cast<Rank>(rank));
+            CPPUNIT_ASSERT(card.suit() == static_cast<Suit>(suit));
+            CPPUNIT_ASSERT(card.rank() == static_cast<Rank>(rank));
+            CPPUNIT_ASSERT(card.index() == suit * RANK_LAST + rank);
+        }
+    }
+
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_ACE) < Card(SUIT_HEARTS, RANK_6));
+    CPPUNIT_ASSERT(!(Card(SUIT_HEARTS, RANK_6) < Card(SUIT_HEARTS, RANK_6)));
+
+    // not valid card
+    Card invalid(SUIT_LAST, RANK_LAST);
+    CPPUNIT_ASSERT(Card::INVALID_INDEX == invalid.index());
+    CPPUNIT_ASSERT(SUIT_LAST == invalid.suit());
+    CPPUNIT_ASSERT(RANK_LAST == invalid.rank());
+}
+
 void CardTest::testGenerate()
 {
     using namespace decore;
@@ -128,6 +154,196 @@ void CardTest::testShuffle()
     CPPUNIT_ASSERT_MESSAGE(buf, notShuffledActual == notShuffled);
 }
 
+void CardTest::testShuffleSeeded()
+{
+    using namespace decore;
+
+    // same sequence on any platform
+    Random random(42);
+    CPPUNIT_ASSERT(random.next() == 0x15780b2e0c2ec716ULL);
+    CPPUNIT_ASSERT(random.next() == 0x6104d9866d113a7eULL);
+    CPPUNIT_ASSERT(random.next() == 0xae17533239e499a1ULL);
+
+    for (unsigned int bound = 1; bound < 100; ++bound) {
+        CPPUNIT_ASSERT(random(bound) < bound);
+    }
+
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    Deck original;
+    original.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits));
+
+    Random generator0(1);
+    Random generator1(1);
+    Deck deck0(original);
+    Deck deck1(original);
+    deck0.shuffle(generator0);
+    deck1.shuffle(generator1);
+    // same seed - same deck
+    CPPUNIT_ASSERT(deck0 == deck1);
+    CPPUNIT_ASSERT(deck0 != original);
+    CPPUNIT_ASSERT(deck0.trumpSuit() == deck0.back().suit());
+
+    // same cards
+    CardSet cards0;
+    cards0.insert(deck0.begin(), deck0.end());
+    CPPUNIT_ASSERT(cards0.size() == original.size());
+
+    // next shuffle differs
+    deck1 = original;
+    deck1.shuffle(generator1);
+    CPPUNIT_ASSERT(deck0 != deck1);
+
+    // jumped stream differs
+    Random stream(1);
+    stream.jump();
+    deck1 = original;
+    deck1.shuffle(stream);
+    CPPUNIT_ASSERT(deck0 != deck1);
+
+    // not seeded shuffles in same second differ
+    deck0 = original;
+    deck1 = original;
+    deck0.shuffle();
+    deck1.shuffle();
+    CPPUNIT_ASSERT(deck0 != deck1);
+}
+
+void CardTest::testGenerateSeeded()
+{
+    using namespace decore;
+
+    CounterRandom random(7, 3);
+    uint64_t numbers[4];
+    for (unsigned int i = 0; i < ARRAY_SIZE(numbers); ++i) {
+        numbers[i] = random.next();
+    }
+    // random access
+    CPPUNIT_ASSERT(random.at(2) == numbers[2]);
+    CPPUNIT_ASSERT(random.at(0) == numbers[0]);
+    CPPUNIT_ASSERT(CounterRandom(7, 3).next() == numbers[0]);
+    CPPUNIT_ASSERT(CounterRandom(7, 4).next() != numbers[0]);
+    CPPUNIT_ASSERT(CounterRandom(8, 3).next() != numbers[0]);
+
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    const unsigned int games = 8;
+    Deck decks[games];
+    // generate in reverse order
+    for (unsigned int i = games; i-- > 0;) {
+        decks[i].generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), 100, i);
+    }
+
+    for (unsigned int i = 0; i < games; ++i) {
+        Deck deck;
+        deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), 100, i);
+        CPPUNIT_ASSERT(deck == decks[i]);
+        CPPUNIT_ASSERT(deck.trumpSuit() == deck.back().suit());
+        CardSet cards;
+        cards.insert(deck.begin(), deck.end());
+        CPPUNIT_ASSERT(cards.size() == ARRAY_SIZE(ranks) * ARRAY_SIZE(suits));
+        if (i) {
+            CPPUNIT_ASSERT(deck != decks[i - 1]);
+        }
+        // other seed
+        deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), 101, i);
+        CPPUNIT_ASSERT(deck != decks[i]);
+    }
+}
+
+void CardTest::testDeckDeal()
+{
+    using namespace decore;
+
+    Deck deck;
+    deck.push_back(Card(SUIT_CLUBS, RANK_6));
+    deck.push_back(Card(SUIT_CLUBS, RANK_7));
+    deck.push_back(Card(SUIT_CLUBS, RANK_8));
+    deck.push_back(Card(SUIT_CLUBS, RANK_9));
+    deck.push_back(Card(SUIT_HEARTS, RANK_10));
+
+    CardSet cards;
+    CPPUNIT_ASSERT(2 == deck.deal(cards, 2));
+    CPPUNIT_ASSERT(2 == cards.size());
+    CPPUNIT_ASSERT(cards.count(Card(SUIT_CLUBS, RANK_6)));
+    CPPUNIT_ASSERT(cards.count(Card(SUIT_CLUBS, RANK_7)));
+
+    // the deck refers to not dealt cards only
+    CPPUNIT_ASSERT(3 == deck.size());
+    CPPUNIT_ASSERT(!deck.empty());
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_8) == deck.front());
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_8) == *deck.begin());
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_9) == deck[1]);
+    CPPUNIT_ASSERT(Card(SUIT_HEARTS, RANK_10) == deck.at(2));
+    CPPUNIT_ASSERT(3 == std::distance(deck.begin(), deck.end()));
+    CPPUNIT_ASSERT(SUIT_HEARTS == deck.trumpSuit());
+
+    // the copies do not keep dealt cards
+    Deck copy(deck);
+    CPPUNIT_ASSERT(copy == deck);
+    CPPUNIT_ASSERT(3 == copy.size());
+    CPPUNIT_ASSERT(3 == copy.capacity());
+    CPPUNIT_ASSERT(SUIT_HEARTS == copy.trumpSuit());
+    Deck assigned;
+    assigned = deck;
+    CPPUNIT_ASSERT(assigned == deck);
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_8) == assigned.front());
+    CPPUNIT_ASSERT(Card(SUIT_HEARTS, RANK_10) == assigned.back());
+
+    Deck rest;
+    rest.push_back(Card(SUIT_CLUBS, RANK_8));
+    rest.push_back(Card(SUIT_CLUBS, RANK_9));
+    rest.push_back(Card(SUIT_HEARTS, RANK_10));
+    CPPUNIT_ASSERT(rest == deck);
+
+    // not enough cards
+    CPPUNIT_ASSERT(3 == deck.deal(cards, 4));
+    CPPUNIT_ASSERT(5 == cards.size());
+    CPPUNIT_ASSERT(deck.empty());
+    CPPUNIT_ASSERT(deck.begin() == deck.end());
+    CPPUNIT_ASSERT(0 == deck.deal(cards, 1));
+    CPPUNIT_ASSERT(SUIT_HEARTS == deck.trumpSuit());
+
+    deck.clear();
+    deck.push_back(Card(SUIT_SPADES, RANK_ACE));
+    CPPUNIT_ASSERT(1 == deck.size());
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_ACE) == deck.front());
+}
+
 void CardTest::testGet()
 {
     using namespace decore;
@@ -212,3 +428,116 @@ void CardTest::testGetBySuit()
     CPPUNIT_ASSERT(10 == result.size());
     CPPUNIT_ASSERT((--result.end())->suit() == SUIT_DIAMONDS);
 }
+
+void CardTest::testSetOrder()
+{
+    using namespace decore;
+
+    Rank ranks[] = {
+        RANK_6,
+        RANK_10,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_CLUBS,
+        SUIT_SPADES,
+        SUIT_HEARTS,
+    };
+
+    CardSet set = GENERATE(ranks, suits);
+
+    // iteration order is the same as Card::operator<
+    std::vector<Card> cards(set.begin(), set.end());
+    CPPUNIT_ASSERT(9 == cards.size());
+    for (unsigned int i = 1; i < cards.size(); ++i) {
+        CPPUNIT_ASSERT(cards[i - 1] < cards[i]);
+    }
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_6) == *set.begin());
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_ACE) == *--set.end());
+
+    // reverse iteration
+    std::vector<Card> reversed;
+    for (CardSet::const_iterator it = set.end(); it != set.begin();) {
+        reversed.push_back(*--it);
+    }
+    CPPUNIT_ASSERT(std::vector<Card>(cards.rbegin(), cards.rend()) == reversed);
+
+    // card references stay valid after the set is gone
+    const Card* card;
+    {
+        CardSet other(set);
+        card = &*other.find(Card(SUIT_HEARTS, RANK_10));
+    }
+    CPPUNIT_ASSERT(Card(SUIT_HEARTS, RANK_10) == *card);
+}
+
+void CardTest::testSetOperations()
+{
+    using namespace decore;
+
+    CardSet set0;
+    set0.insert(Card(SUIT_CLUBS, RANK_6));
+    set0.insert(Card(SUIT_CLUBS, RANK_7));
+    set0.insert(Card(SUIT_HEARTS, RANK_7));
+
+    CardSet set1;
+    set1.insert(Card(SUIT_HEARTS, RANK_7));
+    set1.insert(Card(SUIT_DIAMONDS, RANK_ACE));
+
+    CardSet all(set0);
+    // set1 has a card from set0
+    CPPUNIT_ASSERT(!all.addAll(set1));
+    CPPUNIT_ASSERT(4 == all.size());
+    CPPUNIT_ASSERT(all.count(Card(SUIT_DIAMONDS, RANK_ACE)));
+
+    all.removeAll(set0);
+    CPPUNIT_ASSERT(1 == all.size());
+    CPPUNIT_ASSERT(Card(SUIT_DIAMONDS, RANK_ACE) == *all.begin());
+    CPPUNIT_ASSERT(all.addAll(set0));
+
+    CPPUNIT_ASSERT(CardSet(all.mask() & CardSet::rankMask(RANK_7)).size() == 2);
+    CPPUNIT_ASSERT(CardSet(all.mask() & CardSet::suitMask(SUIT_CLUBS)).size() == 2);
+    CPPUNIT_ASSERT(CardSet(CardSet::rankMask(RANK_6)).size() == SUIT_LAST);
+    CPPUNIT_ASSERT(CardSet(CardSet::suitMask(SUIT_SPADES)).size() == RANK_LAST);
+
+    all.erase(all.find(Card(SUIT_CLUBS, RANK_6)));
+    CPPUNIT_ASSERT(all.find(Card(SUIT_CLUBS, RANK_6)) == all.end());
+    all.clear();
+    CPPUNIT_ASSERT(all.empty());
+    CPPUNIT_ASSERT(all.begin() == all.end());
+}
+
+void CardTest::testInterned()
+{
+    using namespace decore;
+
+    CardSet set;
+    set.insert(Card(SUIT_SPADES, RANK_6));
+    set.insert(Card(SUIT_CLUBS, RANK_ACE));
+
+    const Card* first = &*set.begin();
+    const Card* last = &*--set.end();
+    CPPUNIT_ASSERT(first == &Card::interned(Card(SUIT_SPADES, RANK_6).index()));
+    CPPUNIT_ASSERT(last == &Card::interned(Card(SUIT_CLUBS, RANK_ACE).index()));
+    CPPUNIT_ASSERT(Card::internedIndex(last) == Card(SUIT_CLUBS, RANK_ACE).index());
+
+    // same object from another set
+    CardSet other(set);
+    CPPUNIT_ASSERT(first == &*other.begin());
+
+    CPPUNIT_ASSERT(set.contains(first));
+    CPPUNIT_ASSERT(set.contains(last));
+    // copy of the card is not interned
+    Card copy(*first);
+    CPPUNIT_ASSERT(!set.contains(&copy));
+    CPPUNIT_ASSERT(Card::internedIndex(&copy) == Card::INVALID_INDEX);
+    CPPUNIT_ASSERT(!set.contains(NULL));
+    // interned, but not in the set
+    CPPUNIT_ASSERT(!set.contains(&Card::interned(Card(SUIT_HEARTS, RANK_6).index())));
+
+    set.erase(*first);
+    CPPUNIT_ASSERT(!set.contains(first));
+    // the pointer stays valid
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_6) == *first);
+}
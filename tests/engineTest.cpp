@@ -1,9 +1,18 @@
 #include <algorithm>
+#include <set>
 
 #include "engineTest.h"
 #include "engine.h"
 #include "player.h"
 #include "rules.h"
+#include "deck.h"
+#include "atomic.h"
+#include "playerIds.h"
+#include "defines.h"
+#include "bufferWriter.h"
+#include "bufferReader.h"
+#include "saveFormat.h"
+#include "simulation.h"
 
 using namespace decore;
 
@@ -52,7 +61,411 @@ void EngineTest::testAddDuplicatedPlayers()
     CPPUNIT_ASSERT(std::find(ids.begin(), ids.end(), id1) != ids.end());
 }
 
+void EngineTest::testSeats()
+{
+    Engine engine;
+    TestPlayer players[4];
+    PlayerIds ids;
+    for (unsigned int i = 0; i < ARRAY_SIZE(players); ++i) {
+        ids.push_back(engine.add(players[i]));
+        CPPUNIT_ASSERT_EQUAL(i, ids.back()->seat());
+        CPPUNIT_ASSERT_EQUAL(i, ids.index(ids.back()));
+    }
+
+    // ids out of seat order are found as well
+    PlayerIds reversed;
+    reversed.insert(reversed.begin(), ids.rbegin(), ids.rend());
+    for (unsigned int i = 0; i < reversed.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, reversed.index(reversed[i]));
+    }
+
+    // seat indexed cards give same players as the map
+    std::vector<CardSet> seatsCards(ids.size());
+    std::map<const PlayerId*, CardSet> playersCards;
+    seatsCards[1].insert(Card(SUIT_CLUBS, RANK_6));
+    seatsCards[3].insert(Card(SUIT_CLUBS, RANK_7));
+    for (unsigned int i = 0; i < ids.size(); ++i) {
+        playersCards[ids[i]] = seatsCards[i];
+    }
+    for (unsigned int i = 0; i < ids.size(); ++i) {
+        CPPUNIT_ASSERT(Rules::pickNext(ids, ids[i], &playersCards) == Rules::pickNext(ids, ids[i], &seatsCards));
+        CPPUNIT_ASSERT(Rules::pickNext(reversed, ids[i], &playersCards) == Rules::pickNext(reversed, ids[i], &seatsCards));
+    }
+    CPPUNIT_ASSERT(ids[3] == Rules::pickNext(ids, ids[1], &seatsCards));
+    CPPUNIT_ASSERT(ids[1] == Rules::pickNext(ids, ids[3], &seatsCards));
+    CPPUNIT_ASSERT(ids[1] == Rules::pickNext(reversed, ids[3], &seatsCards));
+
+    // seats are limited
+    Engine full;
+    TestPlayer player;
+    for (unsigned int i = 0; i < Rules::MAX_SEATS; ++i) {
+        CPPUNIT_ASSERT(full.add(player));
+    }
+    CPPUNIT_ASSERT(!full.add(player));
+}
+
+void EngineTest::testNotThreadSafe()
+{
+    Deck deck;
+    generate(deck, 1, 1);
+
+    // same game with and without locks
+    Engine engine;
+    Engine notThreadSafe(false);
+    TestPlayer players[4];
+    for (unsigned int i = 0; i < ARRAY_SIZE(players); ++i) {
+        (i % 2 ? notThreadSafe : engine).add(players[i]);
+    }
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+    CPPUNIT_ASSERT(notThreadSafe.setDeck(deck));
+
+    bool next;
+    unsigned int rounds = 0;
+    do {
+        next = engine.playRound();
+        CPPUNIT_ASSERT(next == notThreadSafe.playRound());
+    } while (next && ++rounds < 100);
+
+    CPPUNIT_ASSERT(players[0].cardSets() == players[1].cardSets());
+    CPPUNIT_ASSERT(players[2].cardSets() == players[3].cardSets());
+    for (unsigned int i = 0; i < players[0].cardSets(); ++i) {
+        CPPUNIT_ASSERT(players[0].cards(i) == players[1].cards(i));
+    }
+    for (unsigned int i = 0; i < players[2].cardSets(); ++i) {
+        CPPUNIT_ASSERT(players[2].cards(i) == players[3].cards(i));
+    }
+
+    // quit from the same thread
+    notThreadSafe.quit();
+    CPPUNIT_ASSERT(!notThreadSafe.playRound());
+}
+
+void EngineTest::testAtomic()
+{
+    Atomic<bool> flag(false);
+    CPPUNIT_ASSERT(!flag.get());
+    CPPUNIT_ASSERT(!flag.setAndGet(true));
+    CPPUNIT_ASSERT(flag.setAndGet(true));
+    CPPUNIT_ASSERT(flag.get());
+
+    Atomic<uint64_t> counter(0xffffffffULL);
+    CPPUNIT_ASSERT(0xffffffffULL == counter.getAndAdd(2));
+    CPPUNIT_ASSERT(0x100000001ULL == counter.get());
+    CPPUNIT_ASSERT(0x100000001ULL == counter.setAndGet(0));
+    CPPUNIT_ASSERT(!counter.get());
+}
+
+void EngineTest::testSpectatorState()
+{
+    Deck deck;
+    generate(deck, 1, 2);
+    const unsigned int PLAYERS = 3;
+
+    {
+        // published state is same as the state built on request and matches the decisions
+        Engine engine;
+        Engine notThreadSafe(false);
+        TestPlayer players[PLAYERS * 2];
+        for (unsigned int i = 0; i < PLAYERS; ++i) {
+            engine.add(players[i]);
+            notThreadSafe.add(players[PLAYERS + i]);
+        }
+        CPPUNIT_ASSERT(engine.setDeck(deck));
+        CPPUNIT_ASSERT(notThreadSafe.setDeck(deck));
+
+        SpectatorState state;
+        engine.spectatorState(state);
+        CPPUNIT_ASSERT(PLAYERS == state.players);
+        CPPUNIT_ASSERT(deck.size() == state.deckCards);
+        CPPUNIT_ASSERT(deck.trumpSuit() == state.trumpSuit);
+        CPPUNIT_ASSERT(PlayerId::NO_SEAT == state.attacker);
+
+        Decision decision;
+        Decision notThreadSafeDecision;
+        unsigned int version = state.version;
+        while (engine.step(decision)) {
+            CPPUNIT_ASSERT(notThreadSafe.step(notThreadSafeDecision));
+            engine.spectatorState(state);
+            SpectatorState notThreadSafeState;
+            notThreadSafe.spectatorState(notThreadSafeState);
+            CPPUNIT_ASSERT(!memcmp(&state, &notThreadSafeState, sizeof(state)));
+            check(state, deck.size());
+            CPPUNIT_ASSERT(state.version > version);
+            version = state.version;
+
+            if (DECISION_DEFEND == decision.type) {
+                CPPUNIT_ASSERT(decision.player->seat() == state.defender);
+                CPPUNIT_ASSERT(decision.opponent->seat() == state.attacker);
+                CPPUNIT_ASSERT(state.attackCardsAmount == state.defendCardsAmount + 1);
+                CPPUNIT_ASSERT(decision.attackCard.index() == state.attackCards[state.attackCardsAmount - 1]);
+            } else {
+                CPPUNIT_ASSERT(decision.player->seat() == state.attacker);
+                CPPUNIT_ASSERT(decision.opponent->seat() == state.defender);
+            }
+            engine.submit(decision.ask(players[decision.player->seat()]));
+            notThreadSafe.submit(notThreadSafeDecision.ask(players[PLAYERS + notThreadSafeDecision.player->seat()]));
+        }
+        CPPUNIT_ASSERT(!notThreadSafe.step(notThreadSafeDecision));
+        engine.spectatorState(state);
+        CPPUNIT_ASSERT(state.ended);
+        CPPUNIT_ASSERT(!state.deckCards);
+        CPPUNIT_ASSERT(PlayerId::NO_SEAT == state.attacker);
+        CPPUNIT_ASSERT(PlayerId::NO_SEAT == state.defender);
+    }
+
+    {
+        // poll the state while the game is played
+        Engine engine;
+        TestPlayer players[PLAYERS];
+        for (unsigned int i = 0; i < PLAYERS; ++i) {
+            engine.add(players[i]);
+        }
+        CPPUNIT_ASSERT(engine.setDeck(deck));
+
+        pthread_t thread;
+        pthread_create(&thread, NULL, playThread, &engine);
+        SpectatorState state;
+        unsigned int version = 0;
+        do {
+            engine.spectatorState(state);
+            check(state, deck.size());
+            CPPUNIT_ASSERT(state.version >= version);
+            version = state.version;
+        } while (!state.ended);
+        pthread_join(thread, NULL);
+    }
+}
+
+void EngineTest::testPassWithoutCards()
+{
+    // the deck is empty, first attacker played the last card and the defender has beaten it,
+    // the other attacker could pitch 6
+    const Card attackerCards[] = {Card(SUIT_CLUBS, RANK_6), Card(SUIT_DIAMONDS, RANK_9)};
+    const Card defenderCards[] = {Card(SUIT_DIAMONDS, RANK_KING), Card(SUIT_DIAMONDS, RANK_ACE)};
+    const Card attackCard(SUIT_HEARTS, RANK_6);
+    const Card defendCard(SUIT_HEARTS, RANK_7);
+
+    BufferWriter game;
+    game.writeUint32(3);
+    SaveFormat::writeCards(game, attackerCards, attackerCards);
+    SaveFormat::writeCards(game, defenderCards, defenderCards + ARRAY_SIZE(defenderCards));
+    SaveFormat::writeCards(game, attackerCards, attackerCards + ARRAY_SIZE(attackerCards));
+    // the deck
+    SaveFormat::writeCards(game, attackerCards, attackerCards);
+    game.writeUint8(SUIT_SPADES);
+    // current player, round index
+    game.writeUint32(0);
+    game.writeUint32(5);
+    // the round: attackers 0 and 2, defender 1, no passes, attacker 0
+    game.writeUint8(true);
+    game.writeUint32(2);
+    game.writeUint32(0);
+    game.writeUint32(2);
+    game.writeUint32(1);
+    game.writeUint32(0);
+    game.writeUint32(0);
+    SaveFormat::writeCards(game, &attackCard, &attackCard + 1);
+    SaveFormat::writeCards(game, &defendCard, &defendCard + 1);
+    game.writeUint32(3);
+    game.writeUint8(false);
+
+    BufferWriter payload;
+    payload.writeUint32(game.size());
+    payload.writeBytes(game.data(), game.size());
+    // the players are the observers: no card sets saved
+    BufferWriter player;
+    player.write(0u);
+    payload.writeUint32(3);
+    for (unsigned int i = 0; i < 3; ++i) {
+        payload.writeUint32(player.size());
+        payload.writeBytes(player.data(), player.size());
+    }
+
+    BufferWriter saved;
+    saved.writeUint32(SaveFormat::MAGIC);
+    saved.writeUint32(SaveFormat::VERSION);
+    saved.writeUint32(payload.size());
+    saved.writeUint32(SaveFormat::crc32(payload.data(), payload.size()));
+    saved.writeBytes(payload.data(), payload.size());
+
+    BasePlayer players[3];
+    std::vector<Player*> playersVector;
+    for (unsigned int i = 0; i < ARRAY_SIZE(players); ++i) {
+        playersVector.push_back(&players[i]);
+    }
+    Engine engine;
+    BufferReader reader(saved.data(), saved.size());
+    CPPUNIT_ASSERT(engine.init(reader, playersVector, std::vector<GameObserver*>()));
+
+    // the attacker without cards passes
+    Decision decision;
+    CPPUNIT_ASSERT(engine.step(decision));
+    CPPUNIT_ASSERT(DECISION_PITCH == decision.type && 0 == decision.player->seat() && decision.cards.empty());
+
+    // same in the simulation
+    sim::GameState state;
+    CPPUNIT_ASSERT(engine.exportState(state));
+    sim::Move pass;
+    pass.type = sim::MOVE_PASS;
+    pass.card = Card::INVALID_INDEX;
+    sim::apply(state, pass);
+    CPPUNIT_ASSERT(5 == state.roundIndex && sim::PHASE_ATTACK == state.phase && 2 == state.attacker);
+
+    // the other attacker pitches before the round ends
+    CPPUNIT_ASSERT(engine.submit(NULL));
+    CPPUNIT_ASSERT(engine.step(decision));
+    CPPUNIT_ASSERT(DECISION_PITCH == decision.type && 2 == decision.player->seat());
+    CPPUNIT_ASSERT(1 == decision.cards.size() && decision.cards.count(attackerCards[0]));
+
+    // the pitch is not beaten, the last attacker with cards passes: the round ends
+    CPPUNIT_ASSERT(engine.submit(&*decision.cards.begin()));
+    CPPUNIT_ASSERT(engine.step(decision));
+    CPPUNIT_ASSERT(DECISION_DEFEND == decision.type && 1 == decision.player->seat());
+    CPPUNIT_ASSERT(engine.submit(NULL));
+    CPPUNIT_ASSERT(engine.step(decision));
+    CPPUNIT_ASSERT(DECISION_PITCH == decision.type && 2 == decision.player->seat());
+    CPPUNIT_ASSERT(engine.submit(NULL));
+    CPPUNIT_ASSERT(engine.step(decision));
+    SpectatorState spectatorState;
+    engine.spectatorState(spectatorState);
+    CPPUNIT_ASSERT(6 == spectatorState.roundIndex);
+}
+
+void EngineTest::check(const SpectatorState& state, unsigned int gameCards)
+{
+    unsigned int cards = state.deckCards + state.attackCardsAmount + state.defendCardsAmount;
+    for (unsigned int i = 0; i < state.players; ++i) {
+        cards += state.playersCards[i];
+    }
+    CPPUNIT_ASSERT(cards <= gameCards);
+    CPPUNIT_ASSERT(state.attackCardsAmount <= SpectatorState::MAX_TABLE_CARDS);
+    CPPUNIT_ASSERT(state.defendCardsAmount <= state.attackCardsAmount);
+    // no table cards between the rounds
+    CPPUNIT_ASSERT(PlayerId::NO_SEAT != state.defender || !state.attackCardsAmount);
+    CPPUNIT_ASSERT(PlayerId::NO_SEAT != state.defender || PlayerId::NO_SEAT == state.attacker);
+    for (unsigned int i = 0; i < state.attackCardsAmount; ++i) {
+        CPPUNIT_ASSERT(state.attackCards[i] < Card::INVALID_INDEX);
+    }
+    for (unsigned int i = 0; i < state.defendCardsAmount; ++i) {
+        CPPUNIT_ASSERT(state.defendCards[i] < Card::INVALID_INDEX);
+    }
+}
+
+void EngineTest::generate(Deck& deck, uint64_t seed, uint64_t gameIndex)
+{
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), seed, gameIndex);
+}
+
+void* EngineTest::playThread(void* data)
+{
+    Engine& engine = *static_cast<Engine*>(data);
+    while (engine.playRound());
+    return NULL;
+}
+
 void EngineTest::TestPlayer::idCreated(const PlayerId *id)
 {
     mIds.push_back(id);
 }
+
+void EngineTest::testEvents()
+{
+    Deck deck;
+    generate(deck, 2, 2);
+
+    EventRecorder recorder;
+    EventCollector collector;
+    EventsCheckPlayer player0(recorder, collector);
+    EventsCheckPlayer player1(recorder, collector);
+    EventsCheckPlayer player2(recorder, collector);
+
+    Engine engine;
+    engine.add(player0);
+    engine.add(player1);
+    engine.add(player2);
+    engine.addGameObserver(recorder);
+    engine.addEventObserver(collector);
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+
+    unsigned int rounds = 0;
+    while (engine.playRound() && ++rounds < 100);
+
+    // all the events are passed at the round end
+    compare(recorder.mEvents, collector.mEvents);
+    CPPUNIT_ASSERT(EVENT_GAME_STARTED == collector.mEvents[0].type);
+    CPPUNIT_ASSERT(EVENT_ROUND_ENDED == collector.mEvents.back().type);
+    CPPUNIT_ASSERT(collector.mBatches < collector.mEvents.size());
+}
+
+void EngineTest::compare(const std::vector<GameEvent>& expected, const std::vector<GameEvent>& actual)
+{
+    CPPUNIT_ASSERT(expected.size() == actual.size());
+    for (unsigned int i = 0; i < expected.size(); ++i) {
+        CPPUNIT_ASSERT(expected[i].type == actual[i].type);
+        CPPUNIT_ASSERT(expected[i].player == actual[i].player);
+        CPPUNIT_ASSERT(expected[i].value == actual[i].value);
+        CPPUNIT_ASSERT(expected[i].cards == actual[i].cards);
+        CPPUNIT_ASSERT(expected[i].suit == actual[i].suit);
+    }
+}
+
+EngineTest::EventCollector::EventCollector()
+    : mBatches(0)
+{
+}
+
+void EngineTest::EventCollector::events(const GameEvent* events, unsigned int amount)
+{
+    CPPUNIT_ASSERT(amount);
+    mEvents.insert(mEvents.end(), events, events + amount);
+    mBatches++;
+}
+
+EngineTest::EventsCheckPlayer::EventsCheckPlayer(const EventRecorder& recorder, const EventCollector& collector)
+    : mRecorder(recorder)
+    , mCollector(collector)
+{
+}
+
+const Card& EngineTest::EventsCheckPlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    check();
+    return BasePlayer::attack(playerId, cardSet);
+}
+
+const Card* EngineTest::EventsCheckPlayer::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    check();
+    return BasePlayer::pitch(playerId, cardSet);
+}
+
+const Card* EngineTest::EventsCheckPlayer::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    check();
+    return BasePlayer::defend(playerId, attackCard, cardSet);
+}
+
+void EngineTest::EventsCheckPlayer::check()
+{
+    // the events so far are passed before the move
+    compare(mRecorder.mEvents, mCollector.mEvents);
+}
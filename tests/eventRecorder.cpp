@@ -0,0 +1,112 @@
+#include <unistd.h>
+
+#include "eventRecorder.h"
+
+using namespace decore;
+
+EventRecorder::EventRecorder(unsigned int delay)
+    : mDelay(delay)
+{
+}
+
+void EventRecorder::add(GameEventType type, const PlayerId* player, unsigned int value, CardSet::Mask cards)
+{
+    GameEvent event;
+    event.cards = cards;
+    event.player = player;
+    event.value = value;
+    event.type = type;
+    event.suit = 0;
+    mEvents.push_back(event);
+}
+
+void EventRecorder::wait()
+{
+    if (mDelay) {
+        usleep(mDelay);
+    }
+}
+
+void EventRecorder::gameStarted(const Suit& trumpSuit, const CardSet& cardSet, const std::vector<const PlayerId*>& players)
+{
+    wait();
+    add(EVENT_GAME_STARTED, NULL, 0, cardSet.mask());
+    mEvents.back().suit = trumpSuit;
+    for (std::vector<const PlayerId*>::const_iterator it = players.begin(); it != players.end(); ++it) {
+        add(EVENT_PLAYER, *it, 0, 0);
+    }
+}
+
+void EventRecorder::gameRestored(const std::vector<const PlayerId*>& playerIds,
+    const std::map<const PlayerId*, unsigned int>& playersCards,
+    unsigned int deckCards,
+    const Suit& trumpSuit,
+    const std::vector<Card>& attackCards,
+    const std::vector<Card>& defendCards)
+{
+    wait();
+    add(EVENT_GAME_RESTORED, NULL, deckCards, 0);
+    mEvents.back().suit = trumpSuit;
+    for (std::vector<const PlayerId*>::const_iterator it = playerIds.begin(); it != playerIds.end(); ++it) {
+        add(EVENT_PLAYER, *it, playersCards.at(*it), 0);
+    }
+    for (std::vector<Card>::const_iterator it = attackCards.begin(); it != attackCards.end(); ++it) {
+        add(EVENT_TABLE_ATTACK_CARD, NULL, 0, CardSet::cardMask(*it));
+    }
+    for (std::vector<Card>::const_iterator it = defendCards.begin(); it != defendCards.end(); ++it) {
+        add(EVENT_TABLE_DEFEND_CARD, NULL, 0, CardSet::cardMask(*it));
+    }
+}
+
+void EventRecorder::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender)
+{
+    wait();
+    add(EVENT_ROUND_STARTED, defender, roundIndex, 0);
+    for (std::vector<const PlayerId*>::const_iterator it = attackers.begin(); it != attackers.end(); ++it) {
+        add(EVENT_ATTACKER, *it, 0, 0);
+    }
+}
+
+void EventRecorder::roundEnded(unsigned int roundIndex)
+{
+    wait();
+    add(EVENT_ROUND_ENDED, NULL, roundIndex, 0);
+}
+
+void EventRecorder::cardsPickedUp(const PlayerId* playerId, const CardSet& cardSet)
+{
+    wait();
+    add(EVENT_CARDS_PICKED_UP, playerId, 0, cardSet.mask());
+}
+
+void EventRecorder::cardsDealed(const PlayerId* playerId, unsigned int cardsAmount)
+{
+    wait();
+    add(EVENT_CARDS_DEALT, playerId, cardsAmount, 0);
+}
+
+void EventRecorder::cardsGone(const CardSet& cardSet)
+{
+    wait();
+    add(EVENT_CARDS_GONE, NULL, 0, cardSet.mask());
+}
+
+void EventRecorder::cardsDropped(const PlayerId* playerId, const CardSet& cardSet)
+{
+    wait();
+    add(EVENT_CARDS_DROPPED, playerId, 0, cardSet.mask());
+}
+
+void EventRecorder::save(DataWriter& writer)
+{
+    writer.write(static_cast<unsigned int>(mEvents.size()));
+}
+
+void EventRecorder::init(DataReader& reader)
+{
+    (void) reader;
+}
+
+void EventRecorder::quit()
+{
+}
@@ -812,7 +812,7 @@ void GameTest::DefendWithInvalidCardPlayer::cardsUpdated(const CardSet& cardSet)
 }
 
 
-void GameTest::TestPlayer0::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId *> attackers, const PlayerId *defender)
+void GameTest::TestPlayer0::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId *defender)
 {
     Observer::roundStarted(roundIndex, attackers, defender);
     BasePlayer::roundStarted(roundIndex, attackers, defender);
@@ -0,0 +1,42 @@
+#ifndef ALLOCATIONTEST_H
+#define ALLOCATIONTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "basePlayer.h"
+
+class AllocationTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(AllocationTest);
+    CPPUNIT_TEST(testLegalMoves);
+    CPPUNIT_TEST(testGame);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void testLegalMoves();
+    void testGame();
+
+private:
+    /**
+     * @brief Player which plays first available card and remembers nothing
+     */
+    class FirstCardPlayer : public BasePlayer
+    {
+    public:
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+        void cardsUpdated(const CardSet& cardSet);
+    };
+
+    /**
+     * @brief Plays the game and returns amount of allocations made while playing rounds
+     * @param players players amount
+     * @param rounds played rounds amount
+     * @param firstRoundAllocations allocations made in the first round
+     * @return allocations amount in the rest rounds
+     */
+    static unsigned int playGame(unsigned int players, unsigned int& rounds, unsigned int& firstRoundAllocations);
+};
+
+#endif /* ALLOCATIONTEST_H */
@@ -0,0 +1,75 @@
+#ifndef ASYNCOBSERVERTEST_H
+#define ASYNCOBSERVERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "basePlayer.h"
+#include "eventRecorder.h"
+#include "asyncObserver.h"
+#include "deck.h"
+
+class AsyncObserverTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(AsyncObserverTest);
+    CPPUNIT_TEST(testBlock);
+    CPPUNIT_TEST(testDropOldest);
+    CPPUNIT_TEST(testCoalesce);
+    CPPUNIT_TEST(testMaxSeats);
+    CPPUNIT_TEST(testSave);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void testBlock();
+    void testDropOldest();
+    void testCoalesce();
+    void testMaxSeats();
+    void testSave();
+
+private:
+    /**
+     * @brief Saves the observers on its move and checks that saved data are the same
+     */
+    class SavePlayer : public BasePlayer
+    {
+        EventRecorder& mRecorder;
+        AsyncObserver& mAsyncObserver;
+    public:
+        SavePlayer(EventRecorder& recorder, AsyncObserver& asyncObserver);
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+        /**
+         * @brief Amount of checked saves
+         */
+        unsigned int mSaves;
+    private:
+        void check();
+    };
+
+    /**
+     * @brief Plays the game with the observers
+     * @param observers observers
+     * @param seed deck seed
+     * @param players players amount
+     */
+    static void playGame(const std::vector<GameObserver*>& observers, uint64_t seed, unsigned int players = 3);
+    /**
+     * @brief Returns players' cards amount after the events
+     * @param events events
+     * @return cards amount of each player
+     */
+    static std::map<const PlayerId*, unsigned int> playersCards(const std::vector<GameEvent>& events);
+    /**
+     * @brief Checks that the events are equal
+     */
+    static bool equal(const GameEvent& first, const GameEvent& second);
+    /**
+     * @brief Generates shuffled deck of 36 cards, see Deck::generate()
+     * @param deck destination
+     * @param seed seed of the run
+     * @param gameIndex index of the game in the run
+     */
+    static void generate(Deck& deck, uint64_t seed, uint64_t gameIndex);
+};
+
+#endif /* ASYNCOBSERVERTEST_H */
@@ -22,7 +22,7 @@ public:
     void cardsRestored(const CardSet& cards);
 
     void gameStarted(const Suit& trumpSuit, const CardSet& cardSet, const std::vector<const PlayerId*>& players);
-    void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*> attackers, const PlayerId* defender);
+    void roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId* defender);
     void roundEnded(unsigned int roundIndex);
     void cardsPickedUp(const PlayerId* playerId, const CardSet& cardSet);
     void cardsDealed(const PlayerId* playerId, unsigned int cardsAmount);
@@ -0,0 +1,42 @@
+#ifndef BATCHRUNNERTEST_H
+#define BATCHRUNNERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "basePlayer.h"
+#include "batchRunner.h"
+#include "atomic.h"
+
+class BatchRunnerTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(BatchRunnerTest);
+    CPPUNIT_TEST(testGames);
+    CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void testGames();
+    void testThreads();
+
+private:
+    /**
+     * @brief Creates BasePlayer instances and counts them
+     */
+    class Factory : public PlayerFactory
+    {
+    public:
+        Factory();
+        Player* create(unsigned int seat, uint64_t gameIndex);
+        void destroy(Player* player);
+        /**
+         * @brief Amount of created players
+         */
+        Atomic<unsigned int> mCreated;
+        /**
+         * @brief Amount of destroyed players
+         */
+        Atomic<unsigned int> mDestroyed;
+    };
+};
+
+#endif /* BATCHRUNNERTEST_H */
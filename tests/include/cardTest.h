@@ -7,23 +7,37 @@ class CardTest : public CppUnit::TestFixture
 {
     CPPUNIT_TEST_SUITE(CardTest);
     CPPUNIT_TEST(testCreate);
+    CPPUNIT_TEST(testCard);
     CPPUNIT_TEST(testGenerate);
     CPPUNIT_TEST(testSetAddAll);
     CPPUNIT_TEST(testShuffle);
+    CPPUNIT_TEST(testShuffleSeeded);
+    CPPUNIT_TEST(testGenerateSeeded);
+    CPPUNIT_TEST(testDeckDeal);
     CPPUNIT_TEST(testGet);
     CPPUNIT_TEST(testGetByRank);
     CPPUNIT_TEST(testGetBySuit);
+    CPPUNIT_TEST(testSetOrder);
+    CPPUNIT_TEST(testSetOperations);
+    CPPUNIT_TEST(testInterned);
     CPPUNIT_TEST_SUITE_END();
 
 public:
 
     void testCreate();
+    void testCard();
     void testGenerate();
     void testSetAddAll();
     void testShuffle();
+    void testShuffleSeeded();
+    void testGenerateSeeded();
+    void testDeckDeal();
     void testGet();
     void testGetByRank();
     void testGetBySuit();
+    void testSetOrder();
+    void testSetOperations();
+    void testInterned();
 
 };
 
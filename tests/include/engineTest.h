@@ -3,17 +3,32 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include "player.h"
 #include "basePlayer.h"
+#include "eventObserver.h"
+#include "eventRecorder.h"
+#include "spectatorState.h"
 
 class EngineTest : public CppUnit::TestFixture
 {
     CPPUNIT_TEST_SUITE(EngineTest);
     CPPUNIT_TEST(testAddPlayers);
     CPPUNIT_TEST(testAddDuplicatedPlayers);
+    CPPUNIT_TEST(testSeats);
+    CPPUNIT_TEST(testNotThreadSafe);
+    CPPUNIT_TEST(testAtomic);
+    CPPUNIT_TEST(testEvents);
+    CPPUNIT_TEST(testSpectatorState);
+    CPPUNIT_TEST(testPassWithoutCards);
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void testAddPlayers();
     void testAddDuplicatedPlayers();
+    void testSeats();
+    void testNotThreadSafe();
+    void testAtomic();
+    void testEvents();
+    void testSpectatorState();
+    void testPassWithoutCards();
 
 private:
     class TestPlayer : public BasePlayer
@@ -23,6 +38,59 @@ private:
         void idCreated(const decore::PlayerId *id);
     };
 
+    /**
+     * @brief Stores received events
+     */
+    class EventCollector : public decore::EventObserver
+    {
+    public:
+        std::vector<decore::GameEvent> mEvents;
+        unsigned int mBatches;
+        EventCollector();
+        void events(const decore::GameEvent* events, unsigned int amount);
+    };
+
+    /**
+     * @brief Checks that all the events are passed before the move
+     */
+    class EventsCheckPlayer : public BasePlayer
+    {
+        const EventRecorder& mRecorder;
+        const EventCollector& mCollector;
+    public:
+        EventsCheckPlayer(const EventRecorder& recorder, const EventCollector& collector);
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+    private:
+        void check();
+    };
+
+    /**
+     * @brief Checks that the events are equal
+     * @param expected expected events
+     * @param actual actual events
+     */
+    static void compare(const std::vector<decore::GameEvent>& expected, const std::vector<decore::GameEvent>& actual);
+    /**
+     * @brief Checks that the spectator state is consistent
+     * @param state the state
+     * @param gameCards amount of the game cards
+     */
+    static void check(const decore::SpectatorState& state, unsigned int gameCards);
+    /**
+     * @brief Thread function: plays the game
+     * @param data Engine
+     */
+    static void* playThread(void* data);
+    /**
+     * @brief Generates shuffled deck of 36 cards, see Deck::generate()
+     * @param deck destination
+     * @param seed seed of the run
+     * @param gameIndex index of the game in the run
+     */
+    static void generate(decore::Deck& deck, uint64_t seed, uint64_t gameIndex);
+
 };
 
 #endif // ENGINETEST_H
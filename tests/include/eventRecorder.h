@@ -0,0 +1,47 @@
+#ifndef EVENTRECORDER_H
+#define EVENTRECORDER_H
+
+#include "gameObserver.h"
+#include "eventObserver.h"
+
+/**
+ * @brief Converts GameObserver notifications into the events, see GameEventType
+ */
+class EventRecorder : public decore::GameObserver
+{
+    /**
+     * @brief Delay of each notification, microseconds
+     */
+    unsigned int mDelay;
+public:
+    std::vector<decore::GameEvent> mEvents;
+    /**
+     * @brief Ctor
+     * @param delay delay of each notification to simulate slow observer, microseconds
+     */
+    explicit EventRecorder(unsigned int delay = 0);
+    void gameStarted(const decore::Suit& trumpSuit, const decore::CardSet& cardSet, const std::vector<const decore::PlayerId*>& players);
+    void gameRestored(const std::vector<const decore::PlayerId*>& playerIds,
+        const std::map<const decore::PlayerId*, unsigned int>& playersCards,
+        unsigned int deckCards,
+        const decore::Suit& trumpSuit,
+        const std::vector<decore::Card>& attackCards,
+        const std::vector<decore::Card>& defendCards);
+    void roundStarted(unsigned int roundIndex, const std::vector<const decore::PlayerId*>& attackers, const decore::PlayerId* defender);
+    void roundEnded(unsigned int roundIndex);
+    void cardsPickedUp(const decore::PlayerId* playerId, const decore::CardSet& cardSet);
+    void cardsDealed(const decore::PlayerId* playerId, unsigned int cardsAmount);
+    void cardsGone(const decore::CardSet& cardSet);
+    void cardsDropped(const decore::PlayerId* playerId, const decore::CardSet& cardSet);
+    /**
+     * @brief Writes amount of the recorded events
+     */
+    void save(decore::DataWriter& writer);
+    void init(decore::DataReader& reader);
+    void quit();
+private:
+    void add(decore::GameEventType type, const decore::PlayerId* player, unsigned int value, decore::CardSet::Mask cards);
+    void wait();
+};
+
+#endif /* EVENTRECORDER_H */
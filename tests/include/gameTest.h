@@ -52,7 +52,7 @@ private:
     {
     public:
 
-        void roundStarted(unsigned int roundIndex, const std::vector<const decore::PlayerId *> attackers, const decore::PlayerId *defender);
+        void roundStarted(unsigned int roundIndex, const std::vector<const decore::PlayerId*>& attackers, const decore::PlayerId *defender);
         void roundEnded(unsigned int roundIndex);
         void gameStarted(const decore::Suit &trumpSuit, const decore::CardSet &cardSet, const std::vector<const decore::PlayerId *>& players);
         void cardsGone(const decore::CardSet &cardSet);
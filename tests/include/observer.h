@@ -39,7 +39,7 @@ public:
     void cardsDropped(const decore::PlayerId *playerId, const decore::CardSet &cardSet);
     void cardsPickedUp(const decore::PlayerId* playerId, const decore::CardSet& cardSet);
     void cardsDealed(const decore::PlayerId* playerId, unsigned int cardsAmount);
-    void roundStarted(unsigned int roundIndex, const std::vector<const decore::PlayerId *> attackers, const decore::PlayerId *defender);
+    void roundStarted(unsigned int roundIndex, const std::vector<const decore::PlayerId*>& attackers, const decore::PlayerId *defender);
     void roundEnded(unsigned int roundIndex);
     void gameRestored(const std::vector<const decore::PlayerId*>& playerIds,
         const std::map<const decore::PlayerId*, unsigned int>& playersCards,
@@ -8,8 +8,10 @@ class RulesTest : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(RulesTest);
     CPPUNIT_TEST(testPickNext00);
     CPPUNIT_TEST(testPickNext01);
+    CPPUNIT_TEST(testNextSeat);
     CPPUNIT_TEST(testAttackCards);
     CPPUNIT_TEST(testDefendCards);
+    CPPUNIT_TEST(testBeats);
     CPPUNIT_TEST(testDeal0);
     CPPUNIT_TEST(testDeal1);
     CPPUNIT_TEST_SUITE_END();
@@ -17,8 +19,10 @@ class RulesTest : public CppUnit::TestFixture
 public:
     void testPickNext00();
     void testPickNext01();
+    void testNextSeat();
     void testAttackCards();
     void testDefendCards();
+    void testBeats();
     void testDeal0();
     void testDeal1();
 };
@@ -10,7 +10,11 @@
 #include "basePlayer.h"
 #include "dataWriter.h"
 #include "dataReader.h"
+#include "bufferWriter.h"
+#include "bufferReader.h"
 #include "gameCardsTracker.h"
+#include "asyncObserver.h"
+#include "atomic.h"
 #include "observer.h"
 
 using namespace decore;
@@ -24,6 +28,12 @@ class SaveRestoreTest : public CppUnit::TestFixture
     CPPUNIT_TEST(test02);
     CPPUNIT_TEST(test03);
     CPPUNIT_TEST(test04);
+    CPPUNIT_TEST(testJournal);
+    CPPUNIT_TEST(testSaveSnapshot);
+    CPPUNIT_TEST(testConcurrentSave);
+    CPPUNIT_TEST(testSaveFormat);
+    CPPUNIT_TEST(testMappedFile);
+    CPPUNIT_TEST(testBulkData);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -33,6 +43,12 @@ public:
     void test02();
     void test03();
     void test04();
+    void testJournal();
+    void testSaveSnapshot();
+    void testConcurrentSave();
+    void testSaveFormat();
+    void testMappedFile();
+    void testBulkData();
 
 private:
 
@@ -47,6 +63,8 @@ private:
         pthread_mutex_t mThreadMutex;
         pthread_cond_t mThreadSignal;
         Engine* mEngine;
+        bool mMoveReached;
+        bool mEngineReleased;
 
     public:
 
@@ -59,6 +77,8 @@ private:
         void setEngine(Engine* engine);
         void signalThread();
         Engine* waitForThread();
+        void releaseEngine();
+        void waitForRelease();
     };
 
     class ThreadData
@@ -106,6 +126,36 @@ private:
         unsigned int position() const;
     };
 
+    /**
+     * @brief Counts the writes of single elements and of the arrays
+     */
+    class CountingWriter : public BufferWriter
+    {
+    public:
+        using BufferWriter::write;
+        CountingWriter();
+        unsigned int mWrites;
+        unsigned int mArrayWrites;
+    protected:
+        void write(const void* data, unsigned int dataSizeBytes);
+        void writeArray(const void* data, unsigned int elementSizeBytes, unsigned int elementsCount);
+    };
+
+    /**
+     * @brief Counts the reads of single elements and of the arrays
+     */
+    class CountingReader : public BufferReader
+    {
+    public:
+        using BufferReader::read;
+        CountingReader(const BufferWriter& writer);
+        unsigned int mReads;
+        unsigned int mArrayReads;
+    protected:
+        void read(void* data, unsigned int dataSizeBytes);
+        void readArray(void* data, unsigned int elementSizeBytes, unsigned int elementsCount);
+    };
+
     class TestReader : public DataReader
     {
     public:
@@ -118,11 +168,83 @@ private:
         void read(void* data, unsigned int dataSizeBytes);
         unsigned int position() const;
     };
+    /**
+     * @brief Player which waits on the first attack only, the game goes on after that
+     */
+    class FirstAttackWaitPlayer : public BasePlayer
+    {
+        PlayerSyncData& mSyncData;
+        bool mWaited;
+    public:
+        FirstAttackWaitPlayer(PlayerSyncData& syncData);
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+    };
+
+    /**
+     * @brief Tracker which saves slowly: waits for the game to go on
+     */
+    class SlowTracker : public GameCardsTracker
+    {
+        PlayerSyncData& mSyncData;
+        pthread_mutex_t mMutex;
+        pthread_cond_t mSignal;
+        unsigned int mDroppedCards;
+        unsigned int mSnapshotDroppedCards;
+    public:
+        SlowTracker(PlayerSyncData& syncData);
+        ~SlowTracker();
+        void cardsDropped(const PlayerId* playerId, const CardSet& cardSet);
+        bool snapshot();
+        void save(DataWriter& writer);
+        bool mGameWentOn;
+    };
+
+    class TestJournal : public Journal
+    {
+    public:
+        TestJournal();
+        DataWriter& records();
+        void snapshot(const Engine& engine);
+        TestWriter mRecords;
+        TestWriter mSnapshot;
+        unsigned int mSnapshots;
+    };
+    /**
+     * @brief Saves the engine from other thread
+     */
+    class Saver
+    {
+    public:
+        Saver(const Engine& engine);
+        const Engine& mEngine;
+        std::vector<TestWriter> mSaves;
+        /**
+         * @brief Amount of the saves made
+         */
+        Atomic<unsigned int> mSaved;
+        /**
+         * @brief Not 0 if the saves should stop
+         */
+        Atomic<unsigned int> mStop;
+    };
+    static void* saveThread(void* data);
     static void* testThread(void* data);
+    static void* playThread(void* data);
     static void generate(Deck& deck);
     static void test(Player& player0, Player& player1, Player& restoredPlayer0, Player& restoredPlayer1, PlayerSyncData& syncData,
         GameCardsTracker& restoredTracker, Engine& restored, Observer& restoredObserver);
     static void checkNoDeal(std::vector<BasePlayer*> players);
+    /**
+     * @brief Plays the game in step mode for the amount of moves and saves it with the decision pending
+     * @param moves moves to play
+     * @param saved destination
+     */
+    static void saveAfterMoves(unsigned int moves, BufferWriter& saved);
+    /**
+     * @brief Updates the checksum in the header after the payload is changed
+     * @param saved saved data
+     */
+    static void updateChecksum(std::vector<unsigned char>& saved);
 };
 
 #endif /* SAVERESTORETEST_H */
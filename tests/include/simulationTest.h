@@ -0,0 +1,140 @@
+#ifndef SIMULATIONTEST_H
+#define SIMULATIONTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "basePlayer.h"
+#include "random.h"
+#include "simulation.h"
+
+namespace decore {
+class Engine;
+}
+
+class SimulationTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(SimulationTest);
+    CPPUNIT_TEST(testMoves);
+    CPPUNIT_TEST(testDifferential);
+    CPPUNIT_TEST(testUndo);
+    CPPUNIT_TEST(testEngineState);
+    CPPUNIT_TEST(testClone);
+    CPPUNIT_TEST(testSteps);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void testMoves();
+    void testDifferential();
+    void testUndo();
+    void testEngineState();
+    void testClone();
+    void testSteps();
+
+private:
+    /**
+     * @brief Player which makes random moves, see decide()
+     */
+    class RandomPlayer : public BasePlayer
+    {
+        Random mRandom;
+    public:
+        explicit RandomPlayer(uint64_t seed);
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+        /**
+         * @brief Returns current cards of the player
+         * @return cards
+         */
+        CardSet hand() const;
+
+    private:
+        const Card* pick(const CardSet& cardSet, bool canSkip);
+    };
+
+    /**
+     * @brief Random player which checks exported engine state on each move
+     */
+    class ExportingPlayer : public RandomPlayer
+    {
+        const Engine& mEngine;
+        unsigned int mSeat;
+    public:
+        ExportingPlayer(uint64_t seed, const Engine& engine, unsigned int seat);
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+        /**
+         * @brief Amount of checked moves
+         */
+        unsigned int mChecks;
+
+    private:
+        /**
+         * @brief Checks that the exported state offers the same cards and that each move could be taken back
+         */
+        void check(const CardSet& cardSet);
+    };
+
+    /**
+     * @brief Random player which clones the game on its move
+     *
+     * The clone is played by copies of the players, so it should end exactly as the source game.
+     */
+    class ForkingPlayer : public RandomPlayer
+    {
+        const Engine& mEngine;
+        const std::vector<RandomPlayer*>& mPlayers;
+        unsigned int mMoves;
+    public:
+        ForkingPlayer(uint64_t seed, const Engine& engine, const std::vector<RandomPlayer*>& players, unsigned int moves);
+        ~ForkingPlayer();
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+        /**
+         * @brief The clone, NULL if not created yet
+         */
+        Engine* mClone;
+        /**
+         * @brief Players of the clone
+         */
+        std::vector<RandomPlayer*> mClonePlayers;
+
+    private:
+        /**
+         * @brief Clones the game on the `mMoves`-th move
+         */
+        void fork();
+    };
+
+    /**
+     * @brief Random decision shared by the engine player and the simulation
+     * @param random generator
+     * @param cardsAmount amount of the cards to pick from, not 0
+     * @param canSkip true if pass or take allowed
+     * @return index of the card, `cardsAmount` to skip
+     */
+    static unsigned int decide(Random& random, unsigned int cardsAmount, bool canSkip);
+    /**
+     * @brief Plays the game with the engine and the simulation and compares each round
+     * @param players players amount
+     * @param seed run seed
+     * @param gameIndex game index
+     */
+    static void playGame(unsigned int players, uint64_t seed, uint64_t gameIndex);
+    /**
+     * @brief Generates shuffled 36 cards deck, see Deck::generate()
+     * @param deck destination
+     * @param seed seed of the run
+     * @param gameIndex index of the game in the run
+     */
+    static void generate(Deck& deck, uint64_t seed, uint64_t gameIndex);
+    /**
+     * @brief Applies and takes back each legal move, checks that the state is restored
+     * @param state game state
+     */
+    static void checkUndo(sim::GameState& state);
+};
+
+#endif /* SIMULATIONTEST_H */
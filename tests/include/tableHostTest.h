@@ -0,0 +1,89 @@
+#ifndef TABLEHOSTTEST_H
+#define TABLEHOSTTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <pthread.h>
+
+#include "basePlayer.h"
+#include "tableHost.h"
+#include "random.h"
+#include "atomic.h"
+
+class TableHostTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(TableHostTest);
+    CPPUNIT_TEST(testBots);
+    CPPUNIT_TEST(testExternal);
+    CPPUNIT_TEST(testRemoveFromListener);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void testBots();
+    void testExternal();
+    void testRemoveFromListener();
+
+private:
+    /**
+     * @brief Player which makes random moves
+     */
+    class Bot : public BasePlayer
+    {
+        Random mRandom;
+    public:
+        explicit Bot(uint64_t seed);
+        const Card& attack(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* pitch(const PlayerId* playerId, const CardSet& cardSet);
+        const Card* defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet);
+    private:
+        const Card* pick(const CardSet& cardSet, bool canSkip);
+    };
+
+    /**
+     * @brief Collects the tables which wait for external players and ended tables
+     */
+    class Listener : public TableListener
+    {
+        pthread_mutex_t mLock;
+    public:
+        Listener();
+        ~Listener();
+        void decisionPending(unsigned int table, const Decision& decision);
+        void tableEnded(unsigned int table, const PlayerId* loser);
+        /**
+         * @brief Takes the tables which wait for external players
+         * @param tables destination
+         */
+        void takePending(std::vector<unsigned int>& tables);
+        std::vector<unsigned int> mPending;
+        std::vector<unsigned int> mEnded;
+        std::vector<const PlayerId*> mLosers;
+    };
+
+    /**
+     * @brief Removes the tables right from the callbacks and uses the players after that
+     */
+    class RemovingListener : public TableListener
+    {
+    public:
+        RemovingListener();
+        void decisionPending(unsigned int table, const Decision& decision);
+        void tableEnded(unsigned int table, const PlayerId* loser);
+        TableHost* mHost;
+        Atomic<unsigned int> mRemoved;
+    };
+
+    /**
+     * @brief Plays the tables with the host and with Engine::playRound(), compares the results
+     * @param externalSeats seats played by the test thread
+     */
+    static void test(Rules::Seats externalSeats);
+    /**
+     * @brief Generates shuffled deck of 36 cards, see Deck::generate()
+     * @param deck destination
+     * @param seed seed of the run
+     * @param gameIndex index of the game in the run
+     */
+    static void generate(Deck& deck, uint64_t seed, uint64_t gameIndex);
+};
+
+#endif /* TABLEHOSTTEST_H */
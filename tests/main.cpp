@@ -7,6 +7,11 @@
 #include "engineTest.h"
 #include "gameTest.h"
 #include "saveRestoreTest.h"
+#include "allocationTest.h"
+#include "simulationTest.h"
+#include "batchRunnerTest.h"
+#include "asyncObserverTest.h"
+#include "tableHostTest.h"
 
 // tests to execute declaration
 CPPUNIT_TEST_SUITE_REGISTRATION(CardTest);
@@ -14,6 +19,11 @@ CPPUNIT_TEST_SUITE_REGISTRATION(RulesTest);
 CPPUNIT_TEST_SUITE_REGISTRATION(EngineTest);
 CPPUNIT_TEST_SUITE_REGISTRATION(GameTest);
 CPPUNIT_TEST_SUITE_REGISTRATION(SaveRestoreTest);
+CPPUNIT_TEST_SUITE_REGISTRATION(AllocationTest);
+CPPUNIT_TEST_SUITE_REGISTRATION(SimulationTest);
+CPPUNIT_TEST_SUITE_REGISTRATION(BatchRunnerTest);
+CPPUNIT_TEST_SUITE_REGISTRATION(AsyncObserverTest);
+CPPUNIT_TEST_SUITE_REGISTRATION(TableHostTest);
 
 int main(int, char **)
 {
@@ -66,7 +66,7 @@ void Observer::cardsDealed(const PlayerId *playerId, unsigned int cardsAmount)
     mGameCardsCount -= cardsAmount;
 }
 
-void Observer::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId *> attackers, const PlayerId *defender)
+void Observer::roundStarted(unsigned int roundIndex, const std::vector<const PlayerId*>& attackers, const PlayerId *defender)
 {
     assert(mRestored || mCurrentRoundIndex != roundIndex);
     mRestored = false;
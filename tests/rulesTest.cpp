@@ -89,6 +89,37 @@ void RulesTest::testPickNext01()
     }
 }
 
+void RulesTest::testNextSeat()
+{
+    using namespace decore;
+
+    CPPUNIT_ASSERT(Rules::allSeats(0) == 0);
+    CPPUNIT_ASSERT(Rules::allSeats(6) == 0x3f);
+    CPPUNIT_ASSERT(Rules::allSeats(Rules::MAX_SEATS) == ~static_cast<Rules::Seats>(0));
+
+    // all the sets of 8 seats against the seats rotation
+    const unsigned int SEATS = 8;
+    for (Rules::Seats seats = 0; seats <= Rules::allSeats(SEATS); ++seats) {
+        for (unsigned int after = 0; after < SEATS; ++after) {
+            unsigned int expected = PlayerId::NO_SEAT;
+            for (unsigned int i = 1; i < SEATS; ++i) {
+                unsigned int seat = (after + i) % SEATS;
+                if (seats & (static_cast<Rules::Seats>(1) << seat)) {
+                    expected = seat;
+                    break;
+                }
+            }
+            CPPUNIT_ASSERT(expected == Rules::nextSeat(seats, after));
+        }
+    }
+
+    // the last seat
+    const unsigned int LAST = Rules::MAX_SEATS - 1;
+    CPPUNIT_ASSERT(0 == Rules::nextSeat(Rules::allSeats(Rules::MAX_SEATS), LAST));
+    CPPUNIT_ASSERT(LAST == Rules::nextSeat(Rules::allSeats(Rules::MAX_SEATS), LAST - 1));
+    CPPUNIT_ASSERT(PlayerId::NO_SEAT == Rules::nextSeat(static_cast<Rules::Seats>(1) << LAST, LAST));
+}
+
 void RulesTest::testAttackCards()
 {
     using namespace decore;
@@ -118,6 +149,12 @@ void RulesTest::testAttackCards()
     CPPUNIT_ASSERT(2 == attackCards.size());
     CPPUNIT_ASSERT(attackCards.find(Card(SUIT_CLUBS, RANK_6)) != attackCards.end());
     CPPUNIT_ASSERT(attackCards.find(Card(SUIT_CLUBS, RANK_9)) != attackCards.end());
+
+    // same with ranks mask of the table
+    CPPUNIT_ASSERT((1 << RANK_6 | 1 << RANK_9) == tableCards.ranks());
+    CPPUNIT_ASSERT(attackCards == Rules::getAttackCards(tableCards.ranks(), playerCards));
+    CPPUNIT_ASSERT(playerCards == Rules::getAttackCards(0, playerCards));
+    CPPUNIT_ASSERT(CardSet(CardSet::rankColumns(tableCards.ranks())).size() == 2 * SUIT_LAST);
 }
 
 void RulesTest::testDefendCards()
@@ -166,6 +203,25 @@ void RulesTest::testDefendCards()
     CPPUNIT_ASSERT(defendCards.empty());
 }
 
+void RulesTest::testBeats()
+{
+    using namespace decore;
+
+    // check precomputed masks against the rule for each card and trump
+    for (unsigned int trump = 0; trump <= SUIT_LAST; ++trump) {
+        Suit trumpSuit = static_cast<Suit>(trump);
+        for (unsigned int index = 0; index < CardSet::CARDS; ++index) {
+            Card card(static_cast<Suit>(index / RANK_LAST), static_cast<Rank>(index % RANK_LAST));
+            CardSet beats(Rules::beats(card, trumpSuit));
+            for (unsigned int otherIndex = 0; otherIndex < CardSet::CARDS; ++otherIndex) {
+                Card other(static_cast<Suit>(otherIndex / RANK_LAST), static_cast<Rank>(otherIndex % RANK_LAST));
+                bool expected = card.suit() == other.suit() ? card.rank() < other.rank() : other.suit() == trumpSuit;
+                CPPUNIT_ASSERT(expected == (beats.find(other) != beats.end()));
+            }
+        }
+    }
+}
+
 void RulesTest::testDeal0()
 {
     using namespace decore;
@@ -1,4 +1,10 @@
+#include <algorithm>
 #include <cassert>
+#include <ctime>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "saveRestoreTest.h"
 #include "engine.h"
@@ -7,6 +13,9 @@
 #include "gameTest.h"
 #include "gameCardsTracker.h"
 #include "defines.h"
+#include "bufferReader.h"
+#include "mappedFileReader.h"
+#include "saveFormat.h"
 
 using namespace decore;
 
@@ -76,6 +85,8 @@ const Card* SaveRestoreTest::DefendWaitPlayer::defend(const PlayerId* playerId,
 SaveRestoreTest::PlayerSyncData::PlayerSyncData()
     : mDontWaitForMove(false)
     , mEngine(NULL)
+    , mMoveReached(false)
+    , mEngineReleased(false)
 {
     pthread_mutex_init(&mMoveMutex, NULL);
     pthread_cond_init(&mMoveSignal, NULL);
@@ -104,7 +115,7 @@ void SaveRestoreTest::PlayerSyncData::signalMove()
 void SaveRestoreTest::PlayerSyncData::waitForMove()
 {
     pthread_mutex_lock(&mMoveMutex);
-    if (!mDontWaitForMove) {
+    while (!mDontWaitForMove) {
         pthread_cond_wait(&mMoveSignal, &mMoveMutex);
     }
     pthread_mutex_unlock(&mMoveMutex);
@@ -121,6 +132,7 @@ void SaveRestoreTest::PlayerSyncData::signalThread()
 {
     pthread_mutex_lock(&mThreadMutex);
     assert(mEngine);
+    mMoveReached = true;
     pthread_cond_broadcast(&mThreadSignal);
     pthread_mutex_unlock(&mThreadMutex);
 }
@@ -128,13 +140,30 @@ void SaveRestoreTest::PlayerSyncData::signalThread()
 Engine* SaveRestoreTest::PlayerSyncData::waitForThread()
 {
     pthread_mutex_lock(&mThreadMutex);
-    if (!mEngine) {
+    while (!mMoveReached) {
         pthread_cond_wait(&mThreadSignal, &mThreadMutex);
     }
     pthread_mutex_unlock(&mThreadMutex);
     return mEngine;
 }
 
+void SaveRestoreTest::PlayerSyncData::releaseEngine()
+{
+    pthread_mutex_lock(&mThreadMutex);
+    mEngineReleased = true;
+    pthread_cond_broadcast(&mThreadSignal);
+    pthread_mutex_unlock(&mThreadMutex);
+}
+
+void SaveRestoreTest::PlayerSyncData::waitForRelease()
+{
+    pthread_mutex_lock(&mThreadMutex);
+    while (!mEngineReleased) {
+        pthread_cond_wait(&mThreadSignal, &mThreadMutex);
+    }
+    pthread_mutex_unlock(&mThreadMutex);
+}
+
 void* SaveRestoreTest::testThread(void* data)
 {
     ThreadData& threadData = *static_cast<ThreadData*>(data);
@@ -160,6 +189,9 @@ void* SaveRestoreTest::testThread(void* data)
 
     while (engine.playRound());
 
+    // the engine could still be in use by quit() from other thread
+    threadData.mSyncData.waitForRelease();
+
     return NULL;
 }
 
@@ -186,6 +218,7 @@ void SaveRestoreTest::test(Player& player0, Player& player1, Player& restoredPla
     engine->save(savedData);
     // request quit
     engine->quit();
+    syncData.releaseEngine();
 
     pthread_join(engineThread, NULL);
 
@@ -201,7 +234,7 @@ void SaveRestoreTest::test(Player& player0, Player& player1, Player& restoredPla
     observers.push_back(&restoredObserver);
 
     TestReader reader(savedData.mBytes);
-    restored.init(reader, restoredPlayers, observers);
+    CPPUNIT_ASSERT(restored.init(reader, restoredPlayers, observers));
 
     CPPUNIT_ASSERT(reader.mByteIndex == savedData.mBytes.size());
 
@@ -212,7 +245,7 @@ void SaveRestoreTest::test(Player& player0, Player& player1, Player& restoredPla
     Deck deck;
     generate(deck);
     CardSet expectedDeck;
-    expectedDeck.addAll(deck);
+    expectedDeck.insert(deck.begin(), deck.end());
 
     CPPUNIT_ASSERT(expectedDeck == restoredTracker.gameCards());
     CPPUNIT_ASSERT(SUIT_CLUBS == restoredTracker.trumpSuit());
@@ -466,11 +499,541 @@ void SaveRestoreTest::test04()
     CPPUNIT_ASSERT(6 == tracker.goneCards().size());
 }
 
+void SaveRestoreTest::testJournal()
+{
+    // crash the game after each amount of moves, recover from the journal, continue both games and compare
+    const unsigned int PLAYERS = 3;
+    // TestWriter prefixes each write with the size
+    const unsigned int RECORD_BYTES = sizeof(JournalRecord) + sizeof(unsigned int);
+    Deck deck;
+    generate(deck);
+
+    for (unsigned int crash = 1; ; ++crash) {
+        BasePlayer players[PLAYERS];
+        TestJournal journal;
+        Engine engine(false);
+        for (unsigned int i = 0; i < PLAYERS; ++i) {
+            engine.add(players[i]);
+        }
+        engine.setJournal(&journal, 3);
+        CPPUNIT_ASSERT(engine.setDeck(deck));
+
+        Decision decision;
+        bool ended = false;
+        for (unsigned int move = 0; move < crash && !ended; ++move) {
+            ended = !engine.step(decision);
+            // the crash while the last decision is pending: the answers not written to the journal are lost
+            if (!ended && move + 1 < crash) {
+                engine.submit(decision.ask(players[decision.player->seat()]));
+            }
+        }
+        if (ended) {
+            break;
+        }
+        CPPUNIT_ASSERT(journal.mSnapshots);
+
+        // the crash: torn last record
+        TestJournal recovered;
+        recovered.mSnapshot.mBytes = journal.mSnapshot.mBytes;
+        recovered.mRecords.mBytes = journal.mRecords.mBytes;
+        recovered.mRecords.write(JournalRecord());
+        recovered.mRecords.mBytes.pop_back();
+
+        BasePlayer recoveredPlayers[PLAYERS];
+        std::vector<Player*> playersVector;
+        for (unsigned int i = 0; i < PLAYERS; ++i) {
+            playersVector.push_back(&recoveredPlayers[i]);
+        }
+        Engine recoveredEngine(false);
+        TestReader snapshotReader(recovered.mSnapshot.mBytes);
+        CPPUNIT_ASSERT(recoveredEngine.init(snapshotReader, playersVector, std::vector<GameObserver*>()));
+        recoveredEngine.setJournal(&recovered, 3);
+        // only complete records are replayed
+        unsigned int records = recovered.mRecords.mBytes.size() / RECORD_BYTES;
+        recovered.mRecords.mBytes.resize(records * RECORD_BYTES);
+        TestReader recordsReader(recovered.mRecords.mBytes);
+        CPPUNIT_ASSERT(recoveredEngine.replay(recordsReader, records));
+        CPPUNIT_ASSERT(recordsReader.mByteIndex == recovered.mRecords.mBytes.size());
+
+        // shifted records are not reproduced
+        if (records > 1) {
+            Engine other(false);
+            BasePlayer otherPlayers[PLAYERS];
+            std::vector<Player*> otherPlayersVector;
+            for (unsigned int i = 0; i < PLAYERS; ++i) {
+                otherPlayersVector.push_back(&otherPlayers[i]);
+            }
+            TestReader otherSnapshotReader(recovered.mSnapshot.mBytes);
+            CPPUNIT_ASSERT(other.init(otherSnapshotReader, otherPlayersVector, std::vector<GameObserver*>()));
+            std::vector<unsigned char> tail(recovered.mRecords.mBytes.begin() + RECORD_BYTES, recovered.mRecords.mBytes.end());
+            TestReader tailReader(tail);
+            CPPUNIT_ASSERT(!other.replay(tailReader, records - 1));
+        }
+
+        // both games continue the same way, journals are same
+        bool running = true;
+        Decision recoveredDecision;
+        while (running) {
+            running = engine.step(decision);
+            CPPUNIT_ASSERT(running == recoveredEngine.step(recoveredDecision));
+            if (running) {
+                CPPUNIT_ASSERT(decision.type == recoveredDecision.type);
+                CPPUNIT_ASSERT(decision.player->seat() == recoveredDecision.player->seat());
+                CPPUNIT_ASSERT(decision.cards == recoveredDecision.cards);
+                engine.submit(decision.ask(players[decision.player->seat()]));
+                recoveredEngine.submit(recoveredDecision.ask(recoveredPlayers[recoveredDecision.player->seat()]));
+            }
+        }
+        CPPUNIT_ASSERT(journal.mRecords.mBytes == recovered.mRecords.mBytes);
+        CPPUNIT_ASSERT(!engine.getLoser() == !recoveredEngine.getLoser());
+        CPPUNIT_ASSERT(!engine.getLoser() || engine.getLoser()->seat() == recoveredEngine.getLoser()->seat());
+    }
+}
+
+void SaveRestoreTest::testSaveSnapshot()
+{
+    // the tracker's save() waits till the game plays next card: the engine should not be locked while the observers are saved
+    PlayerSyncData syncData;
+    FirstAttackWaitPlayer player0(syncData);
+    BasePlayer player1;
+    SlowTracker slowTracker(syncData);
+
+    Engine engine;
+    engine.add(player0);
+    engine.add(player1);
+    engine.addGameObserver(slowTracker);
+    Deck deck;
+    generate(deck);
+    engine.setDeck(deck);
+    syncData.setEngine(&engine);
+
+    pthread_t engineThread;
+    pthread_create(&engineThread, NULL, playThread, &engine);
+
+    // first attacker waits for the move
+    syncData.waitForThread();
+    TestWriter savedData;
+    // the attacker is released by the tracker's snapshot
+    engine.save(savedData);
+    pthread_join(engineThread, NULL);
+
+    CPPUNIT_ASSERT(slowTracker.mGameWentOn);
+
+    // the saved data is the state of the snapshot: before the attack
+    BasePlayer restoredPlayer0, restoredPlayer1;
+    std::vector<Player*> restoredPlayers;
+    restoredPlayers.push_back(&restoredPlayer0);
+    restoredPlayers.push_back(&restoredPlayer1);
+    GameCardsTracker restoredTracker;
+    std::vector<GameObserver*> observers;
+    observers.push_back(&restoredTracker);
+    Engine restored;
+    TestReader reader(savedData.mBytes);
+    CPPUNIT_ASSERT(restored.init(reader, restoredPlayers, observers));
+    CPPUNIT_ASSERT(reader.mByteIndex == savedData.mBytes.size());
+    CPPUNIT_ASSERT(restoredTracker.attackCards().empty());
+    CPPUNIT_ASSERT(24 == restoredTracker.deckCards());
+    CPPUNIT_ASSERT(restoredPlayer0.cards(restoredPlayer0.cardSets() - 1).size() == MAX_CARDS);
+    CPPUNIT_ASSERT(restored.playRound());
+}
+
+void SaveRestoreTest::testConcurrentSave()
+{
+    // the saves from two threads overlap: each save keeps the observers matching its game state
+    BasePlayer player0, player1;
+    GameCardsTracker tracker;
+    GameCardsTracker asyncTracker;
+    AsyncObserver asyncObserver(asyncTracker);
+
+    Engine engine;
+    engine.add(player0);
+    engine.add(player1);
+    engine.addGameObserver(tracker);
+    engine.addGameObserver(asyncObserver);
+    Deck deck;
+    generate(deck);
+    engine.setDeck(deck);
+
+    Saver saver0(engine), saver1(engine);
+    pthread_t saveThread0, saveThread1;
+    pthread_create(&saveThread0, NULL, saveThread, &saver0);
+    pthread_create(&saveThread1, NULL, saveThread, &saver1);
+
+    Player* players[] = {&player0, &player1};
+    Decision decision;
+    while (engine.step(decision)) {
+        // the game goes on after both threads saved it
+        while (!saver0.mSaved.get() || !saver1.mSaved.get()) {
+            sched_yield();
+        }
+        engine.submit(decision.ask(*players[decision.player->seat()]));
+    }
+    saver0.mStop.setAndGet(1);
+    saver1.mStop.setAndGet(1);
+    pthread_join(saveThread0, NULL);
+    pthread_join(saveThread1, NULL);
+    // the tracker gets the ids of the engine
+    asyncObserver.flush();
+
+    std::vector<TestWriter> saves(saver0.mSaves);
+    saves.insert(saves.end(), saver1.mSaves.begin(), saver1.mSaves.end());
+    CPPUNIT_ASSERT(!saves.empty());
+    for (std::vector<TestWriter>::const_iterator it = saves.begin(); it != saves.end(); ++it) {
+        BasePlayer restoredPlayer0, restoredPlayer1;
+        std::vector<Player*> restoredPlayers;
+        restoredPlayers.push_back(&restoredPlayer0);
+        restoredPlayers.push_back(&restoredPlayer1);
+        GameCardsTracker restoredTracker, restoredAsyncTracker;
+        std::vector<GameObserver*> observers;
+        observers.push_back(&restoredTracker);
+        observers.push_back(&restoredAsyncTracker);
+        Engine restored;
+        TestReader reader(it->mBytes);
+        CPPUNIT_ASSERT(restored.init(reader, restoredPlayers, observers));
+        CPPUNIT_ASSERT(reader.mByteIndex == it->mBytes.size());
+        // both trackers are saved at the same state
+        CPPUNIT_ASSERT(restoredTracker.deckCards() == restoredAsyncTracker.deckCards());
+        CPPUNIT_ASSERT(restoredTracker.goneCards() == restoredAsyncTracker.goneCards());
+        CPPUNIT_ASSERT(restoredTracker.lastRoundIndex() == restoredAsyncTracker.lastRoundIndex());
+        CPPUNIT_ASSERT(restoredTracker.attackCards() == restoredAsyncTracker.attackCards());
+        CPPUNIT_ASSERT(restoredTracker.defendCards() == restoredAsyncTracker.defendCards());
+    }
+}
+
+void* SaveRestoreTest::saveThread(void* data)
+{
+    Saver& saver = *static_cast<Saver*>(data);
+    while (!saver.mStop.get()) {
+        TestWriter writer;
+        saver.mEngine.save(writer);
+        if (!writer.mBytes.empty()) {
+            // the restore checks are slow, keep some of the saves
+            if (saver.mSaves.size() < 100) {
+                saver.mSaves.push_back(writer);
+            }
+            saver.mSaved.getAndAdd(1);
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+SaveRestoreTest::Saver::Saver(const Engine& engine)
+    : mEngine(engine)
+    , mSaved(0)
+    , mStop(0)
+{
+}
+
+void* SaveRestoreTest::playThread(void* data)
+{
+    Engine& engine = *static_cast<Engine*>(data);
+    while (engine.playRound());
+    return NULL;
+}
+
+SaveRestoreTest::FirstAttackWaitPlayer::FirstAttackWaitPlayer(PlayerSyncData& syncData)
+    : mSyncData(syncData)
+    , mWaited(false)
+{
+}
+
+const Card& SaveRestoreTest::FirstAttackWaitPlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    if (!mWaited) {
+        mWaited = true;
+        mSyncData.signalThread();
+        mSyncData.waitForMove();
+    }
+    return BasePlayer::attack(playerId, cardSet);
+}
+
+SaveRestoreTest::SlowTracker::SlowTracker(PlayerSyncData& syncData)
+    : mSyncData(syncData)
+    , mDroppedCards(0)
+    , mSnapshotDroppedCards(0)
+    , mGameWentOn(false)
+{
+    pthread_mutex_init(&mMutex, NULL);
+    pthread_cond_init(&mSignal, NULL);
+}
+
+SaveRestoreTest::SlowTracker::~SlowTracker()
+{
+    pthread_cond_destroy(&mSignal);
+    pthread_mutex_destroy(&mMutex);
+}
+
+void SaveRestoreTest::SlowTracker::cardsDropped(const PlayerId* playerId, const CardSet& cardSet)
+{
+    GameCardsTracker::cardsDropped(playerId, cardSet);
+    pthread_mutex_lock(&mMutex);
+    mDroppedCards++;
+    pthread_cond_broadcast(&mSignal);
+    pthread_mutex_unlock(&mMutex);
+}
+
+bool SaveRestoreTest::SlowTracker::snapshot()
+{
+    bool res = GameCardsTracker::snapshot();
+    pthread_mutex_lock(&mMutex);
+    mSnapshotDroppedCards = mDroppedCards;
+    pthread_mutex_unlock(&mMutex);
+    mSyncData.signalMove();
+    return res;
+}
+
+void SaveRestoreTest::SlowTracker::save(DataWriter& writer)
+{
+    // wait for the game, but not forever - the engine could be locked
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 10;
+    pthread_mutex_lock(&mMutex);
+    int res = 0;
+    while (mDroppedCards == mSnapshotDroppedCards && !res) {
+        res = pthread_cond_timedwait(&mSignal, &mMutex, &deadline);
+    }
+    mGameWentOn = mDroppedCards > mSnapshotDroppedCards;
+    pthread_mutex_unlock(&mMutex);
+    GameCardsTracker::save(writer);
+}
+
+void SaveRestoreTest::testSaveFormat()
+{
+    // CRC-32 check value
+    const char check[] = "123456789";
+    CPPUNIT_ASSERT(0xcbf43926 == SaveFormat::crc32(check, strlen(check)));
+
+    // numbers are little-endian on any platform
+    BufferWriter number;
+    number.writeUint32(0x04030201);
+    CPPUNIT_ASSERT(4 == number.size());
+    for (unsigned int i = 0; i < number.size(); ++i) {
+        CPPUNIT_ASSERT(i + 1 == number.data()[i]);
+    }
+
+    BufferWriter saved;
+    saveAfterMoves(5, saved);
+    CPPUNIT_ASSERT(saved.size() > SaveFormat::HEADER_SIZE);
+    CPPUNIT_ASSERT(!memcmp(saved.data(), "DCSV", 4));
+
+    BasePlayer players[2];
+    std::vector<Player*> playersVector;
+    playersVector.push_back(&players[0]);
+    playersVector.push_back(&players[1]);
+    GameCardsTracker tracker;
+    std::vector<GameObserver*> observers;
+    observers.push_back(&tracker);
+
+    // corrupted data, other version and other players count are rejected, the engine stays not initialized
+    Engine restored(false);
+    std::vector<unsigned char> corrupted(saved.data(), saved.data() + saved.size());
+    corrupted.back() ^= 1;
+    BufferReader corruptedReader(&corrupted[0], corrupted.size());
+    CPPUNIT_ASSERT(!restored.init(corruptedReader, playersVector, observers));
+
+    corrupted.assign(saved.data(), saved.data() + saved.size());
+    corrupted[4]++;
+    BufferReader versionReader(&corrupted[0], corrupted.size());
+    CPPUNIT_ASSERT(!restored.init(versionReader, playersVector, observers));
+
+    // the payload size is not covered by the checksum
+    corrupted.assign(saved.data(), saved.data() + saved.size());
+    memset(&corrupted[8], 0xff, 4);
+    BufferReader sizeReader(&corrupted[0], corrupted.size());
+    CPPUNIT_ASSERT(!restored.init(sizeReader, playersVector, observers));
+
+    BufferReader playersReader(saved.data(), saved.size());
+    CPPUNIT_ASSERT(!restored.init(playersReader, std::vector<Player*>(1, &players[0]), observers));
+
+    BufferReader truncatedReader(saved.data(), saved.size() - 1);
+    CPPUNIT_ASSERT(!restored.init(truncatedReader, playersVector, observers));
+
+    BufferReader observersReader(saved.data(), saved.size());
+    CPPUNIT_ASSERT(!restored.init(observersReader, playersVector, std::vector<GameObserver*>()));
+
+    // the checksum matches, but the data is not valid: game size is larger than the payload
+    const unsigned int gameOffset = SaveFormat::HEADER_SIZE + 4;
+    corrupted.assign(saved.data(), saved.data() + saved.size());
+    memset(&corrupted[SaveFormat::HEADER_SIZE], 0xff, 4);
+    updateChecksum(corrupted);
+    BufferReader gameSizeReader(&corrupted[0], corrupted.size());
+    CPPUNIT_ASSERT(!restored.init(gameSizeReader, playersVector, observers));
+
+    // not valid card of the first player
+    corrupted.assign(saved.data(), saved.data() + saved.size());
+    CPPUNIT_ASSERT(corrupted[gameOffset + 4]);
+    corrupted[gameOffset + 8] = 0xff;
+    updateChecksum(corrupted);
+    BufferReader cardReader(&corrupted[0], corrupted.size());
+    CPPUNIT_ASSERT(!restored.init(cardReader, playersVector, observers));
+
+    // not valid current player index: after players cards, the deck and the trump suit
+    corrupted.assign(saved.data(), saved.data() + saved.size());
+    unsigned int offset = gameOffset + 4;
+    for (unsigned int i = 0; i < playersVector.size() + 1; ++i) {
+        offset += 4 + corrupted[offset];
+    }
+    offset++;
+    CPPUNIT_ASSERT(!corrupted[offset + 1] && !corrupted[offset + 2] && !corrupted[offset + 3]);
+    corrupted[offset] = playersVector.size();
+    updateChecksum(corrupted);
+    BufferReader currentPlayerReader(&corrupted[0], corrupted.size());
+    CPPUNIT_ASSERT(!restored.init(currentPlayerReader, playersVector, observers));
+
+    // the same engine accepts valid data, all of it is read
+    BufferReader reader(saved.data(), saved.size());
+    CPPUNIT_ASSERT(restored.init(reader, playersVector, observers));
+    CPPUNIT_ASSERT(reader.position() == saved.size());
+    CPPUNIT_ASSERT(!reader.failed());
+
+    // saved again byte to byte
+    BufferWriter resaved;
+    restored.save(resaved);
+    CPPUNIT_ASSERT(resaved.size() == saved.size());
+    CPPUNIT_ASSERT(!memcmp(resaved.data(), saved.data(), saved.size()));
+}
+
+void SaveRestoreTest::updateChecksum(std::vector<unsigned char>& saved)
+{
+    BufferWriter checksum;
+    checksum.writeUint32(SaveFormat::crc32(&saved[SaveFormat::HEADER_SIZE], saved.size() - SaveFormat::HEADER_SIZE));
+    memcpy(&saved[SaveFormat::HEADER_SIZE - 4], checksum.data(), checksum.size());
+}
+
+void SaveRestoreTest::testMappedFile()
+{
+    BufferWriter saved;
+    saveAfterMoves(7, saved);
+
+    char path[] = "/tmp/decoreSaveXXXXXX";
+    int file = mkstemp(path);
+    CPPUNIT_ASSERT(file >= 0);
+    CPPUNIT_ASSERT(write(file, saved.data(), saved.size()) == static_cast<ssize_t>(saved.size()));
+    close(file);
+
+    MappedFileReader reader;
+    CPPUNIT_ASSERT(reader.open(path));
+    unlink(path);
+    CPPUNIT_ASSERT(reader.size() == saved.size());
+
+    BasePlayer players[2];
+    std::vector<Player*> playersVector;
+    playersVector.push_back(&players[0]);
+    playersVector.push_back(&players[1]);
+    GameCardsTracker tracker;
+    Engine restored(false);
+    CPPUNIT_ASSERT(restored.init(reader, playersVector, std::vector<GameObserver*>(1, &tracker)));
+    CPPUNIT_ASSERT(reader.position() == saved.size());
+    CPPUNIT_ASSERT(SUIT_CLUBS == tracker.trumpSuit());
+
+    // the restored game goes on to the end
+    Decision decision;
+    while (restored.step(decision)) {
+        restored.submit(decision.ask(players[decision.player->seat()]));
+    }
+    CPPUNIT_ASSERT(tracker.deckCards() == 0);
+
+    reader.close();
+    CPPUNIT_ASSERT(!reader.size());
+    CPPUNIT_ASSERT(!reader.open(path));
+}
+
+void SaveRestoreTest::testBulkData()
+{
+    Deck deck;
+    generate(deck);
+    CardSet cardSet;
+    cardSet.insert(deck.begin(), deck.end());
+    std::vector<Card> empty;
+
+    // deck is contiguous: amount and single array, card set is written card by card
+    CountingWriter writer;
+    writer.write(deck.begin(), deck.end());
+    CPPUNIT_ASSERT(1 == writer.mWrites && 1 == writer.mArrayWrites);
+    writer.write(cardSet.begin(), cardSet.end());
+    CPPUNIT_ASSERT(2 + cardSet.size() == writer.mWrites && 1 == writer.mArrayWrites);
+    writer.write(empty.begin(), empty.end());
+    CPPUNIT_ASSERT(3 + cardSet.size() == writer.mWrites && 1 == writer.mArrayWrites);
+    writer.write(&deck[0], &deck[0] + deck.size());
+    CPPUNIT_ASSERT(4 + cardSet.size() == writer.mWrites && 2 == writer.mArrayWrites);
+    writer.write(deck.begin(), deck.end());
+
+    // same layout: read in any way
+    const Card defaultCard(SUIT_LAST, RANK_LAST);
+    CountingReader reader(writer);
+    CardSet readCardSet;
+    reader.read(readCardSet, defaultCard);
+    CPPUNIT_ASSERT(cardSet == readCardSet);
+    CPPUNIT_ASSERT(1 + cardSet.size() == reader.mReads && 0 == reader.mArrayReads);
+    Deck readDeck;
+    reader.read(readDeck, defaultCard);
+    CPPUNIT_ASSERT(readDeck.size() == cardSet.size());
+    CPPUNIT_ASSERT(2 + cardSet.size() == reader.mReads && 1 == reader.mArrayReads);
+    // appended to the elements
+    std::vector<Card> cards(1, deck.back());
+    reader.read(cards, defaultCard);
+    CPPUNIT_ASSERT(1 == cards.size());
+    reader.read(cards, defaultCard);
+    CPPUNIT_ASSERT(1 + deck.size() == cards.size());
+    CPPUNIT_ASSERT(std::equal(deck.begin(), deck.end(), cards.begin() + 1));
+    CPPUNIT_ASSERT(4 + cardSet.size() == reader.mReads && 2 == reader.mArrayReads);
+    // appended after the top of the dealt deck
+    CardSet dealt;
+    CPPUNIT_ASSERT(30 == readDeck.deal(dealt, 30));
+    reader.read(readDeck, defaultCard);
+    CPPUNIT_ASSERT(cardSet.size() - 30 + deck.size() == readDeck.size());
+    CPPUNIT_ASSERT(std::equal(deck.begin(), deck.end(), readDeck.begin() + cardSet.size() - 30));
+    CPPUNIT_ASSERT(5 + cardSet.size() == reader.mReads && 3 == reader.mArrayReads);
+    CPPUNIT_ASSERT(reader.position() == writer.size() && !reader.failed());
+}
+
+void SaveRestoreTest::saveAfterMoves(unsigned int moves, BufferWriter& saved)
+{
+    BasePlayer players[2];
+    GameCardsTracker tracker;
+    Engine engine(false);
+    engine.add(players[0]);
+    engine.add(players[1]);
+    engine.addGameObserver(tracker);
+    Deck deck;
+    generate(deck);
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+
+    Decision decision;
+    while (moves--) {
+        CPPUNIT_ASSERT(engine.step(decision));
+        engine.submit(decision.ask(players[decision.player->seat()]));
+    }
+    CPPUNIT_ASSERT(engine.step(decision));
+    engine.save(saved);
+}
+
+SaveRestoreTest::TestJournal::TestJournal()
+    : mSnapshots(0)
+{
+}
+
+DataWriter& SaveRestoreTest::TestJournal::records()
+{
+    return mRecords;
+}
+
+void SaveRestoreTest::TestJournal::snapshot(const Engine& engine)
+{
+    mSnapshot.mBytes.clear();
+    engine.save(mSnapshot);
+    mRecords.mBytes.clear();
+    mSnapshots++;
+}
+
 void SaveRestoreTest::TestWriter::write(const void* data, unsigned int dataSizeBytes)
 {
     const unsigned char* dataPtr = static_cast<const unsigned char*>(data);
     assert(dataSizeBytes);
-    mBytes.push_back(dataSizeBytes);
+    const unsigned char* sizePtr = reinterpret_cast<const unsigned char*>(&dataSizeBytes);
+    mBytes.insert(mBytes.end(), sizePtr, sizePtr + sizeof(dataSizeBytes));
     while (dataSizeBytes--) {
         mBytes.push_back(*dataPtr++);
     }
@@ -481,6 +1044,43 @@ unsigned int SaveRestoreTest::TestWriter::position() const
     return mBytes.size();
 }
 
+SaveRestoreTest::CountingWriter::CountingWriter()
+    : mWrites(0)
+    , mArrayWrites(0)
+{
+}
+
+void SaveRestoreTest::CountingWriter::write(const void* data, unsigned int dataSizeBytes)
+{
+    mWrites++;
+    BufferWriter::write(data, dataSizeBytes);
+}
+
+void SaveRestoreTest::CountingWriter::writeArray(const void* data, unsigned int elementSizeBytes, unsigned int elementsCount)
+{
+    mArrayWrites++;
+    BufferWriter::write(data, elementSizeBytes * elementsCount);
+}
+
+SaveRestoreTest::CountingReader::CountingReader(const BufferWriter& writer)
+    : BufferReader(writer.data(), writer.size())
+    , mReads(0)
+    , mArrayReads(0)
+{
+}
+
+void SaveRestoreTest::CountingReader::read(void* data, unsigned int dataSizeBytes)
+{
+    mReads++;
+    BufferReader::read(data, dataSizeBytes);
+}
+
+void SaveRestoreTest::CountingReader::readArray(void* data, unsigned int elementSizeBytes, unsigned int elementsCount)
+{
+    mArrayReads++;
+    BufferReader::read(data, elementSizeBytes * elementsCount);
+}
+
 SaveRestoreTest::TestReader::TestReader(const std::vector<unsigned char>& bytes)
     : mByteIndex(0)
     , mBytes(bytes)
@@ -497,8 +1097,10 @@ void SaveRestoreTest::TestReader::read(void* data, unsigned int dataSizeBytes)
 {
     unsigned char* dataPtr = static_cast<unsigned char*>(data);
     assert(dataSizeBytes);
-    CPPUNIT_ASSERT(mByteIndex < mBytes.size());
-    unsigned char recordedDataSize = mBytes[mByteIndex++];
+    unsigned int recordedDataSize;
+    CPPUNIT_ASSERT(mByteIndex + sizeof(recordedDataSize) <= mBytes.size());
+    memcpy(&recordedDataSize, &mBytes[mByteIndex], sizeof(recordedDataSize));
+    mByteIndex += sizeof(recordedDataSize);
     CPPUNIT_ASSERT(dataSizeBytes == recordedDataSize);
     while (dataSizeBytes--) {
         CPPUNIT_ASSERT(mByteIndex < mBytes.size());
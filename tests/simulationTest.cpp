@@ -0,0 +1,610 @@
+#include <cstddef>
+#include <cstring>
+
+#include "simulationTest.h"
+#include "simulation.h"
+#include "engine.h"
+#include "deck.h"
+#include "observer.h"
+#include "eventRecorder.h"
+#include "defines.h"
+
+using namespace decore;
+
+SimulationTest::RandomPlayer::RandomPlayer(uint64_t seed)
+    : mRandom(seed)
+{
+}
+
+const Card& SimulationTest::RandomPlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    (void) playerId;
+    return *pick(cardSet, false);
+}
+
+const Card* SimulationTest::RandomPlayer::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    (void) playerId;
+    return pick(cardSet, true);
+}
+
+const Card* SimulationTest::RandomPlayer::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    (void) playerId;
+    (void) attackCard;
+    return pick(cardSet, true);
+}
+
+CardSet SimulationTest::RandomPlayer::hand() const
+{
+    return cardSets() ? cards(cardSets() - 1) : CardSet();
+}
+
+const Card* SimulationTest::RandomPlayer::pick(const CardSet& cardSet, bool canSkip)
+{
+    if (cardSet.empty()) {
+        return NULL;
+    }
+    unsigned int index = decide(mRandom, cardSet.size(), canSkip);
+    if (index == cardSet.size()) {
+        return NULL;
+    }
+    CardSet::const_iterator it = cardSet.begin();
+    std::advance(it, index);
+    removeCard(&*it);
+    return &*it;
+}
+
+SimulationTest::ExportingPlayer::ExportingPlayer(uint64_t seed, const Engine& engine, unsigned int seat)
+    : RandomPlayer(seed)
+    , mEngine(engine)
+    , mSeat(seat)
+    , mChecks(0)
+{
+}
+
+const Card& SimulationTest::ExportingPlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    check(cardSet);
+    return RandomPlayer::attack(playerId, cardSet);
+}
+
+const Card* SimulationTest::ExportingPlayer::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    check(cardSet);
+    return RandomPlayer::pitch(playerId, cardSet);
+}
+
+const Card* SimulationTest::ExportingPlayer::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    check(cardSet);
+    return RandomPlayer::defend(playerId, attackCard, cardSet);
+}
+
+void SimulationTest::ExportingPlayer::check(const CardSet& cardSet)
+{
+    sim::GameState state;
+    CPPUNIT_ASSERT(mEngine.exportState(state));
+    CPPUNIT_ASSERT(sim::toMove(state) == mSeat);
+    CPPUNIT_ASSERT(CardSet(state.hands[mSeat]) == hand());
+
+    sim::Move moves[sim::MAX_MOVES];
+    unsigned int amount = sim::legalMoves(state, moves);
+    CardSet cards;
+    for (unsigned int i = 0; i < amount; ++i) {
+        if (moves[i].type == sim::MOVE_CARD) {
+            cards.insert(Card::interned(moves[i].card));
+        }
+    }
+    CPPUNIT_ASSERT(cards == cardSet);
+
+    checkUndo(state);
+    mChecks++;
+}
+
+SimulationTest::ForkingPlayer::ForkingPlayer(uint64_t seed, const Engine& engine, const std::vector<RandomPlayer*>& players, unsigned int moves)
+    : RandomPlayer(seed)
+    , mEngine(engine)
+    , mPlayers(players)
+    , mMoves(moves)
+    , mClone(NULL)
+{
+}
+
+SimulationTest::ForkingPlayer::~ForkingPlayer()
+{
+    delete mClone;
+    for (std::vector<RandomPlayer*>::iterator it = mClonePlayers.begin(); it != mClonePlayers.end(); ++it) {
+        delete *it;
+    }
+}
+
+const Card& SimulationTest::ForkingPlayer::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    fork();
+    return RandomPlayer::attack(playerId, cardSet);
+}
+
+const Card* SimulationTest::ForkingPlayer::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    fork();
+    return RandomPlayer::pitch(playerId, cardSet);
+}
+
+const Card* SimulationTest::ForkingPlayer::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    fork();
+    return RandomPlayer::defend(playerId, attackCard, cardSet);
+}
+
+void SimulationTest::ForkingPlayer::fork()
+{
+    if (mClone || mMoves--) {
+        return;
+    }
+    // copies of the players make same decisions as the players from now on
+    std::vector<Player*> players;
+    for (std::vector<RandomPlayer*>::const_iterator it = mPlayers.begin(); it != mPlayers.end(); ++it) {
+        mClonePlayers.push_back(new RandomPlayer(**it));
+        players.push_back(mClonePlayers.back());
+    }
+    mClone = new Engine();
+    mClone->clone(mEngine, players, std::vector<GameObserver*>());
+
+    // same round state
+    sim::GameState state;
+    sim::GameState cloneState;
+    std::memset(&state, 0, sizeof(state));
+    std::memset(&cloneState, 0, sizeof(cloneState));
+    CPPUNIT_ASSERT(mEngine.exportState(state));
+    CPPUNIT_ASSERT(mClone->exportState(cloneState));
+    CPPUNIT_ASSERT(!std::memcmp(&state, &cloneState, sizeof(state)));
+}
+
+unsigned int SimulationTest::decide(Random& random, unsigned int cardsAmount, bool canSkip)
+{
+    if (canSkip && !random(4)) {
+        return cardsAmount;
+    }
+    return random(cardsAmount);
+}
+
+void SimulationTest::generate(Deck& deck, uint64_t seed, uint64_t gameIndex)
+{
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), seed, gameIndex);
+}
+
+void SimulationTest::playGame(unsigned int players, uint64_t seed, uint64_t gameIndex)
+{
+    Deck deck;
+    generate(deck, seed, gameIndex);
+
+    // engine game
+    Engine engine;
+    std::vector<RandomPlayer*> gamePlayers;
+    std::vector<const PlayerId*> ids;
+    for (unsigned int i = 0; i < players; ++i) {
+        gamePlayers.push_back(new RandomPlayer(gameIndex * sim::MAX_PLAYERS + i));
+        ids.push_back(engine.add(*gamePlayers.back()));
+    }
+    Observer observer;
+    engine.addGameObserver(observer);
+    CPPUNIT_ASSERT(engine.setDeck(deck));
+    while (engine.playRound());
+
+    // simulation game, each seat decides with same generator as the engine's player
+    sim::GameState state;
+    sim::init(state, deck, players);
+    std::vector<Random> randoms;
+    for (unsigned int i = 0; i < players; ++i) {
+        randoms.push_back(Random(gameIndex * sim::MAX_PLAYERS + i));
+    }
+    sim::Move moves[sim::MAX_MOVES];
+
+    // each round is compared with the observer's round data: roles, dropped and picked up cards
+    unsigned int roundIndex = state.roundIndex;
+    std::map<const PlayerId*, CardSet> droppedCards;
+    CardSet tableCards;
+    bool taken = false;
+    sim::GameState roundStart = state;
+    while (!sim::ended(state)) {
+        unsigned int movesAmount = sim::legalMoves(state, moves);
+        CPPUNIT_ASSERT(movesAmount);
+        bool canSkip = moves[movesAmount - 1].type != sim::MOVE_CARD;
+        unsigned int cardsAmount = canSkip ? movesAmount - 1 : movesAmount;
+        unsigned int seat = sim::toMove(state);
+        const sim::Move& move = moves[cardsAmount ? decide(randoms[seat], cardsAmount, canSkip) : 0];
+
+        if (move.type == sim::MOVE_CARD) {
+            droppedCards[ids[seat]].insert(Card::interned(move.card));
+            tableCards.insert(Card::interned(move.card));
+        } else if (move.type == sim::MOVE_TAKE) {
+            taken = true;
+        }
+
+        sim::apply(state, move);
+
+        if (state.roundIndex == roundIndex) {
+            continue;
+        }
+
+        const Observer::RoundData* roundData = observer.roundData(roundIndex);
+        CPPUNIT_ASSERT(roundData);
+        CPPUNIT_ASSERT(roundData->mPlayers.size() == roundStart.attackersAmount + 1u);
+        for (unsigned int i = 0; i < roundStart.attackersAmount; ++i) {
+            CPPUNIT_ASSERT(roundData->mPlayers[i] == ids[roundStart.attackers[i]]);
+        }
+        CPPUNIT_ASSERT(roundData->mPlayers.back() == ids[roundStart.defender]);
+        CPPUNIT_ASSERT(roundData->mDroppedCards == droppedCards);
+        CPPUNIT_ASSERT(roundData->mPickedUpCards.size() == (taken ? 1u : 0u));
+        if (taken) {
+            CPPUNIT_ASSERT(roundData->mPickedUpCards.begin()->first == ids[roundStart.defender]);
+            CPPUNIT_ASSERT(roundData->mPickedUpCards.begin()->second == tableCards);
+        }
+
+        // rounds ended without moves are not tracked
+        roundIndex = state.roundIndex;
+        roundStart = state;
+        droppedCards.clear();
+        tableCards.clear();
+        taken = false;
+    }
+
+    CPPUNIT_ASSERT(observer.rounds() == state.roundIndex);
+    for (unsigned int i = 0; i < players; ++i) {
+        CPPUNIT_ASSERT(gamePlayers[i]->hand() == CardSet(state.hands[i]));
+    }
+    const PlayerId* loser = engine.getLoser();
+    unsigned int simLoser = sim::loser(state);
+    CPPUNIT_ASSERT(loser ? simLoser != sim::NO_SEAT && ids[simLoser] == loser : simLoser == sim::NO_SEAT);
+
+    for (std::vector<RandomPlayer*>::iterator it = gamePlayers.begin(); it != gamePlayers.end(); ++it) {
+        delete *it;
+    }
+}
+
+void SimulationTest::checkUndo(sim::GameState& state)
+{
+    sim::GameState origin;
+    std::memcpy(&origin, &state, sizeof(state));
+
+    sim::Move moves[sim::MAX_MOVES];
+    unsigned int amount = sim::legalMoves(state, moves);
+    for (unsigned int i = 0; i < amount; ++i) {
+        sim::Undo record;
+        sim::apply(state, moves[i], record);
+        // one more level
+        sim::Move nextMoves[sim::MAX_MOVES];
+        unsigned int nextAmount = sim::legalMoves(state, nextMoves);
+        for (unsigned int j = 0; j < nextAmount; ++j) {
+            sim::GameState next;
+            std::memcpy(&next, &state, sizeof(state));
+            sim::Undo nextRecord;
+            sim::apply(state, nextMoves[j], nextRecord);
+            sim::undo(state, nextRecord);
+            CPPUNIT_ASSERT(!std::memcmp(&next, &state, sizeof(state)));
+        }
+        sim::undo(state, record);
+        CPPUNIT_ASSERT(!std::memcmp(&origin, &state, sizeof(state)));
+    }
+}
+
+void SimulationTest::testMoves()
+{
+    Deck deck;
+    deck.push_back(Card(SUIT_CLUBS, RANK_6));
+    deck.push_back(Card(SUIT_CLUBS, RANK_7));
+    deck.push_back(Card(SUIT_HEARTS, RANK_6));
+    deck.push_back(Card(SUIT_HEARTS, RANK_8));
+    deck.push_back(Card(SUIT_SPADES, RANK_7));
+    deck.push_back(Card(SUIT_SPADES, RANK_9));
+    deck.setTrumpSuit(SUIT_SPADES);
+
+    sim::GameState state;
+    sim::init(state, deck, 2);
+    // round-robin deal from seat 0
+    CPPUNIT_ASSERT(CardSet(state.hands[0]).count(Card(SUIT_CLUBS, RANK_6)));
+    CPPUNIT_ASSERT(CardSet(state.hands[1]).count(Card(SUIT_CLUBS, RANK_7)));
+    CPPUNIT_ASSERT(3 == CardSet(state.hands[0]).size());
+    CPPUNIT_ASSERT(3 == CardSet(state.hands[1]).size());
+    CPPUNIT_ASSERT(0 == sim::deckCards(state));
+    CPPUNIT_ASSERT(0 == sim::toMove(state));
+
+    sim::Move moves[sim::MAX_MOVES];
+    // first attack is mandatory: all cards, no pass
+    unsigned int amount = sim::legalMoves(state, moves);
+    CPPUNIT_ASSERT(3 == amount);
+    for (unsigned int i = 0; i < amount; ++i) {
+        CPPUNIT_ASSERT(sim::MOVE_CARD == moves[i].type);
+    }
+    // attack with clubs 6
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_6).index() == moves[2].card);
+    sim::apply(state, moves[2]);
+    CPPUNIT_ASSERT(sim::PHASE_DEFEND == state.phase);
+    CPPUNIT_ASSERT(1 == sim::toMove(state));
+
+    // defender: trump spades 9, clubs 7 and take
+    amount = sim::legalMoves(state, moves);
+    CPPUNIT_ASSERT(3 == amount);
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_9).index() == moves[0].card);
+    CPPUNIT_ASSERT(Card(SUIT_CLUBS, RANK_7).index() == moves[1].card);
+    CPPUNIT_ASSERT(sim::MOVE_TAKE == moves[2].type);
+    sim::apply(state, moves[1]);
+
+    // attacker: spades 7 and hearts 6 match the table ranks, or pass
+    CPPUNIT_ASSERT(0 == sim::toMove(state));
+    amount = sim::legalMoves(state, moves);
+    CPPUNIT_ASSERT(3 == amount);
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_7).index() == moves[0].card);
+    CPPUNIT_ASSERT(Card(SUIT_HEARTS, RANK_6).index() == moves[1].card);
+    CPPUNIT_ASSERT(sim::MOVE_PASS == moves[2].type);
+
+    // state is a value
+    sim::GameState copy;
+    std::memcpy(&copy, &state, sizeof(state));
+    sim::apply(copy, moves[2]);
+    CPPUNIT_ASSERT(sim::PHASE_ATTACK == state.phase);
+    CPPUNIT_ASSERT(0 == state.roundIndex);
+
+    // pass - defended, the defender attacks next
+    CPPUNIT_ASSERT(1 == copy.roundIndex);
+    CPPUNIT_ASSERT(1 == sim::toMove(copy));
+    CPPUNIT_ASSERT(!copy.table);
+
+    // attack with hearts 6 and take
+    sim::apply(state, moves[1]);
+    amount = sim::legalMoves(state, moves);
+    CPPUNIT_ASSERT(sim::MOVE_TAKE == moves[amount - 1].type);
+    sim::apply(state, moves[amount - 1]);
+    // the defender took the cards - the attacker may pitch spades 7
+    CPPUNIT_ASSERT(0 == sim::toMove(state));
+    amount = sim::legalMoves(state, moves);
+    CPPUNIT_ASSERT(2 == amount);
+    CPPUNIT_ASSERT(Card(SUIT_SPADES, RANK_7).index() == moves[0].card);
+    sim::apply(state, moves[0]);
+    // the table is full: 3 attack cards for 3 defender's cards - round ended
+    CPPUNIT_ASSERT(1 == state.roundIndex);
+    CPPUNIT_ASSERT(6 == CardSet(state.hands[1]).size());
+    CPPUNIT_ASSERT(!state.hands[0]);
+    CPPUNIT_ASSERT(sim::ended(state));
+    CPPUNIT_ASSERT(1 == sim::loser(state));
+}
+
+void SimulationTest::testDifferential()
+{
+    const unsigned int GAMES = 200;
+    for (unsigned int players = 2; players <= sim::MAX_PLAYERS; ++players) {
+        for (unsigned int game = 0; game < GAMES; ++game) {
+            playGame(players, players, game);
+        }
+    }
+}
+
+void SimulationTest::testUndo()
+{
+    // a branch is cheap
+    CPPUNIT_ASSERT(sizeof(sim::Undo) <= 64);
+
+    Random random(5);
+    sim::Move moves[sim::MAX_MOVES];
+    for (unsigned int players = 2; players <= sim::MAX_PLAYERS; ++players) {
+        for (unsigned int game = 0; game < 20; ++game) {
+            Deck deck;
+            generate(deck, players, game);
+            sim::GameState state;
+            // the memcmp checks compare padding too
+            std::memset(&state, 0, sizeof(state));
+            sim::init(state, deck, players);
+
+            // play the game keeping the undo records, each state is checked
+            std::vector<sim::Undo> records;
+            std::vector<sim::GameState> states;
+            while (!sim::ended(state)) {
+                checkUndo(state);
+                states.push_back(state);
+                unsigned int amount = sim::legalMoves(state, moves);
+                records.push_back(sim::Undo());
+                sim::apply(state, moves[random(amount)], records.back());
+            }
+            // take back the whole game
+            while (!records.empty()) {
+                sim::undo(state, records.back());
+                records.pop_back();
+                CPPUNIT_ASSERT(!std::memcmp(&states.back(), &state, sizeof(state)));
+                states.pop_back();
+            }
+        }
+    }
+}
+
+void SimulationTest::testEngineState()
+{
+    for (unsigned int players = 2; players <= sim::MAX_PLAYERS; ++players) {
+        Deck deck;
+        generate(deck, 11, players);
+
+        Engine engine;
+        sim::GameState state;
+        // no round is being played
+        CPPUNIT_ASSERT(!engine.exportState(state));
+
+        std::vector<ExportingPlayer*> gamePlayers;
+        for (unsigned int i = 0; i < players; ++i) {
+            gamePlayers.push_back(new ExportingPlayer(i, engine, i));
+            engine.add(*gamePlayers.back());
+        }
+        CPPUNIT_ASSERT(engine.setDeck(deck));
+        while (engine.playRound());
+        CPPUNIT_ASSERT(!engine.exportState(state));
+
+        for (std::vector<ExportingPlayer*>::iterator it = gamePlayers.begin(); it != gamePlayers.end(); ++it) {
+            CPPUNIT_ASSERT((*it)->mChecks);
+            delete *it;
+        }
+    }
+}
+
+void SimulationTest::testClone()
+{
+    unsigned int clones = 0;
+    for (unsigned int players = 2; players <= sim::MAX_PLAYERS; ++players) {
+        for (unsigned int moves = 0; moves < 30; moves += 3) {
+            Deck deck;
+            generate(deck, 13, players * 100 + moves);
+
+            Engine engine;
+            std::vector<RandomPlayer*> gamePlayers;
+            // the last player forks the game
+            for (unsigned int i = 0; i < players - 1; ++i) {
+                gamePlayers.push_back(new RandomPlayer(i));
+            }
+            ForkingPlayer* forkingPlayer = new ForkingPlayer(players, engine, gamePlayers, moves);
+            gamePlayers.push_back(forkingPlayer);
+
+            for (std::vector<RandomPlayer*>::iterator it = gamePlayers.begin(); it != gamePlayers.end(); ++it) {
+                engine.add(**it);
+            }
+            CPPUNIT_ASSERT(engine.setDeck(deck));
+            while (engine.playRound());
+
+            if (forkingPlayer->mClone) {
+                clones++;
+                Engine& clone = *forkingPlayer->mClone;
+                while (clone.playRound());
+
+                // same end of the game
+                for (unsigned int i = 0; i < players; ++i) {
+                    CPPUNIT_ASSERT(gamePlayers[i]->hand() == forkingPlayer->mClonePlayers[i]->hand());
+                }
+                const PlayerId* loser = engine.getLoser();
+                const PlayerId* cloneLoser = clone.getLoser();
+                CPPUNIT_ASSERT(!loser == !cloneLoser);
+                if (loser) {
+                    unsigned int seat = players;
+                    for (unsigned int i = 0; i < players; ++i) {
+                        if (gamePlayers[i]->id() == loser) {
+                            seat = i;
+                        }
+                    }
+                    CPPUNIT_ASSERT(seat < players);
+                    CPPUNIT_ASSERT(forkingPlayer->mClonePlayers[seat]->id() == cloneLoser);
+                }
+            }
+
+            for (std::vector<RandomPlayer*>::iterator it = gamePlayers.begin(); it != gamePlayers.end(); ++it) {
+                delete *it;
+            }
+        }
+    }
+    // most of the games are long enough
+    CPPUNIT_ASSERT(clones > 25);
+}
+
+void SimulationTest::testSteps()
+{
+    // the tables played by playRound() and by step() from one thread, same players and decks
+    const unsigned int TABLES = 10;
+    std::vector<Engine*> engines;
+    std::vector<Engine*> steppedEngines;
+    std::vector<EventRecorder*> recorders;
+    std::vector<EventRecorder*> steppedRecorders;
+    std::vector<std::vector<RandomPlayer*> > players(TABLES);
+    std::vector<std::vector<RandomPlayer*> > steppedPlayers(TABLES);
+    for (unsigned int table = 0; table < TABLES; ++table) {
+        Deck deck;
+        generate(deck, 17, table);
+        engines.push_back(new Engine());
+        steppedEngines.push_back(new Engine(false));
+        recorders.push_back(new EventRecorder());
+        steppedRecorders.push_back(new EventRecorder());
+        for (unsigned int i = 0; i < 2 + table % (sim::MAX_PLAYERS - 1); ++i) {
+            players[table].push_back(new RandomPlayer(table * sim::MAX_PLAYERS + i));
+            steppedPlayers[table].push_back(new RandomPlayer(table * sim::MAX_PLAYERS + i));
+            engines[table]->add(*players[table].back());
+            steppedEngines[table]->add(*steppedPlayers[table].back());
+        }
+        engines[table]->addGameObserver(*recorders[table]);
+        steppedEngines[table]->addGameObserver(*steppedRecorders[table]);
+        CPPUNIT_ASSERT(engines[table]->setDeck(deck));
+        CPPUNIT_ASSERT(steppedEngines[table]->setDeck(deck));
+        // nothing to answer before step()
+        CPPUNIT_ASSERT(!steppedEngines[table]->submit(NULL));
+        while (engines[table]->playRound());
+    }
+
+    // one decision of each table in turn
+    unsigned int decisions = 0;
+    bool stepped;
+    do {
+        stepped = false;
+        for (unsigned int table = 0; table < TABLES; ++table) {
+            Engine& engine = *steppedEngines[table];
+            Decision decision;
+            if (!engine.step(decision)) {
+                continue;
+            }
+            stepped = true;
+            decisions++;
+            // same decision till the answer is submitted
+            Decision pending;
+            CPPUNIT_ASSERT(engine.step(pending));
+            CPPUNIT_ASSERT(pending.type == decision.type);
+            CPPUNIT_ASSERT(pending.player == decision.player);
+            CPPUNIT_ASSERT(pending.cards == decision.cards);
+
+            const Card* answer = decision.ask(*steppedPlayers[table][decision.player->seat()]);
+            if (answer) {
+                // the answer is identified by value
+                Card card = *answer;
+                CPPUNIT_ASSERT(engine.submit(&card));
+            } else {
+                CPPUNIT_ASSERT(engine.submit(NULL));
+            }
+            // duplicate answer is ignored, it does not answer the next decision
+            CPPUNIT_ASSERT(!engine.submit(NULL));
+        }
+    } while (stepped);
+    CPPUNIT_ASSERT(decisions > TABLES);
+
+    for (unsigned int table = 0; table < TABLES; ++table) {
+        // same notifications
+        const std::vector<GameEvent>& events = recorders[table]->mEvents;
+        const std::vector<GameEvent>& steppedEvents = steppedRecorders[table]->mEvents;
+        CPPUNIT_ASSERT(events.size() == steppedEvents.size());
+        for (unsigned int i = 0; i < events.size(); ++i) {
+            CPPUNIT_ASSERT(events[i].type == steppedEvents[i].type);
+            CPPUNIT_ASSERT(events[i].cards == steppedEvents[i].cards);
+            CPPUNIT_ASSERT(events[i].value == steppedEvents[i].value);
+            CPPUNIT_ASSERT(!events[i].player == !steppedEvents[i].player);
+            CPPUNIT_ASSERT(!events[i].player || events[i].player->seat() == steppedEvents[i].player->seat());
+        }
+        for (unsigned int i = 0; i < players[table].size(); ++i) {
+            CPPUNIT_ASSERT(players[table][i]->hand() == steppedPlayers[table][i]->hand());
+            delete players[table][i];
+            delete steppedPlayers[table][i];
+        }
+        delete engines[table];
+        delete steppedEngines[table];
+        delete recorders[table];
+        delete steppedRecorders[table];
+    }
+}
@@ -0,0 +1,259 @@
+#include <algorithm>
+
+#include "tableHostTest.h"
+#include "engine.h"
+#include "deck.h"
+#include "defines.h"
+
+using namespace decore;
+
+TableHostTest::Bot::Bot(uint64_t seed)
+    : mRandom(seed)
+{
+}
+
+const Card& TableHostTest::Bot::attack(const PlayerId* playerId, const CardSet& cardSet)
+{
+    (void) playerId;
+    return *pick(cardSet, false);
+}
+
+const Card* TableHostTest::Bot::pitch(const PlayerId* playerId, const CardSet& cardSet)
+{
+    (void) playerId;
+    return pick(cardSet, true);
+}
+
+const Card* TableHostTest::Bot::defend(const PlayerId* playerId, const Card& attackCard, const CardSet& cardSet)
+{
+    (void) playerId;
+    (void) attackCard;
+    return pick(cardSet, true);
+}
+
+const Card* TableHostTest::Bot::pick(const CardSet& cardSet, bool canSkip)
+{
+    if (cardSet.empty()) {
+        return NULL;
+    }
+    unsigned int index = mRandom(cardSet.size() + (canSkip ? 1 : 0));
+    if (index == cardSet.size()) {
+        return NULL;
+    }
+    CardSet::const_iterator it = cardSet.begin();
+    std::advance(it, index);
+    removeCard(&*it);
+    return &*it;
+}
+
+TableHostTest::Listener::Listener()
+{
+    pthread_mutex_init(&mLock, NULL);
+}
+
+TableHostTest::Listener::~Listener()
+{
+    pthread_mutex_destroy(&mLock);
+}
+
+void TableHostTest::Listener::decisionPending(unsigned int table, const Decision& decision)
+{
+    CPPUNIT_ASSERT(DECISION_NONE != decision.type);
+    pthread_mutex_lock(&mLock);
+    mPending.push_back(table);
+    pthread_mutex_unlock(&mLock);
+}
+
+void TableHostTest::Listener::tableEnded(unsigned int table, const PlayerId* loser)
+{
+    pthread_mutex_lock(&mLock);
+    mEnded.push_back(table);
+    mLosers.push_back(loser);
+    pthread_mutex_unlock(&mLock);
+}
+
+void TableHostTest::Listener::takePending(std::vector<unsigned int>& tables)
+{
+    pthread_mutex_lock(&mLock);
+    tables.swap(mPending);
+    mPending.clear();
+    pthread_mutex_unlock(&mLock);
+}
+
+TableHostTest::RemovingListener::RemovingListener()
+    : mHost(NULL)
+    , mRemoved(0)
+{
+}
+
+void TableHostTest::RemovingListener::decisionPending(unsigned int table, const Decision& decision)
+{
+    CPPUNIT_ASSERT(mHost->removeTable(table));
+    // the table is deleted after the callback
+    CPPUNIT_ASSERT(decision.player->seat() < 3);
+    mRemoved.getAndAdd(1);
+}
+
+void TableHostTest::RemovingListener::tableEnded(unsigned int table, const PlayerId* loser)
+{
+    CPPUNIT_ASSERT(mHost->removeTable(table));
+    CPPUNIT_ASSERT(!loser || loser->seat() < 3);
+    mRemoved.getAndAdd(1);
+}
+
+void TableHostTest::generate(Deck& deck, uint64_t seed, uint64_t gameIndex)
+{
+    Rank ranks[] = {
+        RANK_6,
+        RANK_7,
+        RANK_8,
+        RANK_9,
+        RANK_10,
+        RANK_JACK,
+        RANK_QUEEN,
+        RANK_KING,
+        RANK_ACE,
+    };
+
+    Suit suits[] = {
+        SUIT_SPADES,
+        SUIT_HEARTS,
+        SUIT_DIAMONDS,
+        SUIT_CLUBS,
+    };
+
+    deck.generate(ranks, ARRAY_SIZE(ranks), suits, ARRAY_SIZE(suits), seed, gameIndex);
+}
+
+void TableHostTest::test(Rules::Seats externalSeats)
+{
+    const unsigned int TABLES = 40;
+    const unsigned int PLAYERS = 3;
+    Listener listener;
+    std::vector<Bot*> players;
+    std::vector<Bot*> hostPlayers;
+    // loser seat of the blocking engine games, PlayerId::NO_SEAT for draw
+    std::vector<unsigned int> losers;
+    {
+        TableHost host(listener, 4);
+        host.setQuantum(2);
+        for (unsigned int table = 0; table < TABLES; ++table) {
+            Deck deck;
+            generate(deck, 19, table);
+
+            // same game with the blocking engine
+            Engine engine;
+            std::vector<Player*> tablePlayers;
+            for (unsigned int i = 0; i < PLAYERS; ++i) {
+                players.push_back(new Bot(table * PLAYERS + i));
+                engine.add(*players.back());
+                hostPlayers.push_back(new Bot(table * PLAYERS + i));
+                tablePlayers.push_back(hostPlayers.back());
+            }
+            CPPUNIT_ASSERT(engine.setDeck(deck));
+            while (engine.playRound());
+            const PlayerId* loser = engine.getLoser();
+            losers.push_back(loser ? loser->seat() : PlayerId::NO_SEAT);
+
+            CPPUNIT_ASSERT(table == host.addTable(tablePlayers, externalSeats, deck));
+        }
+
+        // the test thread is the external players
+        unsigned int decisions = 0;
+        for (;;) {
+            host.wait();
+            std::vector<unsigned int> pending;
+            listener.takePending(pending);
+            if (pending.empty()) {
+                break;
+            }
+            for (std::vector<unsigned int>::iterator it = pending.begin(); it != pending.end(); ++it) {
+                Decision decision;
+                CPPUNIT_ASSERT(host.pending(*it, decision));
+                unsigned int seat = decision.player->seat();
+                CPPUNIT_ASSERT(externalSeats & (static_cast<Rules::Seats>(1) << seat));
+                const Card* answer = decision.ask(*hostPlayers[*it * PLAYERS + seat]);
+                CPPUNIT_ASSERT(host.submit(*it, answer));
+                decisions++;
+            }
+        }
+        CPPUNIT_ASSERT(!externalSeats || decisions > TABLES);
+
+        // memory accounting
+        size_t memory = 0;
+        for (unsigned int table = 0; table < TABLES; ++table) {
+            CPPUNIT_ASSERT(host.ended(table));
+            Decision decision;
+            CPPUNIT_ASSERT(!host.pending(table, decision));
+            CPPUNIT_ASSERT(!host.submit(table, NULL));
+            CPPUNIT_ASSERT(host.tableMemory(table) > sizeof(Engine));
+            memory += host.tableMemory(table);
+        }
+        CPPUNIT_ASSERT(memory == host.memory());
+        CPPUNIT_ASSERT(host.removeTable(0));
+        CPPUNIT_ASSERT(!host.removeTable(0));
+        CPPUNIT_ASSERT(memory - host.memory() > sizeof(Engine));
+
+        // same results, the losers are valid till the tables are removed
+        CPPUNIT_ASSERT(listener.mEnded.size() == TABLES);
+        for (unsigned int i = 0; i < TABLES; ++i) {
+            unsigned int table = listener.mEnded[i];
+            if (!table) {
+                continue;
+            }
+            const PlayerId* loser = listener.mLosers[i];
+            CPPUNIT_ASSERT((loser ? loser->seat() : PlayerId::NO_SEAT) == losers[table]);
+        }
+    }
+
+    for (unsigned int i = 0; i < players.size(); ++i) {
+        CPPUNIT_ASSERT(players[i]->cards(players[i]->cardSets() - 1) == hostPlayers[i]->cards(hostPlayers[i]->cardSets() - 1));
+        delete players[i];
+        delete hostPlayers[i];
+    }
+}
+
+void TableHostTest::testBots()
+{
+    test(0);
+}
+
+void TableHostTest::testExternal()
+{
+    test(1 << 0 | 1 << 2);
+}
+
+void TableHostTest::testRemoveFromListener()
+{
+    const unsigned int TABLES = 40;
+    const unsigned int PLAYERS = 3;
+    RemovingListener listener;
+    std::vector<Bot*> players;
+    {
+        TableHost host(listener, 4);
+        CPPUNIT_ASSERT(4 == host.threads());
+        listener.mHost = &host;
+        for (unsigned int table = 0; table < TABLES; ++table) {
+            Deck deck;
+            generate(deck, 23, table);
+            std::vector<Player*> tablePlayers;
+            for (unsigned int i = 0; i < PLAYERS; ++i) {
+                players.push_back(new Bot(table * PLAYERS + i));
+                tablePlayers.push_back(players.back());
+            }
+            // half of the tables park on the external seat
+            host.addTable(tablePlayers, table % 2 ? 1 << 1 : 0, deck);
+        }
+        host.wait();
+        CPPUNIT_ASSERT(TABLES == listener.mRemoved.get());
+        CPPUNIT_ASSERT(!host.memory());
+        for (unsigned int table = 0; table < TABLES; ++table) {
+            CPPUNIT_ASSERT(!host.ended(table));
+            CPPUNIT_ASSERT(!host.removeTable(table));
+        }
+    }
+
+    for (unsigned int i = 0; i < players.size(); ++i) {
+        delete players[i];
+    }
+}
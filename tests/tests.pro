@@ -29,7 +29,13 @@ SOURCES += \
     gameTest.cpp \
     saveRestoreTest.cpp \
     basePlayer.cpp \
-    observer.cpp
+    observer.cpp \
+    allocationTest.cpp \
+    simulationTest.cpp \
+    batchRunnerTest.cpp \
+    eventRecorder.cpp \
+    asyncObserverTest.cpp \
+    tableHostTest.cpp
 
 HEADERS += \
     include/cardTest.h \
@@ -39,7 +45,13 @@ HEADERS += \
     include/defines.h \
     include/saveRestoreTest.h \
     include/basePlayer.h \
-    include/observer.h
+    include/observer.h \
+    include/allocationTest.h \
+    include/simulationTest.h \
+    include/batchRunnerTest.h \
+    include/eventRecorder.h \
+    include/asyncObserverTest.h \
+    include/tableHostTest.h
 
 INCLUDEPATH += $$PWD/../decore/include
 DEPENDPATH += $$PWD/../decore/include